@@ -21,10 +21,12 @@
  *****************************************************************************/
 
 #include <argtable2.h>
+#include <fstream>
 #include <regex.h>
 #include <string.h> 
 
 #include "data_structure/graph_access.h"
+#include "data_structure/parallel/thread_pool.h"
 #include "graph_io.h"
 #include "macros_assertions.h"
 #include "parse_parameters.h"
@@ -50,6 +52,8 @@ int main(int argn, char **argv) {
                 return 0;
         }
 
+        parallel::g_thread_pool.Resize(partition_config.num_threads - 1);
+
         graph_access G;     
         graph_io::readGraphWeighted(G, graph_filename);
 
@@ -66,12 +70,18 @@ int main(int argn, char **argv) {
 
         std::cout <<  "graph has " <<  G.number_of_nodes() <<  " nodes and " <<  G.number_of_edges() <<  " edges"  << std::endl;
         quality_metrics qm;
+        quality_report report = qm.report(G);
+
+        std::cout << "cut \t\t"         << report.edge_cut                 << std::endl;
+        std::cout << "no boundary vertices \t\t" << report.boundary_nodes           << std::endl;
+        std::cout << "balance \t"       << report.balance                  << std::endl;
+        std::cout << "balance based on edges \t"       << report.balance_edges                  << std::endl;
+        std::cout << "max comm vol \t"  << report.max_comm_volume << std::endl;
+        std::cout << "min comm vol \t"  << report.min_comm_volume << std::endl;
+        std::cout << "total comm vol \t"  << report.total_comm_volume << std::endl;
 
-        std::cout << "cut \t\t"         << qm.edge_cut(G)                 << std::endl;
-        std::cout << "no boundary vertices \t\t" << qm.boundary_nodes(G)           << std::endl;
-        std::cout << "balance \t"       << qm.balance(G)                  << std::endl;
-        std::cout << "balance based on edges \t"       << qm.balance_edges(G)                  << std::endl;
-        std::cout << "max comm vol \t"  << qm.max_communication_volume(G) << std::endl;
-        std::cout << "min comm vol \t"  << qm.min_communication_volume(G) << std::endl;
-        std::cout << "total comm vol \t"  << qm.total_communication_volume(G) << std::endl;
+        if (partition_config.metrics_json_filename != "") {
+                std::ofstream json(partition_config.metrics_json_filename);
+                report.write_json(json);
+        }
 }
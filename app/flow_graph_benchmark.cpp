@@ -0,0 +1,289 @@
+/******************************************************************************
+ * flow_graph_benchmark.cpp
+ *
+ * Source of KaHIP -- Karlsruhe High Quality Partitioning.
+ *
+ ******************************************************************************
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "algorithms/push_relabel.h"
+#include "data_structure/flow_graph.h"
+#include "data_structure/graph_access.h"
+#include "graph_io.h"
+#include "tools/timer.h"
+
+// this program compares the csr flow_graph with the former vector of vectors layout of the residual graph on
+// a flow problem like the ones of the flow based refinement. the graph is bisected along a bfs order and the
+// flow problem consists of the nodes within DEPTH hops of the cut. the source is connected to the outer
+// boundary of the region in the first block, the outer boundary in the second block to the sink.
+// the program reports the construction time, the time of a bfs in the residual graph as done by the global
+// relabeling, and the time of push-relabel on the csr layout.
+
+struct flow_edge {
+        NodeID source;
+        NodeID target;
+        FlowType capacity;
+};
+
+struct flow_problem {
+        NodeID number_of_nodes;
+        NodeID source;
+        NodeID sink;
+        std::vector<flow_edge> edges;
+};
+
+// the former residual graph, one std::vector of edges per node
+class adjacency_list_flow_graph {
+public:
+        struct edge {
+                NodeID source;
+                NodeID target;
+                FlowType capacity;
+                FlowType flow;
+                EdgeID reverse_edge_index;
+        };
+
+        void start_construction(NodeID nodes, EdgeID edges = 0) {
+                m_adjacency_lists.resize(nodes);
+                uint32_t avg_deg = edges / nodes;
+                for (NodeID node = 0; node < nodes; ++node) {
+                        m_adjacency_lists[node].reserve(std::max(avg_deg, 100u));
+                }
+        }
+
+        void finish_construction() {}
+
+        void new_edge(NodeID source, NodeID target, FlowType capacity) {
+                m_adjacency_lists[source].push_back({source, target, capacity, 0, m_adjacency_lists[target].size()});
+                m_adjacency_lists[target].push_back({target, source, 0, 0, m_adjacency_lists[source].size() - 1});
+        }
+
+        NodeID number_of_nodes() { return m_adjacency_lists.size(); }
+        EdgeID get_first_edge(NodeID node) { return 0; }
+        EdgeID get_first_invalid_edge(NodeID node) { return m_adjacency_lists[node].size(); }
+        NodeID getEdgeTarget(NodeID source, EdgeID e) { return m_adjacency_lists[source][e].target; }
+        NodeID getEdgeCapacity(NodeID source, EdgeID e) { return m_adjacency_lists[source][e].capacity; }
+        FlowType getEdgeFlow(NodeID source, EdgeID e) { return m_adjacency_lists[source][e].flow; }
+        EdgeID getReverseEdge(NodeID source, EdgeID e) { return m_adjacency_lists[source][e].reverse_edge_index; }
+
+private:
+        std::vector<std::vector<edge>> m_adjacency_lists;
+};
+
+std::vector<NodeID> bfs_order(graph_access & G) {
+        std::vector<NodeID> order;
+        std::vector<bool> touched(G.number_of_nodes(), false);
+        order.reserve(G.number_of_nodes());
+        forall_nodes(G, root) {
+                if (touched[root]) continue;
+                touched[root] = true;
+                order.push_back(root);
+                for (size_t i = order.size() - 1; i < order.size(); ++i) {
+                        NodeID node = order[i];
+                        forall_out_edges(G, e, node) {
+                                NodeID target = G.getEdgeTarget(e);
+                                if (!touched[target]) {
+                                        touched[target] = true;
+                                        order.push_back(target);
+                                }
+                        } endfor
+                }
+        } endfor
+        return order;
+}
+
+flow_problem build_flow_problem(graph_access & G, NodeID depth) {
+        std::vector<NodeID> order = bfs_order(G);
+        std::vector<bool> is_lhs(G.number_of_nodes(), false);
+        for (NodeID i = 0; i < order.size() / 2; ++i) {
+                is_lhs[order[i]] = true;
+        }
+
+        // the nodes within depth hops of the cut
+        std::vector<NodeID> distance(G.number_of_nodes(), std::numeric_limits<NodeID>::max());
+        std::vector<NodeID> region;
+        forall_nodes(G, node) {
+                forall_out_edges(G, e, node) {
+                        if (is_lhs[node] != is_lhs[G.getEdgeTarget(e)]) {
+                                distance[node] = 0;
+                                region.push_back(node);
+                                break;
+                        }
+                } endfor
+        } endfor
+        for (size_t i = 0; i < region.size(); ++i) {
+                NodeID node = region[i];
+                if (distance[node] == depth) continue;
+                forall_out_edges(G, e, node) {
+                        NodeID target = G.getEdgeTarget(e);
+                        if (distance[target] == std::numeric_limits<NodeID>::max() && is_lhs[target] == is_lhs[node]) {
+                                distance[target] = distance[node] + 1;
+                                region.push_back(target);
+                        }
+                } endfor
+        }
+
+        std::vector<NodeID> new_id(G.number_of_nodes(), std::numeric_limits<NodeID>::max());
+        for (NodeID i = 0; i < region.size(); ++i) {
+                new_id[region[i]] = i;
+        }
+
+        flow_problem problem;
+        problem.number_of_nodes = region.size() + 2;
+        problem.source          = region.size();
+        problem.sink            = region.size() + 1;
+        for (NodeID node : region) {
+                bool is_outer_boundary = false;
+                forall_out_edges(G, e, node) {
+                        NodeID target = G.getEdgeTarget(e);
+                        if (new_id[target] == std::numeric_limits<NodeID>::max()) {
+                                is_outer_boundary = true;
+                        } else {
+                                problem.edges.push_back({new_id[node], new_id[target], G.getEdgeWeight(e)});
+                        }
+                } endfor
+
+                if (is_outer_boundary) {
+                        if (is_lhs[node]) {
+                                problem.edges.push_back({problem.source, new_id[node], std::numeric_limits<FlowType>::max()});
+                        } else {
+                                problem.edges.push_back({new_id[node], problem.sink, std::numeric_limits<FlowType>::max()});
+                        }
+                }
+        }
+
+        return problem;
+}
+
+template <typename flow_graph_type>
+void construct(flow_problem & problem, flow_graph_type & fG) {
+        fG.start_construction(problem.number_of_nodes, problem.edges.size());
+        for (flow_edge & e : problem.edges) {
+                fG.new_edge(e.source, e.target, e.capacity);
+        }
+        fG.finish_construction();
+}
+
+// backward bfs from the sink in the residual graph, returns the number of reached nodes
+template <typename flow_graph_type>
+NodeID residual_bfs(flow_graph_type & fG, NodeID sink) {
+        std::vector<bool> touched(fG.number_of_nodes(), false);
+        std::queue<NodeID> Q;
+        Q.push(sink);
+        touched[sink] = true;
+
+        NodeID reached = 0;
+        while (!Q.empty()) {
+                NodeID node = Q.front();
+                Q.pop();
+                reached++;
+
+                forall_out_edges(fG, e, node) {
+                        NodeID target = fG.getEdgeTarget(node, e);
+                        EdgeID rev_e  = fG.getReverseEdge(node, e);
+                        if (!touched[target] && fG.getEdgeCapacity(target, rev_e) - fG.getEdgeFlow(target, rev_e) > 0) {
+                                touched[target] = true;
+                                Q.push(target);
+                        }
+                } endfor
+        }
+        return reached;
+}
+
+template <typename flow_graph_type>
+void run_layout(const std::string & name, flow_problem & problem, int repetitions) {
+        double construction_time = 0;
+        double bfs_time          = 0;
+        NodeID reached           = 0;
+        for (int i = 0; i < repetitions; ++i) {
+                timer t;
+                flow_graph_type fG;
+                construct(problem, fG);
+                construction_time += t.elapsed();
+
+                t.restart();
+                reached = residual_bfs(fG, problem.sink);
+                bfs_time += t.elapsed();
+        }
+
+        std::cout << std::left << std::setw(20) << name
+                  << " construction " << std::setw(12) << construction_time / repetitions
+                  << " bfs " << std::setw(12) << bfs_time / repetitions
+                  << " (" << reached << " nodes reached)" << std::endl;
+}
+
+int main(int argn, char **argv) {
+        if (argn < 2) {
+                std::cout << "Usage: flow_graph_benchmark GRAPH_FILE... [--depth=DEPTH] [--repetitions=R]" << std::endl;
+                std::cout << "Compares the residual graph layouts on the flow problem of the nodes within DEPTH "
+                          << "hops (default 10) of a bfs bisection, times are averages over R runs (default 5)." << std::endl;
+                exit(0);
+        }
+
+        NodeID depth    = 10;
+        int repetitions = 5;
+        std::vector<std::string> filenames;
+        for (int i = 1; i < argn; ++i) {
+                std::string arg(argv[i]);
+                if (arg.compare(0, 8, "--depth=") == 0) {
+                        depth = std::atoi(arg.c_str() + 8);
+                } else if (arg.compare(0, 14, "--repetitions=") == 0) {
+                        repetitions = std::max(1, std::atoi(arg.c_str() + 14));
+                } else {
+                        filenames.push_back(arg);
+                }
+        }
+
+        for (const std::string & filename : filenames) {
+                graph_access G;
+                if (graph_io::readGraphWeighted(G, filename) != 0) {
+                        std::cerr << "Could not read " << filename << std::endl;
+                        return 1;
+                }
+
+                flow_problem problem = build_flow_problem(G, depth);
+                std::cout << filename << ": flow problem with " << problem.number_of_nodes << " nodes and "
+                          << problem.edges.size() << " edges" << std::endl;
+
+                run_layout<adjacency_list_flow_graph>("vector_of_vectors", problem, repetitions);
+                run_layout<flow_graph>("csr", problem, repetitions);
+
+                double solve_time = 0;
+                FlowType value    = 0;
+                for (int i = 0; i < repetitions; ++i) {
+                        flow_graph fG;
+                        construct(problem, fG);
+                        std::vector<NodeID> source_set;
+
+                        timer t;
+                        value = push_relabel().solve_max_flow_min_cut(fG, problem.source, problem.sink, true, source_set);
+                        solve_time += t.elapsed();
+                }
+                std::cout << std::left << std::setw(20) << "csr push_relabel"
+                          << " max flow " << std::setw(12) << solve_time / repetitions
+                          << " (flow value " << value << ")" << std::endl;
+        }
+
+        return 0;
+}
@@ -0,0 +1,348 @@
+/******************************************************************************
+ * graph_generator.cpp
+ *
+ * Source of KaHIP -- Karlsruhe High Quality Partitioning.
+ *
+ ******************************************************************************
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "data_structure/graph_access.h"
+#include "graph_io.h"
+
+// this program generates the synthetic graph families of the benchmark suite in the metis graph
+// format, similar to the rgg_n_2_X_s0 and delaunay_nX graphs in examples:
+//   rgg       random geometric graph, 2^log_n points in the unit square, connected if their
+//             distance is below 0.55 * sqrt(ln n / n)
+//   delaunay  delaunay triangulation of 2^log_n random points in the unit square
+//   rmat      R-MAT graph with 2^log_n nodes and edge_factor * 2^log_n generated edges
+//             (a, b, c, d) = (0.57, 0.19, 0.19, 0.05), self loops and duplicates removed
+
+using Point = std::pair<double, double>;
+using EdgeList = std::vector<std::pair<NodeID, NodeID>>;
+
+std::vector<Point> random_points(NodeID n, std::mt19937_64& rng) {
+        std::uniform_real_distribution<double> coordinate(0.0, 1.0);
+        std::vector<Point> points(n);
+        for (Point& p : points) {
+                p.first = coordinate(rng);
+                p.second = coordinate(rng);
+        }
+        return points;
+}
+
+// sorts the points cell by cell in snake order, consecutive points are close to each other
+void sort_by_cells(std::vector<Point>& points) {
+        const uint64_t cells = std::max<uint64_t>(1, std::sqrt((double) points.size()));
+        auto cell_rank = [cells](const Point& p) {
+                uint64_t x = std::min<uint64_t>(p.first * cells, cells - 1);
+                uint64_t y = std::min<uint64_t>(p.second * cells, cells - 1);
+                return y * cells + (y % 2 == 0 ? x : cells - 1 - x);
+        };
+        std::sort(points.begin(), points.end(), [&](const Point& lhs, const Point& rhs) {
+                return cell_rank(lhs) < cell_rank(rhs);
+        });
+}
+
+EdgeList generate_rgg(NodeID n, std::mt19937_64& rng) {
+        std::vector<Point> points = random_points(n, rng);
+        sort_by_cells(points);
+
+        const double radius = 0.55 * std::sqrt(std::log((double) n) / n);
+        const uint64_t cells = std::max<uint64_t>(1, 1.0 / radius);
+        auto cell_of = [cells](double coordinate) {
+                return std::min<uint64_t>(coordinate * cells, cells - 1);
+        };
+
+        std::vector<std::vector<NodeID>> grid(cells * cells);
+        for (NodeID node = 0; node < n; ++node) {
+                grid[cell_of(points[node].second) * cells + cell_of(points[node].first)].push_back(node);
+        }
+
+        EdgeList edges;
+        for (NodeID node = 0; node < n; ++node) {
+                int64_t x = cell_of(points[node].first);
+                int64_t y = cell_of(points[node].second);
+                for (int64_t ny = std::max<int64_t>(y - 1, 0); ny <= std::min<int64_t>(y + 1, cells - 1); ++ny) {
+                        for (int64_t nx = std::max<int64_t>(x - 1, 0); nx <= std::min<int64_t>(x + 1, cells - 1); ++nx) {
+                                for (NodeID target : grid[ny * cells + nx]) {
+                                        double dx = points[node].first - points[target].first;
+                                        double dy = points[node].second - points[target].second;
+                                        if (node < target && dx * dx + dy * dy < radius * radius) {
+                                                edges.emplace_back(node, target);
+                                        }
+                                }
+                        }
+                }
+        }
+        return edges;
+}
+
+// incremental delaunay triangulation with lawson flips. nb[i] is the triangle across the edge
+// opposite to v[i], -1 on the outer face. all triangles are counterclockwise.
+class delaunay_triangulation {
+public:
+        explicit delaunay_triangulation(const std::vector<Point>& points)
+                :       m_points(points)
+        {
+                // the super triangle contains the unit square
+                const int64_t n = points.size();
+                m_points.emplace_back(-100.0, -100.0);
+                m_points.emplace_back(100.0, -100.0);
+                m_points.emplace_back(0.0, 100.0);
+                m_triangles.push_back({{n, n + 1, n + 2}, {-1, -1, -1}});
+
+                int64_t last = 0;
+                for (int64_t p = 0; p < n; ++p) {
+                        last = insert(p, locate(p, last));
+                }
+        }
+
+        // edges between the input points, the triangles at the super triangle are dropped
+        EdgeList edges() const {
+                const NodeID n = m_points.size() - 3;
+                EdgeList result;
+                for (const triangle& t : m_triangles) {
+                        for (int i = 0; i < 3; ++i) {
+                                NodeID u = t.v[i];
+                                NodeID v = t.v[(i + 1) % 3];
+                                if (u < n && v < n) {
+                                        result.emplace_back(std::min(u, v), std::max(u, v));
+                                }
+                        }
+                }
+                std::sort(result.begin(), result.end());
+                result.erase(std::unique(result.begin(), result.end()), result.end());
+                return result;
+        }
+
+private:
+        struct triangle {
+                int64_t v[3];
+                int64_t nb[3];
+        };
+
+        std::vector<Point> m_points;
+        std::vector<triangle> m_triangles;
+
+        // > 0 if c is left of a->b
+        double orientation(int64_t a, int64_t b, int64_t c) const {
+                const Point& pa = m_points[a];
+                const Point& pb = m_points[b];
+                const Point& pc = m_points[c];
+                return (pb.first - pa.first) * (pc.second - pa.second) - (pb.second - pa.second) * (pc.first - pa.first);
+        }
+
+        // > 0 if d is inside the circumcircle of the counterclockwise triangle a, b, c
+        double in_circle(int64_t a, int64_t b, int64_t c, int64_t d) const {
+                const Point& pd = m_points[d];
+                double adx = m_points[a].first - pd.first, ady = m_points[a].second - pd.second;
+                double bdx = m_points[b].first - pd.first, bdy = m_points[b].second - pd.second;
+                double cdx = m_points[c].first - pd.first, cdy = m_points[c].second - pd.second;
+                double ad = adx * adx + ady * ady;
+                double bd = bdx * bdx + bdy * bdy;
+                double cd = cdx * cdx + cdy * cdy;
+                return adx * (bdy * cd - bd * cdy) - ady * (bdx * cd - bd * cdx) + ad * (bdx * cdy - bdy * cdx);
+        }
+
+        // walks from triangle start towards the triangle containing point p
+        int64_t locate(int64_t p, int64_t start) const {
+                int64_t t = start;
+                bool moved = true;
+                while (moved) {
+                        moved = false;
+                        for (int i = 0; i < 3; ++i) {
+                                const triangle& tri = m_triangles[t];
+                                if (orientation(tri.v[(i + 1) % 3], tri.v[(i + 2) % 3], p) < 0 && tri.nb[i] != -1) {
+                                        t = tri.nb[i];
+                                        moved = true;
+                                        break;
+                                }
+                        }
+                }
+                return t;
+        }
+
+        void replace_neighbor(int64_t t, int64_t old_nb, int64_t new_nb) {
+                if (t == -1) {
+                        return;
+                }
+                for (int i = 0; i < 3; ++i) {
+                        if (m_triangles[t].nb[i] == old_nb) {
+                                m_triangles[t].nb[i] = new_nb;
+                        }
+                }
+        }
+
+        // splits triangle t at p and restores the delaunay property, returns a triangle at p
+        int64_t insert(int64_t p, int64_t t) {
+                const triangle old = m_triangles[t];
+                const int64_t a = old.v[0], b = old.v[1], c = old.v[2];
+                const int64_t t1 = m_triangles.size();
+                const int64_t t2 = t1 + 1;
+
+                m_triangles[t] = {{p, b, c}, {old.nb[0], t1, t2}};
+                m_triangles.push_back({{p, c, a}, {old.nb[1], t2, t}});
+                m_triangles.push_back({{p, a, b}, {old.nb[2], t, t1}});
+                replace_neighbor(old.nb[1], t, t1);
+                replace_neighbor(old.nb[2], t, t2);
+
+                // every triangle on the stack has p as v[0]
+                std::vector<int64_t> stack = {t, t1, t2};
+                while (!stack.empty()) {
+                        int64_t cur = stack.back();
+                        stack.pop_back();
+                        int64_t other = m_triangles[cur].nb[0];
+                        if (other == -1) {
+                                continue;
+                        }
+
+                        int j = 0;
+                        while (m_triangles[other].nb[j] != cur) {
+                                ++j;
+                        }
+                        const int64_t q = m_triangles[other].v[j];
+                        const int64_t pa = m_triangles[cur].v[1];
+                        const int64_t pb = m_triangles[cur].v[2];
+                        if (in_circle(p, pa, pb, q) <= 0) {
+                                continue;
+                        }
+
+                        // flip the edge pa-pb to p-q
+                        const int64_t cur_a = m_triangles[cur].nb[1];
+                        const int64_t cur_b = m_triangles[cur].nb[2];
+                        const int64_t other_b = m_triangles[other].nb[(j + 1) % 3];
+                        const int64_t other_a = m_triangles[other].nb[(j + 2) % 3];
+
+                        m_triangles[cur] = {{p, pa, q}, {other_b, other, cur_b}};
+                        m_triangles[other] = {{p, q, pb}, {other_a, cur_a, cur}};
+                        replace_neighbor(other_b, other, cur);
+                        replace_neighbor(cur_a, cur, other);
+
+                        stack.push_back(cur);
+                        stack.push_back(other);
+                }
+                return t;
+        }
+};
+
+EdgeList generate_delaunay(NodeID n, std::mt19937_64& rng) {
+        std::vector<Point> points = random_points(n, rng);
+        sort_by_cells(points);
+        return delaunay_triangulation(points).edges();
+}
+
+EdgeList generate_rmat(uint32_t log_n, uint32_t edge_factor, std::mt19937_64& rng) {
+        const NodeID n = NodeID(1) << log_n;
+        const double a = 0.57, b = 0.19, c = 0.19;
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+        // node ids are permuted, otherwise the high degree nodes are the first ones
+        std::vector<NodeID> permutation(n);
+        for (NodeID node = 0; node < n; ++node) {
+                permutation[node] = node;
+        }
+        std::shuffle(permutation.begin(), permutation.end(), rng);
+
+        EdgeList edges;
+        edges.reserve((uint64_t) edge_factor * n);
+        for (uint64_t i = 0; i < (uint64_t) edge_factor * n; ++i) {
+                NodeID source = 0;
+                NodeID target = 0;
+                for (uint32_t bit = 0; bit < log_n; ++bit) {
+                        double r = coin(rng);
+                        source = (source << 1) | (r >= a + b);
+                        target = (target << 1) | ((r >= a && r < a + b) || r >= a + b + c);
+                }
+                source = permutation[source];
+                target = permutation[target];
+                if (source != target) {
+                        edges.emplace_back(std::min(source, target), std::max(source, target));
+                }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        return edges;
+}
+
+// builds G from undirected edges with source < target
+void build_graph(NodeID n, const EdgeList& edges, graph_access& G) {
+        std::vector<std::vector<NodeID>> adjacency(n);
+        for (const auto& edge : edges) {
+                adjacency[edge.first].push_back(edge.second);
+                adjacency[edge.second].push_back(edge.first);
+        }
+
+        G.start_construction(n, 2 * edges.size());
+        for (NodeID node = 0; node < n; ++node) {
+                NodeID u = G.new_node();
+                G.setNodeWeight(u, 1);
+                std::sort(adjacency[node].begin(), adjacency[node].end());
+                for (NodeID target : adjacency[node]) {
+                        EdgeID e = G.new_edge(u, target);
+                        G.setEdgeWeight(e, 1);
+                }
+        }
+        G.finish_construction();
+}
+
+int main(int argn, char **argv) {
+        if (argn < 4 || argn > 6) {
+                std::cout << "Usage: graph_generator rgg|delaunay|rmat LOG_N OUTPUT_FILE [SEED] [EDGE_FACTOR]" << std::endl;
+                std::cout << "Generates a graph with 2^LOG_N nodes in the metis graph format. "
+                          << "EDGE_FACTOR is the number of generated edges per node of rmat (default 8)." << std::endl;
+                exit(0);
+        }
+
+        std::string type(argv[1]);
+        uint32_t log_n = std::atoi(argv[2]);
+        std::string filename(argv[3]);
+        uint64_t seed = argn > 4 ? std::atoll(argv[4]) : 0;
+        uint32_t edge_factor = argn > 5 ? std::atoi(argv[5]) : 8;
+
+        if (log_n < 1 || log_n > 8 * sizeof(NodeID) - 2) {
+                std::cerr << "LOG_N has to be between 1 and " << 8 * sizeof(NodeID) - 2 << std::endl;
+                return 1;
+        }
+
+        const NodeID n = NodeID(1) << log_n;
+        std::mt19937_64 rng(seed);
+        EdgeList edges;
+        if (type == "rgg") {
+                edges = generate_rgg(n, rng);
+        } else if (type == "delaunay") {
+                edges = generate_delaunay(n, rng);
+        } else if (type == "rmat") {
+                edges = generate_rmat(log_n, edge_factor, rng);
+        } else {
+                std::cerr << "Unknown graph type " << type << ", expected rgg, delaunay or rmat" << std::endl;
+                return 1;
+        }
+
+        graph_access G;
+        build_graph(n, edges, G);
+        std::cout << type << " graph with " << G.number_of_nodes() << " nodes and "
+                  << G.number_of_edges() / 2 << " edges" << std::endl;
+        graph_io::writeGraph(G, filename);
+        return 0;
+}
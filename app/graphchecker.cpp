@@ -29,6 +29,9 @@
 #include <vector>
 #include <unordered_set>
 
+#include "data_structure/graph_access.h"
+#include "graph_io.h"
+
 using namespace std;
 
 // this program implements the functions to check the metis graph 
@@ -36,8 +39,9 @@ using namespace std;
 int main(int argn, char **argv)
 {
 
-        if( argn != 2 ) {
-                std::cout <<  "Usage: graphchecker FILE"  << std::endl;
+        if( argn != 2 && argn != 3 ) {
+                std::cout <<  "Usage: graphchecker FILE [BINARY_OUTPUT_FILE]"  << std::endl;
+                std::cout <<  "If BINARY_OUTPUT_FILE is given, a correct graph is converted to the binary graph format."  << std::endl;
                 exit(0);
         }
 
@@ -278,6 +282,19 @@ int main(int argn, char **argv)
         std::cout <<  "The graph format seems correct."  << std::endl;
         std::cout <<  "*******************************************************************************"  << std::endl;
 
+        if( argn == 3 ) {
+                std::string binary_filename(argv[2]);
+                std::cout <<  "Converting the graph to the binary format ... "  << std::endl;
+
+                graph_access G;
+                graph_io::readGraphWeighted(G, filename);
+                if( graph_io::writeGraphBinary(G, binary_filename) ) {
+                        return 1;
+                }
+                std::cout <<  "Binary graph written to " << binary_filename << "."  << std::endl;
+                std::cout <<  "*******************************************************************************"  << std::endl;
+        }
+
 
         return 0;
 }
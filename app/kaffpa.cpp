@@ -31,8 +31,10 @@
 #include "balance_configuration.h"
 #include "data_structure/graph_access.h"
 #include "data_structure/parallel/graph_utils.h"
+#include "data_structure/parallel/numa_graph_layout.h"
 #include "data_structure/parallel/thread_pool.h"
 #include "graph_io.h"
+#include "instrumentation.h"
 #include "macros_assertions.h"
 #include "parse_parameters.h"
 #include "partition/graph_partitioner.h"
@@ -118,9 +120,13 @@ int main(int argn, char **argv) {
         graph_access G;     
         ALWAYS_ASSERT(partition_config.main_core == 0);
 
+        // pin main thread to core
+        parallel::PinToCore(partition_config.main_core);
+        parallel::g_thread_pool.Resize(partition_config.num_threads - 1);
+
         timer t;
         if (!partition_config.shuffle_graph && !partition_config.sort_edges) {
-                graph_io::readGraphWeighted(G, graph_filename);
+                graph_io::readGraphWeightedParallel(G, graph_filename);
                 //double avg;
                 //double med;
                 //std::tie(avg, med) = average_chain_length(G);
@@ -130,16 +136,20 @@ int main(int argn, char **argv) {
                 ALWAYS_ASSERT(!partition_config.shuffle_graph || !partition_config.sort_edges);
                 if (partition_config.shuffle_graph) {
                         graph_access tmp_G;
-                        graph_io::readGraphWeighted(tmp_G, graph_filename);
+                        graph_io::readGraphWeightedParallel(tmp_G, graph_filename);
                         shuffle_graph(tmp_G, G);
                 }
                 if (partition_config.sort_edges) {
                         graph_access tmp_G;
-                        graph_io::readGraphWeighted(tmp_G, graph_filename);
+                        graph_io::readGraphWeightedParallel(tmp_G, graph_filename);
                         sort_edges(tmp_G, G);
                 }
         }
         std::cout << "io time: " << t.elapsed()  << std::endl;
+        if (partition_config.numa_graph_layout) {
+                parallel::numa_graph_layout(G, partition_config.num_threads,
+                                            partition_config.threads_per_socket).place(G);
+        }
         G.set_partition_count(partition_config.k);
  
         balance_configuration bc;
@@ -172,10 +182,6 @@ int main(int argn, char **argv) {
         srand(partition_config.seed);
         random_functions::setSeed(partition_config.seed);
 
-        // pin main thread to core
-        parallel::PinToCore(partition_config.main_core);
-        parallel::g_thread_pool.Resize(partition_config.num_threads - 1);
-
         std::cout <<  "graph has " <<  G.number_of_nodes() <<  " nodes and " <<  G.number_of_edges() <<  " edges"  << std::endl;
         if (partition_config.label_propagation_refinement) {
                 std::cout << "Algorithm\t" << partition_config.configuration << std::endl;
@@ -274,16 +280,34 @@ int main(int argn, char **argv) {
         std::cout <<  "time spent for partitioning " << t.elapsed()  << std::endl;
        
         // output some information about the partition that we have computed
-        Gain cut = qm.edge_cut(G);
+        quality_report report = qm.report(G);
+        Gain cut = report.edge_cut;
         std::cout << "cut \t\t"         << cut                            << std::endl;
         if (partition_config.input_partition != "") {
                 std::cout << "input partition cut\t" << input_partition_cut << std::endl;
                 std::cout << "improvement\t" << input_partition_cut - cut << std::endl;
         }
-        std::cout << "finalobjective  " << qm.edge_cut(G)                 << std::endl;
-        std::cout << "bnd \t\t"         << qm.boundary_nodes(G)           << std::endl;
-        std::cout << "balance \t"       << qm.balance(G)                  << std::endl;
-        std::cout << "max_comm_vol \t"  << qm.max_communication_volume(G) << std::endl;
+        std::cout << "finalobjective  " << report.edge_cut                << std::endl;
+        std::cout << "bnd \t\t"         << report.boundary_nodes          << std::endl;
+        std::cout << "balance \t"       << report.balance                 << std::endl;
+        std::cout << "max_comm_vol \t"  << report.max_comm_volume         << std::endl;
+
+        if (partition_config.metrics_json_filename != "") {
+                std::ofstream json(partition_config.metrics_json_filename);
+                report.write_json(json);
+        }
+
+        const std::string& instrumentation_file = partition_config.instrumentation_filename;
+        if (instrumentation_file != "") {
+                std::ofstream out(instrumentation_file);
+                const std::string csv = ".csv";
+                if (instrumentation_file.size() >= csv.size()
+                    && instrumentation_file.compare(instrumentation_file.size() - csv.size(), csv.size(), csv) == 0) {
+                        instrumentation::write_csv(out);
+                } else {
+                        instrumentation::write_json(out);
+                }
+        }
 
         if (!partition_config.label_propagation_refinement) {
                 std::cout << "Two way refinement:" << std::endl;
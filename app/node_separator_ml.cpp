@@ -30,6 +30,7 @@
 
 #include "balance_configuration.h"
 #include "data_structure/graph_access.h"
+#include "data_structure/parallel/thread_pool.h"
 #include "graph_io.h"
 #include "macros_assertions.h"
 #include "parse_parameters.h"
@@ -70,6 +71,7 @@ int main(int argn, char **argv) {
 
         partition_config.LogDump(stdout);
         graph_access G;     
+        parallel::g_thread_pool.Resize(partition_config.num_threads - 1);
 
         timer t;
         graph_io::readGraphWeighted(G, graph_filename);
@@ -25,6 +25,7 @@
 #define PARSE_PARAMETERS_GPJMGSM8
 
 #include <omp.h>
+#include "algorithms/max_flow_solver.h"
 #include "configuration.h"
 
 int parse_parameters(int argn, char **argv, 
@@ -188,12 +189,29 @@ int parse_parameters(int argn, char **argv,
         struct arg_lit *sort_edges                           = arg_lit0(NULL, "sort_edges", "(Default: disabled)");
         struct arg_int *stop_mls_threshold                   = arg_int0(NULL, "stop_mls_threshold", NULL, "Sets percent threshold to stop iteration of MLS");
         struct arg_lit *common_neighborhood_clustering       = arg_lit0(NULL, "common_neighborhood_clustering", "(Default: disabled)");
+        struct arg_int *common_neighborhood_min_hashes       = arg_int0(NULL, "common_neighborhood_min_hashes", NULL, "Number of min-hash functions for common neighborhood clustering, nodes with one equal min-hash are grouped. 0 only groups nodes with identical neighborhoods. (Default: 0)");
+        struct arg_lit *two_hop_clustering                   = arg_lit0(NULL, "two_hop_clustering", "Cluster nodes that label propagation left alone and that share their heaviest neighbor (leaves, twins and relatives of hubs). (Default: disabled)");
+        struct arg_dbl *two_hop_clustering_threshold         = arg_dbl0(NULL, "two_hop_clustering_threshold", NULL, "Run two hop clustering on a level if label propagation keeps more than this fraction of the nodes. (Default: 0.5)");
+        struct arg_lit *parallel_gpa                         = arg_lit0(NULL, "parallel_gpa", "Grow the paths of the gpa matching in parallel on one node range per thread. (Default: disabled)");
+        struct arg_lit *parallel_pairwise_refinement         = arg_lit0(NULL, "parallel_pairwise_refinement", "Refine the block pairs of the quotient graph that share no block concurrently, one edge color at a time. (Default: disabled)");
+        struct arg_rex *flow_solver                          = arg_rex0(NULL, "flow_solver", "^(push_relabel|parallel_push_relabel|boykov_kolmogorov|automatic)$", "TYPE", REG_EXTENDED, "Max flow algorithm of the flow based refinements. One of {push_relabel, parallel_push_relabel, boykov_kolmogorov, automatic}. Default: push_relabel");
+        struct arg_int *parallel_flow_solver_threshold       = arg_int0(NULL, "parallel_flow_solver_threshold", NULL, "Number of nodes of a flow problem from which on the automatic flow solver uses the parallel push-relabel. Default: 100000");
+        struct arg_lit *reuse_flow_on_shrink                 = arg_lit0(NULL, "reuse_flow_on_shrink", "Shrink a rejected region of the flow refinement to a prefix of its bfs order and augment the previous maximum flow instead of solving the smaller flow problem from scratch. Only shrinking regions reuse the flow, a region grows after an accepted cut and is solved from scratch. Uses boykov-kolmogorov. (Default: disabled)");
+        struct arg_lit *parallel_node_separator              = arg_lit0(NULL, "parallel_node_separator", "Coarsen with the parallel local max matching and refine the separator with localized searches on disjoint regions that run concurrently. (Default: disabled)");
+        struct arg_int *parallel_node_separator_region_size  = arg_int0(NULL, "parallel_node_separator_region_size", NULL, "Maximum number of nodes of a region of the parallel separator refinement. Default: 1000");
         struct arg_lit *use_numa_aware_graph                 = arg_lit0(NULL, "use_numa_aware_graph", "(Default: disabled)");
+        struct arg_lit *numa_graph_layout                    = arg_lit0(NULL, "numa_graph_layout", "Place contiguous node ranges of the graph on the socket of the thread owning them. (Default: disabled)");
         struct arg_int *threads_per_socket                   = arg_int0(NULL, "threads_per_socket", NULL, "Sets the maximum number of threads per socket (Default: 8)");
         struct arg_int *l2_cache_size                        = arg_int0(NULL, "l2_cache_size", NULL, "Size of l2 cache in bytes (Default: 256 * 1024 bytes)");
         struct arg_int *l3_cache_size                        = arg_int0(NULL, "l3_cache_size", NULL, "Size of l3 cache in bytes (Default: 20480 * 1024 bytes)");
         struct arg_lit *balls_and_bins_ht                    = arg_lit0(NULL, "balls_and_bins_ht", "Use bins and ball for parallel for on hash tables. (Default: false)");
         struct arg_lit *remove_edges_in_matching             = arg_lit0(NULL, "remove_edges_in_matching", "Remove edges in parallel local max or not. (Default: false)");
+        struct arg_lit *parallel_subgraph_extraction         = arg_lit0(NULL, "parallel_subgraph_extraction", "Extract the blocks in parallel during recursive bipartitioning. (Default: false)");
+        struct arg_lit *parallel_recursive_bisection         = arg_lit0(NULL, "parallel_recursive_bisection", "Partition the subproblems of recursive bipartitioning as parallel tasks. (Default: false)");
+        struct arg_lit *deterministic_parallel               = arg_lit0(NULL, "deterministic_parallel", "Make the parallel algorithms reproducible for a fixed seed and number of threads. Turns off common_neighborhood_clustering, two_hop_clustering, parallel_pairwise_refinement, parallel_recursive_bisection and parallel_node_separator and uses a sequential flow solver. (Default: disabled)");
+        struct arg_str *metrics_json                         = arg_str0(NULL, "metrics_json", NULL, "Write the quality metrics of the partition to this file as JSON.");
+        struct arg_str *instrumentation                      = arg_str0(NULL, "instrumentation", NULL, "Write the time and counters of every phase and level to this file, as CSV if it ends with .csv and as JSON otherwise.");
+        struct arg_str *spill_hierarchy                      = arg_str0(NULL, "spill_hierarchy", NULL, "Write the finer levels of the graph hierarchy to scratch files in this directory while coarsening. Only the current and the next level stay in memory. (Default: disabled)");
         struct arg_end *end                                  = arg_end(100);
 
         // Define argtable.
@@ -263,22 +281,44 @@ int parse_parameters(int argn, char **argv,
                 num_vert_stop_factor,
                 stop_mls_threshold,
                 common_neighborhood_clustering,
+                common_neighborhood_min_hashes,
+                two_hop_clustering,
+                two_hop_clustering_threshold,
+                parallel_gpa,
+                parallel_pairwise_refinement,
+                flow_solver,
+                parallel_flow_solver_threshold,
+                reuse_flow_on_shrink,
                 use_numa_aware_graph,
+                numa_graph_layout,
                 threads_per_socket,
                 l2_cache_size,
                 l3_cache_size,
                 matching_type,
                 balls_and_bins_ht,
                 remove_edges_in_matching,
+                parallel_subgraph_extraction,
+                parallel_recursive_bisection,
+                deterministic_parallel,
+                metrics_json,
+                instrumentation,
+                spill_hierarchy,
 #elif defined MODE_EVALUATOR
                 k,   
                 preconfiguration, 
                 input_partition,
+                num_threads,
+                metrics_json,
 #elif defined MODE_NODESEP
                 //k,
                 imbalance,  
                 preconfiguration, 
                 filename_output, 
+                flow_solver,
+                parallel_flow_solver_threshold,
+                num_threads,
+                parallel_node_separator,
+                parallel_node_separator_region_size,
                 //time_limit, 
                 //edge_rating,
                 //max_flow_improv_steps,
@@ -1211,10 +1251,65 @@ int parse_parameters(int argn, char **argv,
                 partition_config.common_neighborhood_clustering = true;
         }
 
+        if (common_neighborhood_min_hashes->count > 0) {
+                partition_config.common_neighborhood_min_hashes = common_neighborhood_min_hashes->ival[0];
+        }
+
+        if (two_hop_clustering->count > 0) {
+                partition_config.two_hop_clustering = true;
+        }
+
+        if (two_hop_clustering_threshold->count > 0) {
+                partition_config.two_hop_clustering_threshold = two_hop_clustering_threshold->dval[0];
+        }
+
+        if (parallel_gpa->count > 0) {
+                partition_config.parallel_gpa = true;
+        }
+
+        if (parallel_pairwise_refinement->count > 0) {
+                partition_config.parallel_pairwise_refinement = true;
+        }
+
+        if (flow_solver->count > 0) {
+                if (strcmp("push_relabel", flow_solver->sval[0]) == 0) {
+                        partition_config.flow_solver = FlowSolverType::PUSH_RELABEL;
+                } else if (strcmp("parallel_push_relabel", flow_solver->sval[0]) == 0) {
+                        partition_config.flow_solver = FlowSolverType::PARALLEL_PUSH_RELABEL;
+                } else if (strcmp("boykov_kolmogorov", flow_solver->sval[0]) == 0) {
+                        partition_config.flow_solver = FlowSolverType::BOYKOV_KOLMOGOROV;
+                } else if (strcmp("automatic", flow_solver->sval[0]) == 0) {
+                        partition_config.flow_solver = FlowSolverType::AUTOMATIC;
+                } else {
+                        fprintf(stderr, "Invalid flow solver variant: \"%s\"\n", flow_solver->sval[0]);
+                        exit(0);
+                }
+        }
+
+        if (parallel_flow_solver_threshold->count > 0) {
+                partition_config.parallel_flow_solver_threshold = parallel_flow_solver_threshold->ival[0];
+        }
+
+        if (reuse_flow_on_shrink->count > 0) {
+                partition_config.reuse_flow_on_shrink = true;
+        }
+
+        if (parallel_node_separator->count > 0) {
+                partition_config.parallel_node_separator = true;
+        }
+
+        if (parallel_node_separator_region_size->count > 0) {
+                partition_config.parallel_node_separator_region_size = parallel_node_separator_region_size->ival[0];
+        }
+
         if (use_numa_aware_graph->count > 0) {
                 partition_config.use_numa_aware_graph = true;
         }
 
+        if (numa_graph_layout->count > 0) {
+                partition_config.numa_graph_layout = true;
+        }
+
         if (threads_per_socket->count > 0) {
                 partition_config.threads_per_socket = threads_per_socket->ival[0];
         }
@@ -1235,6 +1330,40 @@ int parse_parameters(int argn, char **argv,
                 partition_config.remove_edges_in_matching = true;
         }
 
+        if (parallel_subgraph_extraction->count > 0) {
+                partition_config.parallel_subgraph_extraction = true;
+        }
+
+        if (parallel_recursive_bisection->count > 0) {
+                partition_config.parallel_recursive_bisection = true;
+        }
+
+        if (deterministic_parallel->count > 0) {
+                partition_config.deterministic_parallel = true;
+        }
+
+        if (metrics_json->count > 0) {
+                partition_config.metrics_json_filename = metrics_json->sval[0];
+        }
+
+        if (instrumentation->count > 0) {
+                partition_config.instrumentation_filename = instrumentation->sval[0];
+        }
+
+        if (spill_hierarchy->count > 0) {
+                partition_config.spill_hierarchy_directory = spill_hierarchy->sval[0];
+        }
+
+        // the results of these parallel stages depend on the thread schedule
+        if (partition_config.deterministic_parallel) {
+                partition_config.common_neighborhood_clustering = false;
+                partition_config.two_hop_clustering             = false;
+                partition_config.parallel_pairwise_refinement   = false;
+                partition_config.parallel_recursive_bisection   = false;
+                partition_config.parallel_node_separator        = false;
+                partition_config.flow_solver = max_flow_solver::sequential_flow_solver(partition_config.flow_solver);
+        }
+
         return 0;
 }
 
@@ -0,0 +1,244 @@
+#include <algorithm>
+
+#include "algorithms/boykov_kolmogorov.h"
+
+namespace {
+// values of m_parent_edge for the two terminals and for nodes that lost their parent
+const EdgeID TERMINAL = UNDEFINED_EDGE - 1;
+const EdgeID ORPHAN   = UNDEFINED_EDGE;
+}
+
+boykov_kolmogorov::boykov_kolmogorov() {
+
+}
+
+boykov_kolmogorov::~boykov_kolmogorov() {
+
+}
+
+FlowType boykov_kolmogorov::solve_max_flow_min_cut(flow_graph & G,
+                                                   NodeID source,
+                                                   NodeID sink,
+                                                   bool compute_source_set,
+                                                   std::vector<NodeID> & source_set) {
+        m_G      = &G;
+        m_source = source;
+        m_sink   = sink;
+        m_time   = 0;
+
+        m_tree.assign(G.number_of_nodes(), FREE);
+        m_parent_edge.assign(G.number_of_nodes(), ORPHAN);
+        m_is_active.assign(G.number_of_nodes(), false);
+        m_distance.assign(G.number_of_nodes(), 0);
+        m_timestamp.assign(G.number_of_nodes(), 0);
+        m_active  = std::queue<NodeID>();
+        m_orphans = std::queue<NodeID>();
+
+        m_tree[source]        = SOURCE_TREE;
+        m_tree[sink]          = SINK_TREE;
+        m_parent_edge[source] = TERMINAL;
+        m_parent_edge[sink]   = TERMINAL;
+        m_distance[source]    = 1;
+        m_distance[sink]      = 1;
+        activate(source);
+        activate(sink);
+
+        NodeID source_side = 0;
+        EdgeID bridge      = 0;
+        while (grow(source_side, bridge)) {
+                m_time++;
+                augment(source_side, bridge);
+                adopt();
+        }
+
+        FlowType value = 0;
+        forall_out_edges(G, e, source) {
+                value += G.getEdgeFlow(source, e);
+        } endfor
+
+        if (compute_source_set) {
+                // the source tree can not grow any further, so it consists of the nodes
+                // that are reachable from the source in the residual graph
+                source_set.clear();
+                forall_nodes(G, node) {
+                        if (m_tree[node] == SOURCE_TREE) {
+                                source_set.push_back(node);
+                        }
+                } endfor
+        }
+
+        return value;
+}
+
+bool boykov_kolmogorov::grow(NodeID & source_side, EdgeID & bridge) {
+        flow_graph & G = *m_G;
+        while (!m_active.empty()) {
+                NodeID node = m_active.front();
+                tree_type tree = m_tree[node];
+
+                if (tree != FREE) {
+                        forall_out_edges(G, e, node) {
+                                NodeID target = G.getEdgeTarget(node, e);
+                                EdgeID rev_e  = G.getReverseEdge(node, e);
+                                if (tree_capacity(target, rev_e, tree) <= 0) continue;
+
+                                if (m_tree[target] == FREE) {
+                                        m_tree[target]        = tree;
+                                        m_parent_edge[target] = rev_e;
+                                        m_timestamp[target]   = m_timestamp[node];
+                                        m_distance[target]    = m_distance[node] + 1;
+                                        activate(target);
+                                } else if (m_tree[target] != tree) {
+                                        // the trees touch, node stays active
+                                        if (tree == SOURCE_TREE) {
+                                                source_side = node;
+                                                bridge      = e;
+                                        } else {
+                                                source_side = target;
+                                                bridge      = rev_e;
+                                        }
+                                        return true;
+                                }
+                        } endfor
+                }
+
+                m_active.pop();
+                m_is_active[node] = false;
+        }
+
+        return false;
+}
+
+void boykov_kolmogorov::augment(NodeID source_side, EdgeID bridge) {
+        flow_graph & G   = *m_G;
+        NodeID sink_side = G.getEdgeTarget(source_side, bridge);
+
+        FlowType bottleneck = residual(source_side, bridge);
+        for (NodeID node = source_side; node != m_source; node = parent(node)) {
+                bottleneck = std::min(bottleneck, tree_capacity(node, m_parent_edge[node], SOURCE_TREE));
+        }
+        for (NodeID node = sink_side; node != m_sink; node = parent(node)) {
+                bottleneck = std::min(bottleneck, tree_capacity(node, m_parent_edge[node], SINK_TREE));
+        }
+
+        push(source_side, bridge, bottleneck);
+
+        // nodes whose edge to the parent is saturated become orphans
+        for (NodeID node = source_side; node != m_source;) {
+                NodeID next  = parent(node);
+                EdgeID rev_e = G.getReverseEdge(node, m_parent_edge[node]);
+                push(next, rev_e, bottleneck);
+                if (residual(next, rev_e) == 0) {
+                        make_orphan(node);
+                }
+                node = next;
+        }
+        for (NodeID node = sink_side; node != m_sink;) {
+                NodeID next = parent(node);
+                EdgeID e    = m_parent_edge[node];
+                push(node, e, bottleneck);
+                if (residual(node, e) == 0) {
+                        make_orphan(node);
+                }
+                node = next;
+        }
+}
+
+void boykov_kolmogorov::adopt() {
+        flow_graph & G = *m_G;
+        while (!m_orphans.empty()) {
+                NodeID node = m_orphans.front();
+                m_orphans.pop();
+                tree_type tree = m_tree[node];
+
+                // look for a new parent that is still connected to the terminal, prefer the closest one
+                EdgeID best_edge     = ORPHAN;
+                NodeID best_distance = UNDEFINED_NODE;
+                forall_out_edges(G, e, node) {
+                        NodeID target = G.getEdgeTarget(node, e);
+                        if (m_tree[target] != tree || tree_capacity(node, e, tree) <= 0) continue;
+
+                        NodeID distance = origin_distance(target);
+                        if (distance < best_distance) {
+                                best_distance = distance;
+                                best_edge     = e;
+                        }
+                } endfor
+
+                if (best_edge != ORPHAN) {
+                        m_parent_edge[node] = best_edge;
+                        m_timestamp[node]   = m_time;
+                        m_distance[node]    = best_distance + 1;
+                        continue;
+                }
+
+                // node leaves the tree, its children become orphans and its neighbors may grow into it again
+                forall_out_edges(G, e, node) {
+                        NodeID target = G.getEdgeTarget(node, e);
+                        if (m_tree[target] != tree) continue;
+
+                        if (tree_capacity(node, e, tree) > 0) {
+                                activate(target);
+                        }
+
+                        EdgeID parent_edge = m_parent_edge[target];
+                        if (parent_edge != TERMINAL && parent_edge != ORPHAN && parent(target) == node) {
+                                make_orphan(target);
+                        }
+                } endfor
+
+                m_tree[node] = FREE;
+        }
+}
+
+NodeID boykov_kolmogorov::origin_distance(NodeID node) {
+        NodeID distance = 0;
+        NodeID current  = node;
+        while (true) {
+                if (m_timestamp[current] == m_time) {
+                        distance += m_distance[current];
+                        break;
+                }
+
+                EdgeID e = m_parent_edge[current];
+                distance++;
+                if (e == TERMINAL) {
+                        m_timestamp[current] = m_time;
+                        m_distance[current]  = 1;
+                        break;
+                }
+                if (e == ORPHAN) {
+                        return UNDEFINED_NODE;
+                }
+                current = m_G->getEdgeTarget(current, e);
+        }
+
+        // the distances on the path stay valid until the next augmentation
+        NodeID path_distance = distance;
+        for (current = node; m_timestamp[current] != m_time; current = parent(current)) {
+                m_timestamp[current] = m_time;
+                m_distance[current]  = path_distance--;
+        }
+
+        return distance;
+}
+
+void boykov_kolmogorov::push(NodeID node, EdgeID e, FlowType amount) {
+        flow_graph & G = *m_G;
+        NodeID target  = G.getEdgeTarget(node, e);
+        EdgeID rev_e   = G.getReverseEdge(node, e);
+        G.setEdgeFlow(node, e, G.getEdgeFlow(node, e) + amount);
+        G.setEdgeFlow(target, rev_e, G.getEdgeFlow(target, rev_e) - amount);
+}
+
+void boykov_kolmogorov::activate(NodeID node) {
+        if (!m_is_active[node]) {
+                m_is_active[node] = true;
+                m_active.push(node);
+        }
+}
+
+void boykov_kolmogorov::make_orphan(NodeID node) {
+        m_parent_edge[node] = ORPHAN;
+        m_orphans.push(node);
+}
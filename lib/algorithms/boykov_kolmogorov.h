@@ -0,0 +1,73 @@
+#pragma once
+
+#include <queue>
+#include <vector>
+
+#include "data_structure/flow_graph.h"
+#include "data_structure/graph_access.h"
+#include "definitions.h"
+
+// augmenting path max flow of Boykov and Kolmogorov. a search tree is grown from the source and one from the sink,
+// an augmenting path is found when the trees touch. the trees are repaired after an augmentation instead of being
+// rebuilt, which makes the algorithm fast on the small and shallow flow problems of the local searches.
+class boykov_kolmogorov {
+public:
+        boykov_kolmogorov();
+        virtual ~boykov_kolmogorov();
+
+        FlowType solve_max_flow_min_cut(flow_graph & G,
+                                        NodeID source,
+                                        NodeID sink,
+                                        bool compute_source_set,
+                                        std::vector<NodeID> & source_set);
+
+private:
+        enum tree_type : uint8_t {
+                FREE,
+                SOURCE_TREE,
+                SINK_TREE
+        };
+
+        FlowType residual(NodeID node, EdgeID e) {
+                return m_G->getEdgeCapacity(node, e) - m_G->getEdgeFlow(node, e);
+        }
+
+        // residual capacity between node and the target of e if the target was the parent of node in tree
+        FlowType tree_capacity(NodeID node, EdgeID e, tree_type tree) {
+                return tree == SOURCE_TREE ? residual(m_G->getEdgeTarget(node, e), m_G->getReverseEdge(node, e))
+                                           : residual(node, e);
+        }
+
+        void push(NodeID node, EdgeID e, FlowType amount);
+
+        // grows the trees until they touch, returns false if there is no augmenting path
+        bool grow(NodeID & source_side, EdgeID & bridge);
+        void augment(NodeID source_side, EdgeID bridge);
+        void adopt();
+
+        // distance of node to its terminal or UNDEFINED_NODE if node has no terminal anymore
+        NodeID origin_distance(NodeID node);
+
+        void activate(NodeID node);
+        void make_orphan(NodeID node);
+
+        NodeID parent(NodeID node) {
+                return m_G->getEdgeTarget(node, m_parent_edge[node]);
+        }
+
+        flow_graph * m_G;
+        NodeID m_source;
+        NodeID m_sink;
+
+        std::vector<tree_type> m_tree;
+        // the edge of a node to its parent in the tree
+        std::vector<EdgeID> m_parent_edge;
+        std::vector<uint8_t> m_is_active;
+        std::queue<NodeID> m_active;
+        std::queue<NodeID> m_orphans;
+
+        // distance heuristic for the adoption, m_distance is valid if m_timestamp equals m_time
+        std::vector<NodeID> m_distance;
+        std::vector<uint32_t> m_timestamp;
+        uint32_t m_time;
+};
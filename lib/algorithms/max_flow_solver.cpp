@@ -0,0 +1,39 @@
+#include "algorithms/boykov_kolmogorov.h"
+#include "algorithms/max_flow_solver.h"
+#include "algorithms/parallel_push_relabel.h"
+#include "algorithms/push_relabel.h"
+#include "data_structure/parallel/thread_pool.h"
+
+FlowType max_flow_solver::solve_max_flow_min_cut(const PartitionConfig & config,
+                                                 flow_graph & G,
+                                                 NodeID source,
+                                                 NodeID sink,
+                                                 bool compute_source_set,
+                                                 std::vector<NodeID> & source_set) {
+        FlowSolverType type = config.flow_solver;
+        if (type == FlowSolverType::AUTOMATIC) {
+                bool large = G.number_of_nodes() >= config.parallel_flow_solver_threshold;
+                type = large && parallel::g_thread_pool.NumThreads() > 0 ? FlowSolverType::PARALLEL_PUSH_RELABEL
+                                                                          : FlowSolverType::BOYKOV_KOLMOGOROV;
+        }
+
+        switch (type) {
+                case FlowSolverType::PARALLEL_PUSH_RELABEL:
+                        return parallel_push_relabel().solve_max_flow_min_cut(G, source, sink, compute_source_set, source_set);
+                case FlowSolverType::BOYKOV_KOLMOGOROV:
+                        return boykov_kolmogorov().solve_max_flow_min_cut(G, source, sink, compute_source_set, source_set);
+                default:
+                        return push_relabel().solve_max_flow_min_cut(G, source, sink, compute_source_set, source_set);
+        }
+}
+
+FlowSolverType max_flow_solver::sequential_flow_solver(FlowSolverType type) {
+        switch (type) {
+                case FlowSolverType::PARALLEL_PUSH_RELABEL:
+                        return FlowSolverType::PUSH_RELABEL;
+                case FlowSolverType::AUTOMATIC:
+                        return FlowSolverType::BOYKOV_KOLMOGOROV;
+                default:
+                        return type;
+        }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+
+#include "data_structure/flow_graph.h"
+#include "data_structure/graph_access.h"
+#include "definitions.h"
+#include "partition/partition_config.h"
+
+// solves a max flow problem with the algorithm selected by config.flow_solver
+class max_flow_solver {
+public:
+        FlowType solve_max_flow_min_cut(const PartitionConfig & config,
+                                        flow_graph & G,
+                                        NodeID source,
+                                        NodeID sink,
+                                        bool compute_source_set,
+                                        std::vector<NodeID> & source_set);
+
+        // the solver to use for flow problems that are solved inside tasks of the thread pool
+        static FlowSolverType sequential_flow_solver(FlowSolverType type);
+};
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <queue>
+
+#include "algorithms/parallel_push_relabel.h"
+#include "data_structure/parallel/algorithm.h"
+#include "data_structure/parallel/thread_pool.h"
+
+namespace {
+const long long WORK_OP_RELABEL    = 9;
+const double    GLOBAL_UPDATE_FRQ  = 0.51;
+const long long WORK_NODE_TO_EDGES = 4;
+
+// smaller sets of nodes are processed by the calling thread only
+const size_t MIN_PARALLEL_SIZE = 1000;
+}
+
+parallel_push_relabel::parallel_push_relabel() {
+
+}
+
+parallel_push_relabel::~parallel_push_relabel() {
+
+}
+
+template <typename Functor>
+void parallel_push_relabel::for_all(const std::vector<NodeID> & nodes, Functor && functor) {
+        if (nodes.size() < MIN_PARALLEL_SIZE || parallel::g_thread_pool.NumThreads() == 0) {
+                for (NodeID node : nodes) {
+                        functor(node, uint32_t(0));
+                }
+                return;
+        }
+
+        parallel::parallel_for_index(size_t(0), nodes.size(), [&](size_t i, uint32_t thread_id) {
+                functor(nodes[i], thread_id);
+        });
+}
+
+FlowType parallel_push_relabel::solve_max_flow_min_cut(flow_graph & G,
+                                                       NodeID source,
+                                                       NodeID sink,
+                                                       bool compute_source_set,
+                                                       std::vector<NodeID> & source_set) {
+        m_G            = &G;
+        m_source       = source;
+        m_sink         = sink;
+        m_max_distance = 2 * G.number_of_nodes();
+
+        m_excess.assign(G.number_of_nodes(), 0);
+        m_added_excess.clear();
+        m_added_excess.resize(G.number_of_nodes());
+        m_distance.assign(G.number_of_nodes(), 0);
+        m_new_distance.assign(G.number_of_nodes(), 0);
+        m_is_active.assign(G.number_of_nodes(), false);
+        m_is_touched.clear();
+        m_is_touched.resize(G.number_of_nodes());
+        m_thread_data.clear();
+        m_thread_data.resize(parallel::g_thread_pool.NumThreads() + 1);
+
+        // saturate the edges leaving the source
+        m_active_nodes.clear();
+        forall_out_edges(G, e, source) {
+                FlowType capacity = G.getEdgeCapacity(source, e);
+                if (capacity == 0) continue;
+
+                NodeID target = G.getEdgeTarget(source, e);
+                EdgeID rev_e  = G.getReverseEdge(source, e);
+                G.setEdgeFlow(source, e, capacity);
+                G.setEdgeFlow(target, rev_e, G.getEdgeFlow(target, rev_e) - capacity);
+                m_excess[source] -= capacity;
+                m_excess[target] += capacity;
+
+                if (target != sink && !m_is_active[target]) {
+                        m_is_active[target] = true;
+                        m_active_nodes.push_back(target);
+                }
+        } endfor
+
+        global_relabeling();
+
+        long long work_todo = WORK_NODE_TO_EDGES * G.number_of_nodes() + G.number_of_edges();
+        long long work      = 0;
+        while (!m_active_nodes.empty()) {
+                work += discharge_round();
+
+                if (work > GLOBAL_UPDATE_FRQ * work_todo) {
+                        global_relabeling();
+                        work = 0;
+                }
+        }
+
+        if (compute_source_set) {
+                // perform bfs starting from source set
+                source_set.clear();
+
+                std::vector<bool> touched(G.number_of_nodes(), false);
+                std::queue<NodeID> Q;
+                Q.push(source);
+                touched[source] = true;
+
+                while (!Q.empty()) {
+                        NodeID node = Q.front();
+                        Q.pop();
+                        source_set.push_back(node);
+
+                        forall_out_edges(G, e, node) {
+                                NodeID target = G.getEdgeTarget(node, e);
+                                FlowType resCap = G.getEdgeCapacity(node, e) - G.getEdgeFlow(node, e);
+                                if (resCap > 0 && !touched[target]) {
+                                        Q.push(target);
+                                        touched[target] = true;
+                                }
+                        } endfor
+                }
+        }
+
+        return m_excess[sink];
+}
+
+long long parallel_push_relabel::discharge_round() {
+        for (auto & local : m_thread_data) {
+                local.get().nodes.clear();
+                local.get().work = 0;
+        }
+
+        for_all(m_active_nodes, [&](NodeID node, uint32_t thread_id) {
+                discharge(node, m_thread_data[thread_id].get());
+        });
+
+        long long work = 0;
+        for (auto & local : m_thread_data) {
+                work += local.get().work;
+        }
+
+        // the new labels are visible to the other nodes from the next round on
+        for_all(m_active_nodes, [&](NodeID node, uint32_t) {
+                m_distance[node]  = m_new_distance[node];
+                m_is_active[node] = false;
+        });
+
+        gather(m_touched_nodes);
+        for_all(m_touched_nodes, [&](NodeID node, uint32_t) {
+                m_excess[node] += m_added_excess[node].exchange(0, std::memory_order_relaxed);
+                m_is_touched[node].store(false, std::memory_order_relaxed);
+        });
+
+        m_active_nodes.clear();
+        for (NodeID node : m_touched_nodes) {
+                if (node != m_source && node != m_sink && m_excess[node] > 0 && m_distance[node] < m_max_distance) {
+                        m_is_active[node] = true;
+                        m_active_nodes.push_back(node);
+                }
+        }
+
+        return work;
+}
+
+void parallel_push_relabel::discharge(NodeID node, thread_data & local) {
+        flow_graph & G     = *m_G;
+        long long excess   = m_excess[node];
+        NodeID distance    = m_distance[node];
+        EdgeID end         = G.get_first_invalid_edge(node);
+
+        while (excess > 0) {
+                NodeID new_distance = m_max_distance;
+                bool skipped        = false;
+
+                for (EdgeID e = G.get_first_edge(node); e < end && excess > 0; ++e) {
+                        NodeID target = G.getEdgeTarget(node, e);
+                        if (m_is_active[target] && !wins(node, target)) {
+                                // the edge belongs to target in this round
+                                skipped = true;
+                                continue;
+                        }
+
+                        local.work++;
+                        FlowType flow     = G.getEdgeFlow(node, e);
+                        FlowType residual = G.getEdgeCapacity(node, e) - flow;
+                        if (residual <= 0) continue;
+
+                        if (distance == m_distance[target] + 1) {
+                                FlowType amount = std::min((long long) residual, excess);
+                                EdgeID rev_e    = G.getReverseEdge(node, e);
+                                G.setEdgeFlow(node, e, flow + amount);
+                                G.setEdgeFlow(target, rev_e, G.getEdgeFlow(target, rev_e) - amount);
+
+                                excess -= amount;
+                                m_added_excess[target].fetch_add(amount, std::memory_order_relaxed);
+                                touch(target, local);
+                        } else if (m_distance[target] >= distance) {
+                                new_distance = std::min(new_distance, m_distance[target] + 1);
+                        }
+                }
+
+                // a node that skipped an edge does not know all of its residual edges and can not be relabeled
+                if (excess == 0 || skipped) break;
+
+                local.work += WORK_OP_RELABEL;
+                distance = new_distance;
+                if (distance >= m_max_distance) break;
+        }
+
+        m_new_distance[node] = distance;
+        m_excess[node]       = excess;
+        if (excess > 0) {
+                touch(node, local);
+        }
+}
+
+bool parallel_push_relabel::wins(NodeID node, NodeID target) const {
+        NodeID d_node   = m_distance[node];
+        NodeID d_target = m_distance[target];
+        return d_node == d_target + 1 || d_node + 1 < d_target || (d_node == d_target && node < target);
+}
+
+void parallel_push_relabel::touch(NodeID node, thread_data & local) {
+        if (!m_is_touched[node].load(std::memory_order_relaxed) && !m_is_touched[node].exchange(true)) {
+                local.nodes.push_back(node);
+        }
+}
+
+void parallel_push_relabel::gather(std::vector<NodeID> & nodes) {
+        nodes.clear();
+        for (auto & local : m_thread_data) {
+                nodes.insert(nodes.end(), local.get().nodes.begin(), local.get().nodes.end());
+                local.get().nodes.clear();
+        }
+}
+
+// exact distance labels: the distance to the sink for the nodes that can reach the sink in the residual graph,
+// the number of nodes plus the distance to the source for the remaining nodes that can reach the source.
+void parallel_push_relabel::global_relabeling() {
+        flow_graph & G = *m_G;
+        std::fill(m_distance.begin(), m_distance.end(), m_max_distance);
+
+        m_distance[m_sink]   = 0;
+        m_distance[m_source] = G.number_of_nodes();
+        m_is_touched[m_sink].store(true);
+        m_is_touched[m_source].store(true);
+
+        backward_bfs(m_sink);
+        backward_bfs(m_source);
+
+        std::vector<NodeID> & visited = m_touched_nodes;
+        for (auto & flag : m_is_touched) {
+                flag.store(false, std::memory_order_relaxed);
+        }
+
+        // nodes that reach neither the sink nor the source have no excess
+        visited.clear();
+        for (NodeID node : m_active_nodes) {
+                if (m_distance[node] < m_max_distance) {
+                        visited.push_back(node);
+                } else {
+                        m_is_active[node] = false;
+                }
+        }
+        m_active_nodes.swap(visited);
+}
+
+void parallel_push_relabel::backward_bfs(NodeID root) {
+        flow_graph & G = *m_G;
+        std::vector<NodeID> frontier(1, root);
+        NodeID distance = m_distance[root];
+
+        while (!frontier.empty()) {
+                distance++;
+                for_all(frontier, [&](NodeID node, uint32_t thread_id) {
+                        thread_data & local = m_thread_data[thread_id].get();
+                        forall_out_edges(G, e, node) {
+                                NodeID target = G.getEdgeTarget(node, e);
+                                EdgeID rev_e  = G.getReverseEdge(node, e);
+                                if (G.getEdgeCapacity(target, rev_e) - G.getEdgeFlow(target, rev_e) <= 0) continue;
+
+                                if (!m_is_touched[target].load(std::memory_order_relaxed)
+                                    && !m_is_touched[target].exchange(true)) {
+                                        m_distance[target] = distance;
+                                        local.nodes.push_back(target);
+                                }
+                        } endfor
+                });
+                gather(frontier);
+        }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+#include "data_structure/flow_graph.h"
+#include "data_structure/graph_access.h"
+#include "data_structure/parallel/atomics.h"
+#include "data_structure/parallel/cache.h"
+#include "definitions.h"
+
+// synchronous parallel push-relabel. in every round all active nodes are discharged concurrently with respect to
+// the distance labels of the previous round. if both endpoints of an edge are active only one of them, the winner,
+// looks at the edge, hence the flow on an edge is changed by at most one thread per round. the excess a node receives
+// is collected atomically and applied at the end of the round. global relabeling is a level synchronous parallel
+// bfs from the sink and then from the source, so the excess that can not reach the sink is returned to the source
+// and the result is a maximum flow and not only a preflow.
+class parallel_push_relabel {
+public:
+        parallel_push_relabel();
+        virtual ~parallel_push_relabel();
+
+        FlowType solve_max_flow_min_cut(flow_graph & G,
+                                        NodeID source,
+                                        NodeID sink,
+                                        bool compute_source_set,
+                                        std::vector<NodeID> & source_set);
+
+private:
+        struct thread_data {
+                std::vector<NodeID> nodes;
+                long long work = 0;
+        };
+
+        // discharges all active nodes, returns the work done in the round
+        long long discharge_round();
+        void discharge(NodeID node, thread_data & local);
+
+        // true iff node may use its edges to target in this round, both nodes have to be active
+        bool wins(NodeID node, NodeID target) const;
+
+        // adds node to the nodes touched in this round if it is not already contained
+        void touch(NodeID node, thread_data & local);
+
+        void global_relabeling();
+        void backward_bfs(NodeID root);
+
+        // moves the nodes collected by the threads to nodes
+        void gather(std::vector<NodeID> & nodes);
+
+        template <typename Functor>
+        void for_all(const std::vector<NodeID> & nodes, Functor && functor);
+
+        flow_graph * m_G;
+        NodeID m_source;
+        NodeID m_sink;
+        NodeID m_max_distance;
+
+        std::vector<long long> m_excess;
+        std::vector<parallel::AtomicWrapper<long long>> m_added_excess;
+        std::vector<NodeID> m_distance;
+        std::vector<NodeID> m_new_distance;
+        std::vector<uint8_t> m_is_active;
+        // used for the nodes touched in a round and for the visited nodes of the bfs
+        std::vector<parallel::AtomicWrapper<bool>> m_is_touched;
+
+        std::vector<NodeID> m_active_nodes;
+        std::vector<NodeID> m_touched_nodes;
+        std::vector<parallel::CacheAlignedData<thread_data>> m_thread_data;
+};
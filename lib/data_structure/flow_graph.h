@@ -23,28 +23,23 @@
 #ifndef FLOW_GRAPH_636S5L2S
 #define FLOW_GRAPH_636S5L2S
 
+#include <vector>
+
 #include "definitions.h"
 
 struct rEdge {
-    NodeID     source;
     NodeID     target;
+    EdgeID     reverse_edge_index;
     FlowType   capacity;
     FlowType   flow;
-    EdgeID     reverse_edge_index;
-
-    rEdge( NodeID source, NodeID target, FlowType capacity, FlowType flow, EdgeID reverse_edge_index) {
-        this->source             = source;
-        this->target             = target;
-        this->capacity           = capacity;
-        this->flow               = flow;
-        this->reverse_edge_index = reverse_edge_index;
-    }
-
 };
 
-// this is a adjacency list implementation of the residual graph
+// this is a compressed sparse row implementation of the residual graph
 // for each edge we create, we create a rev edge with cap 0
 // zero capacity edges are residual edges
+// new_edge only records an edge, finish_construction builds the adjacency array in two passes.
+// the first pass counts the edges of every node, the second one places each edge and its reverse edge.
+// the edges of a node keep the order in which they were created. edge ids are global.
 class flow_graph {
 public:
         flow_graph() {
@@ -54,24 +49,44 @@ public:
 
         virtual ~flow_graph() {};
 
+        // edges is the expected number of calls to new_edge
         void start_construction(NodeID nodes, EdgeID edges = 0) {
-                m_adjacency_lists.resize(nodes);
                 m_num_nodes = nodes;
-                m_num_edges = edges;
+                m_num_edges = 0;
+                m_first_edge.clear();
+                m_edges.clear();
+                m_pending_edges.clear();
+                m_pending_edges.reserve(edges);
+        }
 
-                uint32_t avg_deg = m_num_edges / m_num_nodes;
-                for (size_t i = 0; i < m_num_nodes; ++i) {
-                        m_adjacency_lists[i].reserve(std::max(avg_deg, 100u));
+        void finish_construction() {
+                m_first_edge.assign(m_num_nodes + 1, 0);
+                for (const pending_edge & e : m_pending_edges) {
+                        m_first_edge[e.source + 1]++;
+                        m_first_edge[e.target + 1]++;
+                }
+                for (NodeID node = 0; node < m_num_nodes; ++node) {
+                        m_first_edge[node + 1] += m_first_edge[node];
+                }
+
+                std::vector<EdgeID> next_edge(m_first_edge.begin(), m_first_edge.end() - 1);
+                m_edges.resize(m_num_edges);
+                for (const pending_edge & e : m_pending_edges) {
+                        EdgeID forward  = next_edge[e.source]++;
+                        EdgeID backward = next_edge[e.target]++;
+                        m_edges[forward]  = rEdge{e.target, backward, e.capacity, 0};
+                        m_edges[backward] = rEdge{e.source, forward, 0, 0};
                 }
-        }
- 
-        void finish_construction() {};
+
+                std::vector<pending_edge>().swap(m_pending_edges);
+        };
 
         NodeID number_of_nodes() {return m_num_nodes;};
         EdgeID number_of_edges() {return m_num_edges;};
 
         NodeID getEdgeTarget(NodeID source, EdgeID e);
         NodeID getEdgeCapacity(NodeID source, EdgeID e);
+        void setEdgeCapacity(NodeID source, EdgeID e, FlowType capacity);
 
         FlowType getEdgeFlow(NodeID source, EdgeID e);
         void setEdgeFlow(NodeID source, EdgeID e, FlowType flow);
@@ -79,64 +94,80 @@ public:
         EdgeID getReverseEdge(NodeID source, EdgeID e);
         
         void new_edge(NodeID source, NodeID target, FlowType capacity) {
-               m_adjacency_lists[source].push_back(rEdge(source, target, capacity, 0, m_adjacency_lists[target].size()));
+               m_pending_edges.push_back(pending_edge{source, target, capacity});
                // for each edge we add a reverse edge
-               m_adjacency_lists[target].push_back(rEdge(target, source, 0, 0, m_adjacency_lists[source].size() - 1));
                m_num_edges += 2;
         };
 
-        EdgeID get_first_edge(NodeID node) {return 0;};
-        EdgeID get_first_invalid_edge(NodeID node) {return m_adjacency_lists[node].size();};
+        EdgeID get_first_edge(NodeID node) {return m_first_edge[node];};
+        EdgeID get_first_invalid_edge(NodeID node) {return m_first_edge[node + 1];};
 
 
 private:
-        std::vector< std::vector<rEdge> > m_adjacency_lists;
+        struct pending_edge {
+                NodeID   source;
+                NodeID   target;
+                FlowType capacity;
+        };
+
+        std::vector<EdgeID> m_first_edge;
+        std::vector<rEdge>  m_edges;
+        std::vector<pending_edge> m_pending_edges;
         NodeID m_num_nodes;
-        NodeID m_num_edges;
+        EdgeID m_num_edges;
 };
 
 inline
 NodeID flow_graph::getEdgeCapacity(NodeID source, EdgeID e) {
 #ifdef NDEBUG
-        return m_adjacency_lists[source][e].capacity;        
+        return m_edges[e].capacity;        
+#else
+        return m_edges.at(e).capacity;        
+#endif
+};
+
+inline
+void flow_graph::setEdgeCapacity(NodeID source, EdgeID e, FlowType capacity) {
+#ifdef NDEBUG
+        m_edges[e].capacity = capacity;
 #else
-        return m_adjacency_lists.at(source).at(e).capacity;        
+        m_edges.at(e).capacity = capacity;
 #endif
 };
 
 inline
 void flow_graph::setEdgeFlow(NodeID source, EdgeID e, FlowType flow) {
 #ifdef NDEBUG
-        m_adjacency_lists[source][e].flow = flow;        
+        m_edges[e].flow = flow;        
 #else
-        m_adjacency_lists.at(source).at(e).flow = flow;        
+        m_edges.at(e).flow = flow;        
 #endif
 };
 
 inline
 FlowType flow_graph::getEdgeFlow(NodeID source, EdgeID e) {
 #ifdef NDEBUG
-        return m_adjacency_lists[source][e].flow;        
+        return m_edges[e].flow;        
 #else
-        return m_adjacency_lists.at(source).at(e).flow;        
+        return m_edges.at(e).flow;        
 #endif
 };
 
 inline
 NodeID flow_graph::getEdgeTarget(NodeID source, EdgeID e) {
 #ifdef NDEBUG
-        return m_adjacency_lists[source][e].target;        
+        return m_edges[e].target;        
 #else
-        return m_adjacency_lists.at(source).at(e).target;        
+        return m_edges.at(e).target;        
 #endif
 };
 
 inline
 EdgeID flow_graph::getReverseEdge(NodeID source, EdgeID e) {
 #ifdef NDEBUG
-        return m_adjacency_lists[source][e].reverse_edge_index;
+        return m_edges[e].reverse_edge_index;
 #else
-        return m_adjacency_lists.at(source).at(e).reverse_edge_index;        
+        return m_edges.at(e).reverse_edge_index;        
 #endif
 
 }
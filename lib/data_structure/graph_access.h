@@ -23,9 +23,12 @@
 #ifndef GRAPH_ACCESS_EFRXO4X2
 #define GRAPH_ACCESS_EFRXO4X2
 
+#include <algorithm>
 #include <bitset>
 #include <cassert>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
 #include "definitions.h"
@@ -51,12 +54,136 @@ struct coarseningEdge {
 
 class graph_access;
 
+// array of nodes or edges of a basicGraph. the elements either live in an owned std::vector or in an
+// external region (e.g. a memory mapped binary graph file) that is kept alive by m_region.
+// an external region is copied into owned storage as soon as the array is resized or swapped, unless
+// it was handed out with reserve and the new size fits into the reserved capacity.
+template <typename T>
+class graph_array {
+public:
+        graph_array() : m_data(nullptr), m_size(0), m_capacity(0) {
+        }
+
+        graph_array(const graph_array& other) : m_storage(other.m_data, other.m_data + other.m_size) {
+                refresh();
+        }
+
+        graph_array& operator=(const graph_array& other) {
+                if (this != &other) {
+                        m_storage.assign(other.m_data, other.m_data + other.m_size);
+                        m_region.reset();
+                        refresh();
+                }
+                return *this;
+        }
+
+        inline T& operator[](size_t index) {
+                return m_data[index];
+        }
+
+        inline const T& operator[](size_t index) const {
+                return m_data[index];
+        }
+
+        T& at(size_t index) {
+                if (index >= m_size) {
+                        throw std::out_of_range("graph_array::at");
+                }
+                return m_data[index];
+        }
+
+        inline size_t size() const {
+                return m_size;
+        }
+
+        inline T* begin() {
+                return m_data;
+        }
+
+        inline T* end() {
+                return m_data + m_size;
+        }
+
+        void resize(size_t size) {
+                if (m_region != nullptr && size <= m_capacity) {
+                        if (size > m_size) {
+                                std::uninitialized_fill(m_data + m_size, m_data + size, T());
+                        }
+                        m_size = size;
+                        return;
+                }
+                detach();
+                m_storage.resize(size);
+                refresh();
+        }
+
+        void assign(size_t size, const T& value) {
+                m_region.reset();
+                m_storage.assign(size, value);
+                refresh();
+        }
+
+        void swap(std::vector<T>& other) {
+                detach();
+                m_storage.swap(other);
+                refresh();
+        }
+
+        // use size elements starting at data without copying them. region owns the memory.
+        void map(T* data, size_t size, std::shared_ptr<void> region) {
+                std::vector<T>().swap(m_storage);
+                m_region = region;
+                m_data     = data;
+                m_size     = size;
+                m_capacity = 0;
+        }
+
+        // empties the array, it grows in place into capacity elements starting at data on resize.
+        // region owns the memory.
+        void reserve(T* data, size_t capacity, std::shared_ptr<void> region) {
+                map(data, 0, std::move(region));
+                m_capacity = capacity;
+        }
+
+        bool is_mapped() const {
+                return m_region != nullptr;
+        }
+
+        // drops all elements and frees the owned storage including its capacity
+        void release() {
+                std::vector<T>().swap(m_storage);
+                m_region.reset();
+                refresh();
+        }
+
+private:
+        void detach() {
+                if (m_region != nullptr) {
+                        m_storage.assign(m_data, m_data + m_size);
+                        m_region.reset();
+                }
+        }
+
+        void refresh() {
+                m_data     = m_storage.data();
+                m_size     = m_storage.size();
+                m_capacity = 0;
+        }
+
+        std::vector<T> m_storage;
+        std::shared_ptr<void> m_region;
+        T* m_data;
+        size_t m_size;
+        // elements of a reserved region, 0 for owned storage and mapped regions
+        size_t m_capacity;
+};
+
 //construction etc. is encapsulated in basicGraph / access to properties etc. is encapsulated in graph_access
 class basicGraph {
     friend class graph_access;
 
 public:
-    basicGraph() : m_building_graph(false) {
+    basicGraph() : m_building_graph(false), m_read_only(false) {
     }
 
 //private:
@@ -80,9 +207,10 @@ public:
     // construction of the graph
     void start_construction(NodeID n, EdgeID m) {
         m_building_graph = true;
+        m_read_only      = false;
         node             = 0;
         e                = 0;
-        m_last_source    = -1;
+        m_last_source    = UNDEFINED_NODE; // wraps to 0 on m_last_source+1
 
         //resizes property arrays
         m_nodes.resize(n+1);
@@ -96,6 +224,7 @@ public:
     void start_construction(std::vector<Node>& nodes, std::vector<Edge>& edges) {
         m_nodes.swap(nodes);
         m_edges.swap(edges);
+        m_read_only = false;
         m_refinement_node_props.resize(m_nodes.size());
         m_coarsening_edge_props.resize(m_edges.size());
     }
@@ -112,8 +241,8 @@ public:
         m_nodes[source+1].firstEdge = e;
 
         //fill isolated sources at the end
-        if ((NodeID)(m_last_source+1) < source) {
-            for (NodeID i = source; i>(NodeID)(m_last_source+1); i--) {
+        if (m_last_source+1 < source) {
+            for (NodeID i = source; i>m_last_source+1; i--) {
                 m_nodes[i].firstEdge = m_nodes[m_last_source+1].firstEdge;
             }
         }
@@ -137,9 +266,9 @@ public:
         m_building_graph = false;
 
         //fill isolated sources at the end
-        if ((unsigned int)(m_last_source) != node-1) {
+        if (m_last_source != node-1) {
                 //in that case at least the last node was an isolated node
-                for (NodeID i = node; i>(unsigned int)(m_last_source+1); i--) {
+                for (NodeID i = node; i>m_last_source+1; i--) {
                         m_nodes[i].firstEdge = m_nodes[m_last_source+1].firstEdge;
                 }
         }
@@ -147,15 +276,18 @@ public:
 
     // %%%%%%%%%%%%%%%%%%% DATA %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
     // split properties for coarsening and uncoarsening
-    std::vector<Node> m_nodes;
-    std::vector<Edge> m_edges;
+    graph_array<Node> m_nodes;
+    graph_array<Edge> m_edges;
     
-    std::vector<refinementNode> m_refinement_node_props;
+    graph_array<refinementNode> m_refinement_node_props;
     std::vector<coarseningEdge> m_coarsening_edge_props;
         
     // construction properties
     bool m_building_graph;
-    int m_last_source;
+    // set for a view of another graph (see graph_access::share_structure), m_nodes and m_edges
+    // belong to that graph and must not be written
+    bool m_read_only;
+    NodeID m_last_source;
     NodeID node; //current node that is constructed
     EdgeID e;    //current edge that is constructed
 };
@@ -186,6 +318,7 @@ class graph_access {
                 EdgeID new_edge(NodeID source, NodeID target);
                 void remove_edge(EdgeID e, EdgeID first_invalid_edge);
                 void finish_construction();
+                // parallel construction: see parallel::graph_builder in data_structure/parallel/graph_builder.h
 
                 /* ============================================================= */
                 /* graph access methods */
@@ -249,6 +382,14 @@ class graph_access {
                 //Count get_node_queue_index(NodeID node);
 
                 void copy(graph_access & Gcopy);
+                // G_view becomes a read-only view of this graph: it uses the nodes and edges of this graph
+                // without copying them and only owns a partition array. Threads that work on the same graph
+                // take one view each instead of a copy. Node and edge weights of a view must not be set, the
+                // edge ratings are allocated when the view is rated. This graph has to outlive G_view,
+                // starting a new construction in G_view detaches it from this graph.
+                void share_structure(graph_access & G_view);
+                // allocates the edge ratings of a view, a no-op for all other graphs
+                void allocate_edge_ratings();
         //private:
                 basicGraph * graphref;     
                 bool         m_max_degree_computed;
@@ -278,6 +419,7 @@ inline EdgeID graph_access::new_edge(NodeID source, NodeID target) {
 }
 
 inline void graph_access::remove_edge(EdgeID e, EdgeID end) {
+        ASSERT_TRUE(!graphref->m_read_only);
         if (end > e) {
                 std::swap(graphref->m_edges[e], graphref->m_edges[end - 1]);
                 std::swap(graphref->m_coarsening_edge_props[e], graphref->m_coarsening_edge_props[end - 1]);
@@ -375,6 +517,7 @@ inline NodeWeight graph_access::getNodeWeight(NodeID node){
 }
 
 inline void graph_access::setNodeWeight(NodeID node, NodeWeight weight){
+        ASSERT_TRUE(!graphref->m_read_only);
 #ifdef NDEBUG
         graphref->m_nodes[node].weight = weight;        
 #else
@@ -391,6 +534,7 @@ inline EdgeWeight graph_access::getEdgeWeight(EdgeID edge){
 }
 
 inline void graph_access::setEdgeWeight(EdgeID edge, EdgeWeight weight){
+        ASSERT_TRUE(!graphref->m_read_only);
 #ifdef NDEBUG
         graphref->m_edges[edge].weight = weight;        
 #else
@@ -428,7 +572,7 @@ inline EdgeWeight graph_access::getNodeDegree(NodeID node) {
 
 inline EdgeWeight graph_access::getWeightedNodeDegree(NodeID node) {
 	EdgeWeight degree = 0;
-	for( unsigned e = graphref->m_nodes[node].firstEdge; e < graphref->m_nodes[node+1].firstEdge; ++e) {
+	for( EdgeID e = graphref->m_nodes[node].firstEdge; e < graphref->m_nodes[node+1].firstEdge; ++e) {
 		degree += getEdgeWeight(e);
 	}
         return degree;
@@ -557,4 +701,26 @@ inline void graph_access::copy(graph_access & G_bar) {
         G_bar.finish_construction();
 }
 
+inline void graph_access::share_structure(graph_access & G_view) {
+        // the memory is owned by this graph, the region only marks the arrays of G_view as external
+        std::shared_ptr<void> region(graphref, [](void*) {});
+        G_view.graphref->m_nodes.map(graphref->m_nodes.begin(), graphref->m_nodes.size(), region);
+        G_view.graphref->m_edges.map(graphref->m_edges.begin(), graphref->m_edges.size(), region);
+        G_view.graphref->m_refinement_node_props.assign(graphref->m_nodes.size(), refinementNode());
+        std::vector<coarseningEdge>().swap(G_view.graphref->m_coarsening_edge_props);
+        G_view.graphref->m_building_graph = false;
+        G_view.graphref->m_read_only      = true;
+
+        G_view.m_max_degree_computed = m_max_degree_computed;
+        G_view.m_max_degree          = m_max_degree;
+        G_view.m_unit_weighted_edges = m_unit_weighted_edges;
+        G_view.m_separator_block_ID  = m_separator_block_ID;
+}
+
+inline void graph_access::allocate_edge_ratings() {
+        if (graphref->m_coarsening_edge_props.size() != graphref->m_edges.size()) {
+                graphref->m_coarsening_edge_props.resize(graphref->m_edges.size());
+        }
+}
+
 #endif /* end of include guard: GRAPH_ACCESS_EFRXO4X2 */
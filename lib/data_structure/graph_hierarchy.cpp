@@ -20,11 +20,53 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+
 #include "data_structure/parallel/algorithm.h"
 #include "graph_hierarchy.h"
 
+namespace {
+// number of records written at once by write_records
+const size_t SPILL_WRITE_BLOCK = 1 << 16;
+
+// arrays of types without padding are written as they are
+template <typename T>
+void write_array(std::ofstream & f, const T * data, size_t size) {
+        f.write((const char*) data, size * sizeof(T));
+}
+
+// writes size records in the memory layout of Record, so that read_array can read them back. the
+// records are assembled field by field in a zero-filled buffer, so no uninitialized padding bytes
+// end up in the scratch file. write_fields(record, i) copies the fields of record i.
+template <typename Record, typename WriteFields>
+void write_records(std::ofstream & f, size_t size, WriteFields write_fields) {
+        std::vector<char> buffer(std::min(size, SPILL_WRITE_BLOCK) * sizeof(Record));
+        for (size_t begin = 0; begin < size; begin += SPILL_WRITE_BLOCK) {
+                size_t block = std::min(size - begin, SPILL_WRITE_BLOCK);
+                std::fill(buffer.begin(), buffer.begin() + block * sizeof(Record), 0);
+                for (size_t i = 0; i < block; ++i) {
+                        write_fields(buffer.data() + i * sizeof(Record), begin + i);
+                }
+                f.write(buffer.data(), block * sizeof(Record));
+        }
+}
+
+template <typename T>
+void read_array(std::ifstream & f, std::vector<T> & array, size_t size) {
+        array.resize(size);
+        f.read((char*) array.data(), size * sizeof(T));
+}
+}
+
 graph_hierarchy::graph_hierarchy() : m_current_coarser_graph(NULL), 
-                                     m_current_coarse_mapping(NULL){
+                                     m_current_coarse_mapping(NULL),
+                                     m_arena(hierarchy_arena::create()) {
 
 }
 
@@ -38,6 +80,18 @@ graph_hierarchy::~graph_hierarchy() {
                 if(m_to_delete_hierachies[i] != NULL)
                 delete m_to_delete_hierachies[i];
         }
+
+        // levels that were never popped again
+        while (!m_spilled.empty()) {
+                if (!m_spilled.top().filename.empty()) {
+                        std::remove(m_spilled.top().filename.c_str());
+                }
+                m_spilled.pop();
+        }
+}
+
+void graph_hierarchy::spill_to(const std::string & directory) {
+        m_spill_directory = directory;
 }
 
 void graph_hierarchy::push_back(graph_access * G, CoarseMapping * coarse_mapping) {
@@ -45,6 +99,110 @@ void graph_hierarchy::push_back(graph_access * G, CoarseMapping * coarse_mapping
         m_the_mappings.push(coarse_mapping);
 	m_to_delete_mappings.push_back(coarse_mapping);
         m_coarsest_graph = G;
+
+        // the input graph is the first level, it is owned by the caller and stays in memory
+        spilled_level level;
+        bool is_input_graph = m_the_graph_hierarchy.size() == 1;
+        if (m_spill_directory.empty() || coarse_mapping == NULL || is_input_graph
+            || !spill(G, coarse_mapping, level)) {
+                level.filename.clear();
+        }
+        m_spilled.push(level);
+}
+
+void graph_hierarchy::reserve_level(graph_access * G, NodeID nodes, EdgeID edges) {
+        // the arena frees levels in stack order only, a spilled level would keep its memory
+        if (!m_spill_directory.empty()) {
+                return;
+        }
+        m_arena->reserve(*G, nodes, edges);
+}
+
+void graph_hierarchy::finish_level(graph_access * G) {
+        if (!m_spill_directory.empty()) {
+                return;
+        }
+        m_arena->shrink_to_fit(*G);
+}
+
+bool graph_hierarchy::spill(graph_access * G, CoarseMapping * coarse_mapping, spilled_level & level) {
+        std::string pattern = m_spill_directory + "/kahip_level_XXXXXX";
+        std::vector<char> filename(pattern.begin(), pattern.end());
+        filename.push_back('\0');
+        int fd = mkstemp(filename.data());
+        if (fd < 0) {
+                std::cerr << "Could not create a scratch file in " << m_spill_directory << ", the level stays in memory." << std::endl;
+                return false;
+        }
+        close(fd);
+        level.filename = filename.data();
+
+        basicGraph & graph = *G->graphref;
+        level.nodes                  = graph.m_nodes.size();
+        level.edges                  = graph.m_edges.size();
+        level.refinement_node_props  = graph.m_refinement_node_props.size();
+        level.coarsening_edge_props  = graph.m_coarsening_edge_props.size();
+        level.second_partition_index = G->m_second_partition_index.size();
+        level.mapping                = coarse_mapping->size();
+
+        // the edge ratings are not written, they are computed again before the level is coarsened
+        std::ofstream f(level.filename.c_str(), std::ios::binary);
+        write_records<Node>(f, level.nodes, [&](char * record, size_t i) {
+                const Node & node = graph.m_nodes[i];
+                memcpy(record + offsetof(Node, firstEdge), &node.firstEdge, sizeof(node.firstEdge));
+                memcpy(record + offsetof(Node, weight), &node.weight, sizeof(node.weight));
+        });
+        write_records<Edge>(f, level.edges, [&](char * record, size_t i) {
+                const Edge & edge = graph.m_edges[i];
+                memcpy(record + offsetof(Edge, target), &edge.target, sizeof(edge.target));
+                memcpy(record + offsetof(Edge, weight), &edge.weight, sizeof(edge.weight));
+        });
+        static_assert(sizeof(refinementNode) == sizeof(PartitionID), "refinementNode has padding");
+        write_array(f, graph.m_refinement_node_props.begin(), level.refinement_node_props);
+        write_array(f, G->m_second_partition_index.data(), level.second_partition_index);
+        write_array(f, coarse_mapping->data(), level.mapping);
+        f.close();
+
+        if (!f) {
+                std::cerr << "Error writing " << level.filename << ", the level stays in memory." << std::endl;
+                std::remove(level.filename.c_str());
+                return false;
+        }
+
+        graph.m_nodes.release();
+        graph.m_edges.release();
+        graph.m_refinement_node_props.release();
+        std::vector<coarseningEdge>().swap(graph.m_coarsening_edge_props);
+        std::vector<PartitionID>().swap(G->m_second_partition_index);
+        CoarseMapping().swap(*coarse_mapping);
+        return true;
+}
+
+void graph_hierarchy::restore(graph_access * G, CoarseMapping * coarse_mapping, spilled_level & level) {
+        std::ifstream f(level.filename.c_str(), std::ios::binary);
+
+        std::vector<Node> nodes;
+        std::vector<Edge> edges;
+        std::vector<refinementNode> refinement_node_props;
+        read_array(f, nodes, level.nodes);
+        read_array(f, edges, level.edges);
+        read_array(f, refinement_node_props, level.refinement_node_props);
+        read_array(f, G->m_second_partition_index, level.second_partition_index);
+        read_array(f, *coarse_mapping, level.mapping);
+
+        if (!f) {
+                std::cerr << "Error reading the scratch file " << level.filename << std::endl;
+                exit(1);
+        }
+        f.close();
+        std::remove(level.filename.c_str());
+        level.filename.clear();
+
+        basicGraph & graph = *G->graphref;
+        graph.m_nodes.swap(nodes);
+        graph.m_edges.swap(edges);
+        graph.m_refinement_node_props.swap(refinement_node_props);
+        graph.m_coarsening_edge_props.assign(level.coarsening_edge_props, coarseningEdge());
 }
 
 graph_access* graph_hierarchy::pop_finer_and_project() {
@@ -81,9 +239,26 @@ graph_access* graph_hierarchy::pop_finer_and_project() {
 }
 
 graph_access* graph_hierarchy::parallel_pop_finer_and_project() {
+        graph_access* coarser = NULL;
+        CoarseMapping* coarse_mapping = NULL;
+        graph_access* finer = pop_finer(coarser, coarse_mapping);
+
+        //perform projection
+        graph_access& fRef = *finer;
+        graph_access& cRef = *coarser;
+        parallel::parallel_for_index(NodeID(0), fRef.number_of_nodes(), [&](NodeID node) {
+                NodeID coarser_node = (*coarse_mapping)[node];
+                PartitionID coarser_partition_id = cRef.getPartitionIndex(coarser_node);
+                fRef.setPartitionIndex(node, coarser_partition_id);
+        });
+
+        return finer;
+}
+
+graph_access* graph_hierarchy::pop_finer(graph_access* & coarser, CoarseMapping* & coarse_mapping) {
         graph_access* finer = pop_coarsest();
 
-        CoarseMapping* coarse_mapping = m_the_mappings.top(); // mapps finer to coarser nodes
+        coarse_mapping = m_the_mappings.top(); // mapps finer to coarser nodes
         m_the_mappings.pop();
 
         if(finer == m_coarsest_graph) {
@@ -97,15 +272,7 @@ graph_access* graph_hierarchy::parallel_pop_finer_and_project() {
 
         ASSERT_EQ(m_the_graph_hierarchy.size(), m_the_mappings.size());
 
-        //perform projection
-        graph_access& fRef = *finer;
-        graph_access& cRef = *m_current_coarser_graph;
-        parallel::parallel_for_index(NodeID(0), fRef.number_of_nodes(), [&](NodeID node) {
-                NodeID coarser_node = (*coarse_mapping)[node];
-                PartitionID coarser_partition_id = cRef.getPartitionIndex(coarser_node);
-                fRef.setPartitionIndex(node, coarser_partition_id);
-        });
-
+        coarser = m_current_coarser_graph;
         m_current_coarse_mapping = coarse_mapping;
         finer->set_partition_count(m_current_coarser_graph->get_partition_count());
         m_current_coarser_graph = finer;
@@ -159,6 +326,16 @@ graph_access* graph_hierarchy::get_coarsest( ) {
 graph_access* graph_hierarchy::pop_coarsest( ) {
         graph_access* current_coarsest = m_the_graph_hierarchy.top(); 
         m_the_graph_hierarchy.pop();
+
+        if (!m_spilled.top().filename.empty()) {
+                // the mapping of the previous level has been used up by the projection
+                if (m_current_coarse_mapping != NULL) {
+                        CoarseMapping().swap(*m_current_coarse_mapping);
+                }
+                restore(current_coarsest, m_the_mappings.top(), m_spilled.top());
+        }
+        m_spilled.pop();
+
         return current_coarsest;                
 }
 
@@ -23,9 +23,12 @@
 #ifndef GRAPH_HIERACHY_UMHG74CO
 #define GRAPH_HIERACHY_UMHG74CO
 
+#include <memory>
 #include <stack>
+#include <string>
 
 #include "graph_access.h"
+#include "hierarchy_arena.h"
 #include "uncoarsening/refinement/quotient_graph_refinement/partial_boundary.h"
 
 class graph_hierarchy {
@@ -34,9 +37,22 @@ public:
         virtual ~graph_hierarchy();
 
         void push_back(graph_access * G, CoarseMapping * coarse_mapping);
+
+        // levels pushed with a coarse mapping are written to a scratch file in directory and their arrays
+        // are freed. they are read back when they are popped. the input graph of the first push_back is
+        // owned by the caller and is never spilled. has to be called before the first push_back
+        void spill_to(const std::string & directory);
+
+        // reserves memory in the arena of the hierarchy for the next coarser graph G, which is then
+        // contracted directly into it. finish_level returns the part that the contraction did not use
+        void reserve_level(graph_access * G, NodeID nodes, EdgeID edges);
+        void finish_level(graph_access * G);
         
         graph_access  * pop_finer_and_project();
         graph_access  * parallel_pop_finer_and_project();
+        // pops the next finer graph without projecting the partition onto it. coarser and coarse_mapping
+        // are set to the coarser graph and the mapping of the finer to the coarser nodes
+        graph_access  * pop_finer(graph_access* & coarser, CoarseMapping* & coarse_mapping);
         graph_access  * pop_finer_and_project_ns( PartialBoundary & separator );
         graph_access  * get_coarsest();
         CoarseMapping * get_mapping_of_current_finer();
@@ -44,8 +60,21 @@ public:
         bool isEmpty();
         unsigned int size();
 private:
+        // a level whose arrays are in a scratch file, the filename is empty for levels in memory
+        struct spilled_level {
+                std::string filename;
+                size_t nodes;
+                size_t edges;
+                size_t refinement_node_props;
+                size_t coarsening_edge_props;
+                size_t second_partition_index;
+                size_t mapping;
+        };
+
         //private functions
         graph_access * pop_coarsest();
+        bool spill(graph_access * G, CoarseMapping * coarse_mapping, spilled_level & level);
+        void restore(graph_access * G, CoarseMapping * coarse_mapping, spilled_level & level);
 
         std::stack<graph_access*>   m_the_graph_hierarchy;
         std::stack<CoarseMapping*>  m_the_mappings;
@@ -54,6 +83,9 @@ private:
         graph_access  * m_current_coarser_graph;
         graph_access  * m_coarsest_graph;
         CoarseMapping * m_current_coarse_mapping;
+        std::shared_ptr<hierarchy_arena> m_arena;
+        std::string m_spill_directory;
+        std::stack<spilled_level> m_spilled;
 };
 
 
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "data_structure/graph_access.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Stack of levels in a few large chunks for the graphs of a graph_hierarchy. Every level is handed
+// out as a region for graph_array::reserve, the contraction builds the coarser graph directly in it.
+// The memory of a level is reused once its region and the regions of all levels above it are released,
+// so the levels may be released in any order. Chunks above the top level are freed right away, the
+// arena itself lives as long as any of its regions.
+class hierarchy_arena : public std::enable_shared_from_this<hierarchy_arena> {
+public:
+        static std::shared_ptr<hierarchy_arena> create(size_t chunk_size = 64 * 1024 * 1024) {
+                return std::shared_ptr<hierarchy_arena>(new hierarchy_arena(chunk_size));
+        }
+
+        ~hierarchy_arena() {
+                for (chunk& c : m_chunks) {
+                        ::operator delete(c.data);
+                }
+        }
+
+        hierarchy_arena(const hierarchy_arena&) = delete;
+        hierarchy_arena& operator=(const hierarchy_arena&) = delete;
+
+        // opens a new level on top of the stack for a graph with at most nodes nodes and edges edges.
+        // the nodes, edges and partition indices of G grow in place into the level while G is constructed.
+        void reserve(graph_access& G, NodeID nodes, EdgeID edges) {
+                basicGraph& graph = *G.graphref;
+                std::shared_ptr<void> region = open_level();
+                Node* node_data = nullptr;
+                refinementNode* props_data = nullptr;
+                Edge* edge_data = nullptr;
+                {
+                        std::lock_guard<std::mutex> guard(m_mutex);
+                        node_data  = allocate<Node>(nodes + 1);
+                        props_data = allocate<refinementNode>(nodes + 1);
+                        // last, so that shrink_to_fit can return the edges the construction did not use
+                        edge_data  = allocate<Edge>(edges);
+                }
+                // reserve releases a previous region of the arrays, which may belong to this arena,
+                // so the mutex is not held here.
+                graph.m_nodes.reserve(node_data, nodes + 1, region);
+                graph.m_refinement_node_props.reserve(props_data, nodes + 1, region);
+                graph.m_edges.reserve(edge_data, edges, region);
+        }
+
+        // returns the part of the top level behind the edges of G to the arena
+        void shrink_to_fit(graph_access& G) {
+                graph_array<Edge>& edges = G.graphref->m_edges;
+                std::lock_guard<std::mutex> guard(m_mutex);
+                if (m_chunks.empty() || !edges.is_mapped()) {
+                        return;
+                }
+                chunk& c = m_chunks[m_current];
+                char* begin = reinterpret_cast<char*>(edges.begin());
+                if (begin < c.data || begin >= c.data + c.used) {
+                        // the edges outgrew the level and were copied into owned storage
+                        return;
+                }
+                c.used = align(reinterpret_cast<char*>(edges.end()) - c.data);
+        }
+
+private:
+        struct chunk {
+                char* data;
+                size_t size;
+                size_t used;
+        };
+
+        // position of the first byte of a level
+        struct level {
+                size_t chunk;
+                size_t offset;
+                bool released;
+        };
+
+        explicit hierarchy_arena(size_t chunk_size)
+                :       m_chunk_size(chunk_size)
+                ,       m_current(0)
+        {}
+
+        const size_t m_chunk_size;
+        std::mutex m_mutex;
+        std::vector<chunk> m_chunks;
+        size_t m_current;
+        std::vector<level> m_levels;
+
+        std::shared_ptr<void> open_level() {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                const size_t id = m_levels.size();
+                size_t offset = m_chunks.empty() ? 0 : m_chunks[m_current].used;
+                m_levels.push_back({m_current, offset, false});
+                // the region keeps the arena alive until the last graph of the hierarchy is gone. graph_array
+                // takes a null region for owned storage, so the region points to the arena.
+                std::shared_ptr<hierarchy_arena> self = shared_from_this();
+                return std::shared_ptr<void>(static_cast<void*>(this), [self, id](void*) {
+                        self->release(id);
+                });
+        }
+
+        void release(size_t id) {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                m_levels[id].released = true;
+                while (!m_levels.empty() && m_levels.back().released) {
+                        const level& top = m_levels.back();
+                        for (size_t i = top.chunk + 1; i < m_chunks.size(); ++i) {
+                                m_chunks[i].used = 0;
+                        }
+                        if (top.chunk < m_chunks.size()) {
+                                m_chunks[top.chunk].used = top.offset;
+                        }
+                        m_current = top.chunk;
+                        m_levels.pop_back();
+                }
+                // the chunks above the top level are empty, uncoarsening returns them level by level
+                while (!m_chunks.empty() && m_chunks.back().used == 0
+                       && (m_chunks.size() > m_current + 1 || m_levels.empty())) {
+                        ::operator delete(m_chunks.back().data);
+                        m_chunks.pop_back();
+                }
+                if (m_chunks.empty()) {
+                        m_current = 0;
+                }
+        }
+
+        static size_t align(size_t bytes) {
+                constexpr size_t alignment = 64;
+                return (bytes + alignment - 1) / alignment * alignment;
+        }
+
+        void* allocate(size_t bytes) {
+                bytes = align(bytes);
+                if (m_chunks.empty() || m_chunks[m_current].used + bytes > m_chunks[m_current].size) {
+                        if (!m_chunks.empty()) {
+                                ++m_current;
+                        }
+                        // chunks above the current one are unused, a too small one is replaced
+                        size_t size = std::max(m_chunk_size, bytes);
+                        if (m_current == m_chunks.size()) {
+                                m_chunks.push_back({static_cast<char*>(::operator new(size)), size, 0});
+                        } else if (m_chunks[m_current].size < bytes) {
+                                ::operator delete(m_chunks[m_current].data);
+                                m_chunks[m_current] = {static_cast<char*>(::operator new(size)), size, 0};
+                        }
+                }
+                chunk& c = m_chunks[m_current];
+                void* result = c.data + c.used;
+                c.used += bytes;
+                return result;
+        }
+
+        template <typename T>
+        T* allocate(size_t elements) {
+                return static_cast<T*>(allocate(std::max<size_t>(elements, 1) * sizeof(T)));
+        }
+};
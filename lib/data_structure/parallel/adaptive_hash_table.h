@@ -43,7 +43,7 @@ public:
 
         explicit AdaptiveHashMap(const uint64_t max_size, const uint8_t max_key_bits_num) :
                 _empty_element(std::numeric_limits<Key>::max()),
-                _max_size(std::max(round_up_to_next_power_2(max_size), 16u)),
+                _max_size(std::max<uint64_t>(round_up_to_next_power_2(max_size), 16)),
                 _ht_size(_max_size * SizeFactor),
                 _ht(_ht_size, std::make_pair(_empty_element, Value())),
                 _poses(),
@@ -212,7 +212,7 @@ public:
 private:
         explicit AdaptiveHashMap(const uint64_t max_size, const uint8_t max_key_bits_num, const strategy_type strategy) :
                 _empty_element(std::numeric_limits<Key>::max()),
-                _max_size(std::max(round_up_to_next_power_2(max_size), 16u)),
+                _max_size(std::max<uint64_t>(round_up_to_next_power_2(max_size), 16)),
                 _ht_size(_max_size * SizeFactor),
                 _ht(_ht_size, std::make_pair(_empty_element, Value())),
                 _poses(),
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "data_structure/parallel/atomics.h"
 #include "data_structure/parallel/cache.h"
 #include "data_structure/parallel/metaprogramming_utils.h"
 #include "data_structure/parallel/thread_pool.h"
@@ -397,6 +398,32 @@ void partial_sum_open_interval(InputIterator begin, InputIterator end, OutputIte
         });
 }
 
+// maps the cluster ids in use to 0, 1, ... keeping their order and returns the number of clusters.
+// cluster ids are smaller than cluster_id.size().
+template <typename ClusterIds>
+typename ClusterIds::value_type remap_cluster_ids(ClusterIds& cluster_id, uint32_t num_threads) {
+        using id_type = typename ClusterIds::value_type;
+        if (cluster_id.empty()) {
+                return 0;
+        }
+
+        ParallelVector<AtomicWrapper<id_type>> cluster_map(cluster_id.size());
+        parallel::parallel_for_index(size_t(0), cluster_id.size(), [&](size_t index) {
+                cluster_map[index] = 0;
+        });
+
+        parallel::parallel_for_index(size_t(0), cluster_id.size(), [&](size_t index) {
+                cluster_map[cluster_id[index]].store(1, std::memory_order_relaxed);
+        });
+
+        partial_sum(cluster_map.begin(), cluster_map.end(), cluster_map.begin(), num_threads);
+
+        parallel::parallel_for_index(size_t(0), cluster_id.size(), [&](size_t index) {
+                cluster_id[index] = cluster_map[cluster_id[index]].load(std::memory_order_relaxed) - 1;
+        });
+        return cluster_map.back().load(std::memory_order_relaxed);
+}
+
 template <typename Iterator, typename Functor>
 void sort(Iterator begin, Iterator end, Functor functor, uint32_t num_threads) {
         ALWAYS_ASSERT(num_threads > 0);
@@ -22,23 +22,25 @@ inline static uint8_t bits_number(size_t num) {
         return most_significant_bit_index(num) + 1;
 }
 
-constexpr static uint32_t round_up_to_next_power_2(uint32_t v) {
+constexpr static uint64_t round_up_to_next_power_2(uint64_t v) {
         v--;
         v |= v >> 1;
         v |= v >> 2;
         v |= v >> 4;
         v |= v >> 8;
         v |= v >> 16;
+        v |= v >> 32;
         v++;
         return v;
 }
 
-constexpr static uint32_t round_up_to_previous_power_2(uint32_t x) {
+constexpr static uint64_t round_up_to_previous_power_2(uint64_t x) {
         x = x | (x >> 1);
         x = x | (x >> 2);
         x = x | (x >> 4);
         x = x | (x >> 8);
         x = x | (x >> 16);
+        x = x | (x >> 32);
         return x - (x >> 1);
 }
 
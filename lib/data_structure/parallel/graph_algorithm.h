@@ -1,7 +1,7 @@
 #include "data_structure/parallel/algorithm.h"
 #include "data_structure/graph_access.h"
 #include "data_structure/parallel/thread_pool.h"
-#include "data_structure/parallel/time.h"
+#include "tools/instrumentation.h"
 
 #include <tbb/concurrent_queue.h>
 
@@ -69,32 +69,33 @@ public:
         {}
 
         void construct() {
-                CLOCK_START;
-                parallel::submit_for_all([&, this] (uint32_t thread_id) {
-                        if (thread_id % m_threads_per_socket == 0) {
-                                m_edges[get_socket_id(thread_id)] = reinterpret_cast<EdgeID*>(::operator new(sizeof(EdgeID) * m_G.number_of_edges()));
-                        }
-                });
-                CLOCK_END("Allocate mem");
+                {
+                        SCOPED_TIMER("allocate");
+                        parallel::submit_for_all([&, this] (uint32_t thread_id) {
+                                if (thread_id % m_threads_per_socket == 0) {
+                                        m_edges[get_socket_id(thread_id)] = reinterpret_cast<EdgeID*>(::operator new(sizeof(EdgeID) * m_G.number_of_edges()));
+                                }
+                        });
+                }
 
-                CLOCK_START_N;
-                Cvector<std::atomic<uint32_t>> offsets_edges(m_num_sockets);
+                SCOPED_TIMER("copy_graph");
+                Cvector<std::atomic<EdgeID>> offsets_edges(m_num_sockets);
                 parallel::submit_for_all([&, this] (uint32_t thread_id) {
                         auto* edges = m_edges[get_socket_id(thread_id)];
-                        uint32_t block_size = (uint32_t) sqrt(m_G.number_of_edges());
-                        block_size = std::max(block_size, 1000u);
+                        EdgeID block_size = (EdgeID) sqrt(m_G.number_of_edges());
+                        block_size = std::max<EdgeID>(block_size, 1000);
                         auto& offset_edge = offsets_edges[get_socket_id(thread_id)].get();
 
                         while (true) {
-                                uint32_t begin = offset_edge.fetch_add(block_size, std::memory_order_relaxed);
-                                uint32_t end = begin + block_size;
+                                EdgeID begin = offset_edge.fetch_add(block_size, std::memory_order_relaxed);
+                                EdgeID end = begin + block_size;
                                 end = end <= m_G.number_of_edges() ? end : m_G.number_of_edges();
 
                                 if (begin >= m_G.number_of_edges()) {
                                         break;
                                 }
 
-                                for (NodeID e = begin; e != end; ++e) {
+                                for (EdgeID e = begin; e != end; ++e) {
                                         edges[e] = m_G.graphref->m_edges[e].target;
                                 }
                         }
@@ -103,7 +104,6 @@ public:
                 for (size_t socket_id = 0; socket_id < m_num_sockets; ++socket_id) {
                         handles.push_back(numa_aware_graph_handle(m_G, m_edges[socket_id]));
                 }
-                CLOCK_END("Copy graph");
         }
 
         inline handle_type& get_handle(uint32_t thread_id) {
@@ -112,13 +112,12 @@ public:
         }
 
         ~numa_aware_graph() {
-                CLOCK_START;
+                SCOPED_TIMER("free");
                 parallel::submit_for_all([&, this] (uint32_t thread_id) {
                         if (thread_id % m_threads_per_socket == 0) {
                                 ::operator delete(m_edges[get_socket_id(thread_id)]);
                         }
                 });
-                CLOCK_END("Delete mem");
         }
 private:
         graph_access& m_G;
@@ -140,43 +139,44 @@ void parallel_for_each_node(TGraph& G, TFunctor&& functor) {
 
         const size_t edge_block_size = std::max((size_t) sqrt(G.number_of_edges()), 1000ul);
 
-        CLOCK_START;
-        std::atomic<size_t> offset(0);
-        size_t node_block_size = (size_t) sqrt(G.number_of_nodes());
-        node_block_size = std::max(node_block_size, 1000ul);
-        parallel::submit_for_all([&](uint32_t) {
-                block_type block;
-                block.reserve(100);
-                size_t cur_block_size = 0;
-                while (true) {
-                        size_t begin = offset.fetch_add(node_block_size, std::memory_order_relaxed);
-                        size_t end = begin + node_block_size;
-                        end = end <= G.number_of_nodes() ? end : G.number_of_nodes();
-
-                        if (begin >= G.number_of_nodes()) {
-                                break;
-                        }
+        {
+                SCOPED_TIMER("init_queue");
+                std::atomic<size_t> offset(0);
+                size_t node_block_size = (size_t) sqrt(G.number_of_nodes());
+                node_block_size = std::max(node_block_size, 1000ul);
+                parallel::submit_for_all([&](uint32_t) {
+                        block_type block;
+                        block.reserve(100);
+                        size_t cur_block_size = 0;
+                        while (true) {
+                                size_t begin = offset.fetch_add(node_block_size, std::memory_order_relaxed);
+                                size_t end = begin + node_block_size;
+                                end = end <= G.number_of_nodes() ? end : G.number_of_nodes();
 
-                        for (NodeID node = begin; node != end; ++node) {
-                                block.push_back(node);
-                                auto node_degree = G.getNodeDegree(node);
-                                cur_block_size += node_degree > 0 ? node_degree : 1;
-                                if (cur_block_size >= edge_block_size) {
-                                        // block is full
-                                        queue.push(std::move(block));
-                                        block.clear();
-                                        block.reserve(100);
-                                        cur_block_size = 0;
+                                if (begin >= G.number_of_nodes()) {
+                                        break;
+                                }
+
+                                for (NodeID node = begin; node != end; ++node) {
+                                        block.push_back(node);
+                                        auto node_degree = G.getNodeDegree(node);
+                                        cur_block_size += node_degree > 0 ? node_degree : 1;
+                                        if (cur_block_size >= edge_block_size) {
+                                                // block is full
+                                                queue.push(std::move(block));
+                                                block.clear();
+                                                block.reserve(100);
+                                                cur_block_size = 0;
+                                        }
                                 }
                         }
-                }
-                if (!block.empty()) {
-                        queue.push(std::move(block));
-                }
-        });
-        CLOCK_END("Init queue");
+                        if (!block.empty()) {
+                                queue.push(std::move(block));
+                        }
+                });
+        }
 
-        CLOCK_START_N;
+        SCOPED_TIMER("process_graph");
         parallel::submit_for_all([&](uint32_t id) {
                 block_type cur_block;
 
@@ -186,7 +186,6 @@ void parallel_for_each_node(TGraph& G, TFunctor&& functor) {
                         }
                 }
         });
-        CLOCK_END("Process graph");
 }
 
 }
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "data_structure/graph_access.h"
+#include "data_structure/parallel/algorithm.h"
+#include "data_structure/parallel/atomics.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace parallel {
+
+// Parallel counterpart of graph_access::new_node/new_edge. A graph is built in four phases:
+//   1. the degree of every node is set with set_degree or accumulated with add_degree (any thread),
+//   2. compute_offsets turns the degrees into the node array with a parallel prefix sum,
+//   3. the threads fill the edges of a node either densely from first_edge(node) on or
+//      scattered with claim_edge(node),
+//   4. finish completes the graph, optionally after sort_edges.
+// The nodes and edges are written directly into the arrays of the graph, so they grow in place into
+// memory that was reserved for the graph (see hierarchy_arena). Node weights can be set in any phase before finish.
+// compute_offsets resizes the thread pool and therefore has to be called from the main thread. Builders
+// of several graphs should compute their offsets together with the static compute_offsets.
+class graph_builder {
+public:
+        graph_builder(graph_access& G, NodeID num_nodes, uint32_t num_threads)
+                :       m_graph(*G.graphref)
+                ,       m_num_threads(num_threads)
+                ,       m_num_edges(0)
+                ,       m_offsets(num_nodes)
+                ,       m_nodes(m_graph.m_nodes)
+                ,       m_edges(m_graph.m_edges)
+        {
+                m_nodes.resize(num_nodes + 1);
+        }
+
+        inline NodeID number_of_nodes() const {
+                return m_offsets.size();
+        }
+
+        inline EdgeID number_of_edges() const {
+                return m_num_edges;
+        }
+
+        inline void set_degree(NodeID node, EdgeID degree) {
+                m_offsets[node].store(degree, std::memory_order_relaxed);
+        }
+
+        inline void add_degree(NodeID node, EdgeID degree = 1) {
+                m_offsets[node].fetch_add(degree, std::memory_order_relaxed);
+        }
+
+        EdgeID compute_offsets() {
+                if (m_offsets.empty()) {
+                        m_nodes[0].firstEdge = 0;
+                        return 0;
+                }
+
+                EdgeID last_node_degree = m_offsets.back();
+                parallel::partial_sum_open_interval(m_offsets.begin(), m_offsets.end(), m_offsets.begin(),
+                                                    m_num_threads);
+                m_num_edges = m_offsets.back() + last_node_degree;
+
+                parallel::parallel_for_index(NodeID(0), number_of_nodes(), [this](NodeID node) {
+                        m_nodes[node].firstEdge = m_offsets[node].load(std::memory_order_relaxed);
+                });
+                m_nodes[number_of_nodes()].firstEdge = m_num_edges;
+                m_edges.resize(m_num_edges);
+                return m_num_edges;
+        }
+
+        // compute_offsets of several builders with one prefix sum over their concatenated degrees, so the
+        // thread pool is resized once and not once per builder
+        static void compute_offsets(const std::vector<graph_builder*>& builders, uint32_t num_threads) {
+                std::vector<size_t> first_node(builders.size() + 1, 0);
+                for (size_t i = 0; i < builders.size(); ++i) {
+                        first_node[i + 1] = first_node[i] + builders[i]->number_of_nodes();
+                }
+                const size_t total_nodes = first_node.back();
+
+                std::vector<EdgeID> offsets(total_nodes);
+                for (size_t i = 0; i < builders.size(); ++i) {
+                        graph_builder& builder = *builders[i];
+                        parallel::parallel_for_index(NodeID(0), builder.number_of_nodes(), [&](NodeID node) {
+                                offsets[first_node[i] + node] = builder.m_offsets[node].load(std::memory_order_relaxed);
+                        });
+                }
+
+                EdgeID total_edges = 0;
+                if (total_nodes > 0) {
+                        EdgeID last_node_degree = offsets.back();
+                        parallel::partial_sum_open_interval(offsets.begin(), offsets.end(), offsets.begin(), num_threads);
+                        total_edges = offsets.back() + last_node_degree;
+                }
+
+                for (size_t i = 0; i < builders.size(); ++i) {
+                        graph_builder& builder = *builders[i];
+                        const EdgeID first_edge = first_node[i] < total_nodes ? offsets[first_node[i]] : total_edges;
+                        const EdgeID end_edge = first_node[i + 1] < total_nodes ? offsets[first_node[i + 1]] : total_edges;
+
+                        parallel::parallel_for_index(NodeID(0), builder.number_of_nodes(), [&](NodeID node) {
+                                EdgeID offset = offsets[first_node[i] + node] - first_edge;
+                                builder.m_offsets[node].store(offset, std::memory_order_relaxed);
+                                builder.m_nodes[node].firstEdge = offset;
+                        });
+                        builder.m_num_edges = end_edge - first_edge;
+                        builder.m_nodes[builder.number_of_nodes()].firstEdge = builder.m_num_edges;
+                        builder.m_edges.resize(builder.m_num_edges);
+                }
+        }
+
+        inline EdgeID first_edge(NodeID node) const {
+                return m_nodes[node].firstEdge;
+        }
+
+        // returns the next free edge slot of node, may be called concurrently for the same node
+        inline EdgeID claim_edge(NodeID node) {
+                return m_offsets[node].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline void set_edge(EdgeID e, NodeID target, EdgeWeight weight) {
+                m_edges[e].target = target;
+                m_edges[e].weight = weight;
+        }
+
+        inline void set_node_weight(NodeID node, NodeWeight weight) {
+                m_nodes[node].weight = weight;
+        }
+
+        // orders the edges of every node by target, the order of claim_edge depends on the thread schedule
+        void sort_edges() {
+                parallel::parallel_for_index(NodeID(0), number_of_nodes(), [this](NodeID node) {
+                        std::sort(m_edges.begin() + m_nodes[node].firstEdge, m_edges.begin() + m_nodes[node + 1].firstEdge,
+                                  [](const Edge& lhs, const Edge& rhs) {
+                                          return lhs.target < rhs.target;
+                                  });
+                });
+        }
+
+        void finish() {
+                m_graph.m_refinement_node_props.resize(m_nodes.size());
+                m_graph.m_coarsening_edge_props.resize(m_edges.size());
+        }
+
+private:
+        basicGraph& m_graph;
+        const uint32_t m_num_threads;
+        EdgeID m_num_edges;
+        // degrees before compute_offsets, insertion positions for claim_edge afterwards
+        std::vector<AtomicWrapper<EdgeID>> m_offsets;
+        graph_array<Node>& m_nodes;
+        graph_array<Edge>& m_edges;
+};
+
+}
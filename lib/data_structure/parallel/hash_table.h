@@ -18,6 +18,14 @@
 #include "tools/macros_assertions.h"
 
 namespace parallel {
+// slots of the tables are addressed with hash_table_position, in the 64 bit build a table may hold more than 2^32
+// elements
+#ifdef MODE_64BIT_NODEIDS
+using hash_table_position = uint64_t;
+#else
+using hash_table_position = uint32_t;
+#endif
+
 template <typename hash_table_type>
 static constexpr size_t get_max_size_to_fit_l1() {
         // (SizeFactor + 1.1) * max_size * sizeof(Element) Bytes = 16 * 1024 Bytes,
@@ -116,7 +124,7 @@ public:
         using mapped_type = Value;
         using hash_type = typename Hash::hash_type;
         using hash_function_type = Hash;
-        using Position = uint32_t;
+        using Position = hash_table_position;
 
 private:
         using TSelf = HashMap<Key, Value, Hash, TGrowable, SizeFactor>;
@@ -138,7 +146,7 @@ public:
 
         explicit HashMap(const uint64_t max_size = 1) :
                 _empty_element(std::numeric_limits<Key>::max()),
-                _max_size(std::max(round_up_to_next_power_2(max_size), 16u)),
+                _max_size(std::max<uint64_t>(round_up_to_next_power_2(max_size), 16)),
                 _ht_size(_max_size * SizeFactor),
                 //_ht(_ht_size + _max_size * 1.1, std::make_pair(_empty_element, Value())),
                 _ht(_ht_size + 301, std::make_pair(_empty_element, Value())),
@@ -424,7 +432,7 @@ public:
 
 private:
         using TSelf = HashMapWithErase<Key, Value, Hash, TGrowable, Cache, SizeFactor>;
-        using Position = uint32_t;
+        using Position = hash_table_position;
 
 public:
         using Iterator = HashTableWithEraseIterator<TSelf>;
@@ -434,7 +442,7 @@ public:
         explicit HashMapWithErase(const uint64_t max_size = 1) :
                 _empty_element(std::numeric_limits<Key>::max()),
                 _deleted_element(_empty_element - 1),
-                _max_size(std::max(round_up_to_next_power_2(max_size), 16u)),
+                _max_size(std::max<uint64_t>(round_up_to_next_power_2(max_size), 16)),
                 _ht_size(max_size * SizeFactor),
                 _size(0),
                 _ht(_ht_size + _max_size * 1.1, std::make_pair(_empty_element, Value())),
@@ -626,7 +634,7 @@ public:
         using hash_type = typename Hash::hash_type;
 private:
         using TSelf = HashSet<Key, Hash, TGrowable, Cache, SizeFactor>;
-        using Position = uint32_t;
+        using Position = hash_table_position;
 
         static constexpr hash_type max_hash_value = std::numeric_limits<hash_type>::max();
 public:
@@ -638,7 +646,7 @@ public:
 
         explicit HashSet(const uint64_t max_size = 1) :
                 _empty_element(std::numeric_limits<Key>::max()),
-                _max_size(std::max(round_up_to_next_power_2(max_size), 16u)),
+                _max_size(std::max<uint64_t>(round_up_to_next_power_2(max_size), 16)),
                 _ht_size(_max_size * SizeFactor),
                 _ht(_ht_size + _max_size * 1.1, _empty_element),
                 _poses(),
@@ -674,7 +682,7 @@ public:
                 return *this;
         }
 
-        void reserve(const uint32_t max_size) {
+        void reserve(const uint64_t max_size) {
                 _ht_size = max_size * SizeFactor;
                 _max_size = max_size;
                 _ht.resize(_ht_size + _max_size * 1.1, _empty_element);
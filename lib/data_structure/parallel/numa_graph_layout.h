@@ -0,0 +1,234 @@
+#pragma once
+
+#include "data_structure/graph_access.h"
+#include "data_structure/parallel/algorithm.h"
+#include "data_structure/parallel/thread_pool.h"
+#include "tools/instrumentation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#ifdef __gnu_linux__
+#include <numa.h>
+#include <numaif.h>
+#endif
+
+namespace parallel {
+
+// Splits the nodes of a graph into one contiguous range per thread such that every range has about
+// the same number of nodes plus edges. The threads of a socket own consecutive ranges, so every
+// socket owns a contiguous part of the node and edge arrays. Thread thread_id is expected to run on
+// core thread_id as arranged by g_thread_pool.
+class numa_graph_layout {
+public:
+        numa_graph_layout(graph_access& G, uint32_t num_threads, uint32_t threads_per_socket)
+                :       m_threads_per_socket(threads_per_socket)
+                ,       m_range_begin(num_threads + 1)
+        {
+                const NodeID num_nodes = G.number_of_nodes();
+                const uint64_t total_work = (uint64_t) num_nodes + G.number_of_edges();
+
+                // work before node is node + first_edge(node) which grows with node, so binary search works
+                m_range_begin[0] = 0;
+                for (uint32_t thread_id = 1; thread_id < num_threads; ++thread_id) {
+                        uint64_t work = total_work * thread_id / num_threads;
+                        NodeID lo = m_range_begin[thread_id - 1];
+                        NodeID hi = num_nodes;
+                        while (lo < hi) {
+                                NodeID mid = lo + (hi - lo) / 2;
+                                if ((uint64_t) mid + G.get_first_edge(mid) < work) {
+                                        lo = mid + 1;
+                                } else {
+                                        hi = mid;
+                                }
+                        }
+                        m_range_begin[thread_id] = lo;
+                }
+                m_range_begin[num_threads] = num_nodes;
+        }
+
+        inline uint32_t num_threads() const {
+                return m_range_begin.size() - 1;
+        }
+
+        inline NodeID range_begin(uint32_t thread_id) const {
+                return m_range_begin[thread_id];
+        }
+
+        inline NodeID range_end(uint32_t thread_id) const {
+                return m_range_begin[thread_id + 1];
+        }
+
+        inline const std::vector<NodeID>& ranges() const {
+                return m_range_begin;
+        }
+
+        inline uint32_t get_socket_id(uint32_t thread_id) const {
+                return thread_id / m_threads_per_socket;
+        }
+
+        inline uint32_t threads_per_socket() const {
+                return m_threads_per_socket;
+        }
+
+        // thread whose range contains node
+        inline uint32_t owner(NodeID node) const {
+                return std::upper_bound(m_range_begin.begin(), m_range_begin.end() - 1, node) - m_range_begin.begin() - 1;
+        }
+
+        // Moves nodes, edges and partition indices of G to freshly allocated memory. Every thread of
+        // g_thread_pool touches its own range first with local allocation, so the pages end up on the
+        // socket of the thread. The memory policy of every thread, including the calling one, is restored
+        // afterwards. Has to be called from the main thread with num_threads() threads in the pool.
+        void place(graph_access& G) const {
+                ALWAYS_ASSERT(g_thread_pool.NumThreads() + 1 == num_threads());
+                basicGraph& graph = *G.graphref;
+                const NodeID num_nodes = G.number_of_nodes();
+                const EdgeID num_edges = G.number_of_edges();
+
+                SCOPED_TIMER("place_graph_on_sockets");
+                Node* nodes = allocate<Node>(num_nodes + 1);
+                Edge* edges = allocate<Edge>(num_edges);
+                refinementNode* props = allocate<refinementNode>(num_nodes + 1);
+
+                submit_for_all([&](uint32_t thread_id) {
+#ifdef __gnu_linux__
+                        local_allocation_scope local_allocation;
+#endif
+                        NodeID begin = range_begin(thread_id);
+                        NodeID end = range_end(thread_id);
+                        // the sentinel node belongs to the last range
+                        NodeID nodes_end = thread_id + 1 == num_threads() ? end + 1 : end;
+                        std::copy(graph.m_nodes.begin() + begin, graph.m_nodes.begin() + nodes_end, nodes + begin);
+                        std::copy(graph.m_refinement_node_props.begin() + begin,
+                                  graph.m_refinement_node_props.begin() + nodes_end, props + begin);
+
+                        EdgeID first_edge = graph.m_nodes[begin].firstEdge;
+                        EdgeID last_edge = graph.m_nodes[end].firstEdge;
+                        std::copy(graph.m_edges.begin() + first_edge, graph.m_edges.begin() + last_edge,
+                                  edges + first_edge);
+                });
+
+                graph.m_nodes.map(nodes, num_nodes + 1, region(nodes));
+                graph.m_edges.map(edges, num_edges, region(edges));
+                graph.m_refinement_node_props.map(props, num_nodes + 1, region(props));
+        }
+
+private:
+        const uint32_t m_threads_per_socket;
+        std::vector<NodeID> m_range_begin;
+
+#ifdef __gnu_linux__
+        // switches the calling thread to local allocation and restores its memory policy on destruction
+        class local_allocation_scope {
+        public:
+                local_allocation_scope()
+                        :       m_saved(numa_available() >= 0)
+                        ,       m_mode(MPOL_DEFAULT)
+                        ,       m_max_node(0)
+                {
+                        if (!m_saved) {
+                                return;
+                        }
+                        m_max_node = numa_max_possible_node() + 1;
+                        m_node_mask.resize((m_max_node + 8 * sizeof(unsigned long) - 1) / (8 * sizeof(unsigned long)));
+                        m_saved = get_mempolicy(&m_mode, m_node_mask.data(), m_max_node, nullptr, 0) == 0;
+                        numa_set_localalloc();
+                }
+
+                ~local_allocation_scope() {
+                        if (m_saved) {
+                                set_mempolicy(m_mode, m_node_mask.data(), m_max_node);
+                        }
+                }
+
+                local_allocation_scope(const local_allocation_scope&) = delete;
+                local_allocation_scope& operator=(const local_allocation_scope&) = delete;
+
+        private:
+                bool m_saved;
+                int m_mode;
+                unsigned long m_max_node;
+                std::vector<unsigned long> m_node_mask;
+        };
+#endif
+
+        // memory is not touched here, so first touch decides its placement
+        template <typename T>
+        static T* allocate(size_t size) {
+                return reinterpret_cast<T*>(::operator new(sizeof(T) * std::max<size_t>(size, 1)));
+        }
+
+        static std::shared_ptr<void> region(void* data) {
+                return std::shared_ptr<void>(data, [](void* ptr) { ::operator delete(ptr); });
+        }
+};
+
+// Hands out chunks of per thread segments [segments[i], segments[i + 1]) of an index range. A thread
+// processes its own segment first, then helps the other threads of its socket and only then the
+// threads of other sockets. With the ranges of a numa_graph_layout as segments, threads mostly work
+// on nodes whose memory is on their socket.
+class local_first_scheduler {
+public:
+        local_first_scheduler(const std::vector<NodeID>& segments, uint32_t threads_per_socket, size_t chunk_size)
+                :       m_segments(segments.begin(), segments.end())
+                ,       m_threads_per_socket(threads_per_socket)
+                ,       m_chunk_size(std::max<size_t>(chunk_size, 1))
+                ,       m_offsets(segments.size() - 1)
+        {
+                reset();
+        }
+
+        // makes all indices available again, must not run concurrently with next_chunk
+        void reset() {
+                for (size_t segment = 0; segment < m_offsets.size(); ++segment) {
+                        m_offsets[segment].get().store(m_segments[segment], std::memory_order_relaxed);
+                }
+        }
+
+        // returns false if no indices are left
+        bool next_chunk(uint32_t thread_id, size_t& begin, size_t& end) {
+                const uint32_t num_segments = m_offsets.size();
+                const uint32_t socket_begin = thread_id / m_threads_per_socket * m_threads_per_socket;
+                const uint32_t socket_end = std::min(socket_begin + m_threads_per_socket, num_segments);
+
+                // own segment, rest of the socket, other sockets
+                for (uint32_t i = 0; i < socket_end - socket_begin; ++i) {
+                        uint32_t segment = socket_begin + (thread_id - socket_begin + i) % (socket_end - socket_begin);
+                        if (try_take(segment, begin, end)) {
+                                return true;
+                        }
+                }
+                for (uint32_t i = 0; i < num_segments; ++i) {
+                        uint32_t segment = (socket_end + i) % num_segments;
+                        if ((segment < socket_begin || segment >= socket_end) && try_take(segment, begin, end)) {
+                                return true;
+                        }
+                }
+                return false;
+        }
+
+private:
+        std::vector<size_t> m_segments;
+        const uint32_t m_threads_per_socket;
+        const size_t m_chunk_size;
+        Cvector<std::atomic<size_t>> m_offsets;
+
+        inline bool try_take(uint32_t segment, size_t& begin, size_t& end) {
+                auto& offset = m_offsets[segment].get();
+                const size_t segment_end = m_segments[segment + 1];
+                if (offset.load(std::memory_order_relaxed) >= segment_end) {
+                        return false;
+                }
+                begin = offset.fetch_add(m_chunk_size, std::memory_order_relaxed);
+                if (begin >= segment_end) {
+                        return false;
+                }
+                end = std::min(begin + m_chunk_size, segment_end);
+                return true;
+        }
+};
+
+}
@@ -1,5 +1,7 @@
 #include "data_structure/parallel/thread_pool.h"
+#include "data_structure/parallel/work_stealing_pool.h"
 
 namespace parallel {
 TThreadPoolWithTaskQueuePerThread g_thread_pool(0);
+TWorkStealingThreadPool g_work_stealing_pool(0);
 }
\ No newline at end of file
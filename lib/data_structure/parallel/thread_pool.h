@@ -3,6 +3,7 @@
 #include "data_structure/parallel/cache.h"
 #include "data_structure/parallel/metaprogramming_utils.h"
 #include "data_structure/parallel/spin_lock.h"
+#include "tools/instrumentation.h"
 
 #include <algorithm>
 #include <atomic>
@@ -162,6 +163,22 @@ private:
         TFunctionWrapper& operator=(TFunctionWrapper&) = delete;
 };
 
+// the task records its timers below the timers which run on the submitting thread
+#ifndef NO_INSTRUMENTATION
+template<typename TBound>
+auto WithTimerContext(TBound&& bound) {
+        return [context = instrumentation::current_context(), bound = std::forward<TBound>(bound)]() mutable {
+                instrumentation::scoped_context scope(context);
+                return bound();
+        };
+}
+#else
+template<typename TBound>
+TBound&& WithTimerContext(TBound&& bound) {
+        return std::forward<TBound>(bound);
+}
+#endif
+
 class TThreadJoiner {
 private:
         std::vector <std::thread>& Threads;
@@ -255,8 +272,8 @@ public:
         template<typename TFunctor, typename... TArgs>
         std::future<typename std::result_of<TFunctor(TArgs...)>::type> Submit(TFunctor&& f, TArgs... args) {
                 typedef typename std::result_of<TFunctor(TArgs...)>::type TResultType;
-                std::packaged_task < TResultType() >
-                task(std::bind(std::forward<TFunctor>(f), std::forward<TArgs>(args)...));
+                std::packaged_task < TResultType() > task(
+                        WithTimerContext(std::bind(std::forward<TFunctor>(f), std::forward<TArgs>(args)...)));
                 std::future <TResultType> res(task.get_future());
 
                 TaskQueue.Push(std::move(task));
@@ -271,8 +288,8 @@ public:
                 std::vector <std::future<TResultType>> futures;
                 futures.reserve(NumThreads());
                 for (size_t i = 0; i < NumThreads(); ++i) {
-                        std::packaged_task < TResultType() > task(std::bind(std::forward<TFunctor>(f),
-                                                                            std::forward<TArgs>(args)...));
+                        std::packaged_task < TResultType() > task(
+                                WithTimerContext(std::bind(std::forward<TFunctor>(f), std::forward<TArgs>(args)...)));
 
                         futures.push_back(task.get_future());
                         TaskQueue.Push(std::move(task));
@@ -369,8 +386,8 @@ public:
         std::future<typename std::result_of<TFunctor(TArgs...)>::type> Submit(size_t thread_id, TFunctor&& f,
                                                                               TArgs... args) {
                 typedef typename std::result_of<TFunctor(TArgs...)>::type TResultType;
-                std::packaged_task < TResultType() >
-                        task(std::bind(std::forward<TFunctor>(f), std::forward<TArgs>(args)...));
+                std::packaged_task < TResultType() > task(
+                        WithTimerContext(std::bind(std::forward<TFunctor>(f), std::forward<TArgs>(args)...)));
                 std::future <TResultType> res(task.get_future());
 
                 Queues[thread_id].get().Push(std::move(task));
@@ -386,8 +403,8 @@ public:
                 std::vector <std::future<TResultType>> futures;
                 futures.reserve(NumThreads());
                 for (size_t i = 0; i < NumThreads(); ++i) {
-                        std::packaged_task < TResultType() > task(std::bind(std::forward<TFunctor>(f),
-                                                                            std::forward<TArgs>(args)...));
+                        std::packaged_task < TResultType() > task(
+                                WithTimerContext(std::bind(std::forward<TFunctor>(f), std::forward<TArgs>(args)...)));
 
                         futures.push_back(task.get_future());
                         Queues[thread_id].get().Push(std::move(task));
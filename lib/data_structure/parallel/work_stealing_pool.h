@@ -0,0 +1,395 @@
+#pragma once
+
+#include "data_structure/parallel/cache.h"
+#include "data_structure/parallel/metaprogramming_utils.h"
+#include "data_structure/parallel/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace parallel {
+
+// Lock-free work-stealing deque of Chase and Lev ("Dynamic Circular Work-Stealing Deque", SPAA 2005)
+// with the memory orderings of Le et al. ("Correct and Efficient Work-Stealing for Weak Memory
+// Models", PPoPP 2013). Only the owner calls Push and Pop, which work on the bottom end, any other
+// thread may Steal from the top end. T has to be trivially copyable.
+// Buffers that were replaced by a larger one may still be read by a thief and are only freed
+// together with the deque.
+template<typename T>
+class TChaseLevDeque {
+private:
+        struct TBuffer {
+                explicit TBuffer(int64_t capacity)
+                        :       Capacity(capacity)
+                        ,       Slots(std::make_unique<std::atomic<T>[]>(capacity))
+                {}
+
+                T Get(int64_t i) const {
+                        return Slots[i & (Capacity - 1)].load(std::memory_order_relaxed);
+                }
+
+                void Put(int64_t i, T value) {
+                        Slots[i & (Capacity - 1)].store(value, std::memory_order_relaxed);
+                }
+
+                TBuffer* Grow(int64_t bottom, int64_t top) const {
+                        TBuffer* buffer = new TBuffer(2 * Capacity);
+                        for (int64_t i = top; i < bottom; ++i) {
+                                buffer->Put(i, Get(i));
+                        }
+                        return buffer;
+                }
+
+                const int64_t Capacity;
+                std::unique_ptr<std::atomic<T>[]> Slots;
+        };
+
+        alignas(g_cache_line_size) std::atomic<int64_t> Top;
+        alignas(g_cache_line_size) std::atomic<int64_t> Bottom;
+        std::atomic<TBuffer*> Buffer;
+        std::vector<std::unique_ptr<TBuffer>> RetiredBuffers;
+
+public:
+        static_assert(std::is_trivially_copyable<T>::value, "TChaseLevDeque needs a trivially copyable type");
+
+        explicit TChaseLevDeque(int64_t capacity = 64)
+                :       Top(0)
+                ,       Bottom(0)
+                ,       Buffer(new TBuffer(capacity))
+        {}
+
+        TChaseLevDeque(const TChaseLevDeque&) = delete;
+
+        TChaseLevDeque& operator=(const TChaseLevDeque&) = delete;
+
+        ~TChaseLevDeque() {
+                delete Buffer.load(std::memory_order_relaxed);
+        }
+
+        void Push(T value) {
+                int64_t bottom = Bottom.load(std::memory_order_relaxed);
+                int64_t top = Top.load(std::memory_order_acquire);
+                TBuffer* buffer = Buffer.load(std::memory_order_relaxed);
+                if (bottom - top > buffer->Capacity - 1) {
+                        TBuffer* larger = buffer->Grow(bottom, top);
+                        RetiredBuffers.emplace_back(buffer);
+                        Buffer.store(larger, std::memory_order_release);
+                        buffer = larger;
+                }
+                buffer->Put(bottom, value);
+                Bottom.store(bottom + 1, std::memory_order_release);
+        }
+
+        bool Pop(T& value) {
+                int64_t bottom = Bottom.load(std::memory_order_relaxed) - 1;
+                TBuffer* buffer = Buffer.load(std::memory_order_relaxed);
+                Bottom.store(bottom, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t top = Top.load(std::memory_order_relaxed);
+
+                if (top > bottom) {
+                        // empty
+                        Bottom.store(bottom + 1, std::memory_order_relaxed);
+                        return false;
+                }
+
+                value = buffer->Get(bottom);
+                if (top < bottom) {
+                        return true;
+                }
+
+                // last element, race against the thieves
+                bool won = Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                       std::memory_order_relaxed);
+                Bottom.store(bottom + 1, std::memory_order_relaxed);
+                return won;
+        }
+
+        bool Steal(T& value) {
+                int64_t top = Top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t bottom = Bottom.load(std::memory_order_acquire);
+                if (top >= bottom) {
+                        return false;
+                }
+
+                TBuffer* buffer = Buffer.load(std::memory_order_acquire);
+                value = buffer->Get(top);
+                return Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+        }
+
+        bool Empty() const {
+                return Top.load(std::memory_order_relaxed) >= Bottom.load(std::memory_order_relaxed);
+        }
+};
+
+// Thread pool in which every worker owns a TChaseLevDeque. Tasks submitted by a worker are pushed
+// to its own deque, tasks submitted by any other thread go to a shared queue. Idle workers take
+// tasks from their own deque, then from the shared queue and finally steal from the other workers.
+// A task that waits for the result of another task has to use Wait instead of future::get. Wait
+// executes pending tasks until the result is available, so tasks can submit and wait for tasks
+// without deadlocking the pool. This also holds for a pool without worker threads.
+// In contrast to TThreadPoolWithTaskQueuePerThread a task cannot be bound to a specific thread.
+class TWorkStealingThreadPool {
+private:
+        using TTask = TFunctionWrapper;
+        using TDeque = CacheAlignedData<TChaseLevDeque<TTask*>>;
+
+        static constexpr size_t NoWorker = std::numeric_limits<size_t>::max();
+        // a worker goes to sleep after this many unsuccessful rounds over all queues
+        static constexpr uint32_t IdleRoundsBeforeSleep = 64;
+
+        struct TWorkerInfo {
+                const TWorkStealingThreadPool* Pool = nullptr;
+                size_t Index = NoWorker;
+        };
+
+        std::atomic_bool Done;
+        std::vector<std::thread> Threads;
+        TThreadJoiner ThreadJoiner;
+        // the workers must not read Threads while it is filled
+        size_t NumWorkers;
+        std::unique_ptr<TDeque[]> Deques;
+        TThreadsafeQueue<TTask*> SharedQueue;
+
+        std::mutex SleepMutex;
+        std::condition_variable WakeUp;
+        std::atomic<uint32_t> NumSleeping;
+
+        static TWorkerInfo& CurrentWorker() {
+                static thread_local TWorkerInfo info;
+                return info;
+        }
+
+        size_t CurrentIndex() const {
+                const TWorkerInfo& info = CurrentWorker();
+                return info.Pool == this ? info.Index : NoWorker;
+        }
+
+        void Enqueue(TTask* task) {
+                size_t index = CurrentIndex();
+                if (index != NoWorker) {
+                        Deques[index].get().Push(task);
+                } else {
+                        SharedQueue.Push(task);
+                }
+
+                if (NumSleeping.load(std::memory_order_acquire) > 0) {
+                        std::lock_guard<std::mutex> lock(SleepMutex);
+                        WakeUp.notify_one();
+                }
+        }
+
+        bool RunPendingTask(size_t index) {
+                TTask* task = nullptr;
+                bool found = (index != NoWorker && Deques[index].get().Pop(task)) || SharedQueue.TryPop(task);
+
+                size_t first_victim = index != NoWorker ? index + 1 : 0;
+                for (size_t i = 0; !found && i < NumWorkers; ++i) {
+                        size_t victim = (first_victim + i) % NumWorkers;
+                        found = victim != index && Deques[victim].get().Steal(task);
+                }
+
+                if (!found) {
+                        return false;
+                }
+
+                (*task)();
+                delete task;
+                return true;
+        }
+
+        void Worker(uint32_t core_id) {
+#ifdef __gnu_linux__
+                PinToCore(core_id);
+#endif
+                CurrentWorker().Pool = this;
+                CurrentWorker().Index = core_id - 1;
+
+                uint32_t idle_rounds = 0;
+                while (!Done) {
+                        if (RunPendingTask(core_id - 1)) {
+                                idle_rounds = 0;
+                                continue;
+                        }
+
+                        if (++idle_rounds < IdleRoundsBeforeSleep) {
+                                std::this_thread::yield();
+                                continue;
+                        }
+
+                        // a task pushed between the last round and the increment of NumSleeping does not
+                        // wake this thread, so it sleeps with a timeout
+                        std::unique_lock<std::mutex> lock(SleepMutex);
+                        NumSleeping.fetch_add(1, std::memory_order_acq_rel);
+                        WakeUp.wait_for(lock, std::chrono::milliseconds(1));
+                        NumSleeping.fetch_sub(1, std::memory_order_acq_rel);
+                        idle_rounds = 0;
+                }
+
+                CurrentWorker() = TWorkerInfo();
+#ifdef __gnu_linux__
+                Unpin();
+#endif
+        }
+
+        void Start(size_t threadsCount) {
+                Deques = std::make_unique<TDeque[]>(threadsCount);
+                NumWorkers = threadsCount;
+                Done = false;
+                Threads.reserve(threadsCount);
+                for (size_t i = 0; i < threadsCount; ++i) {
+                        Threads.push_back(std::thread(&TWorkStealingThreadPool::Worker, this, i + 1));
+                }
+        }
+
+public:
+        explicit TWorkStealingThreadPool(size_t threadsCount = 0)
+                :       ThreadJoiner(Threads)
+                ,       NumWorkers(0)
+                ,       NumSleeping(0)
+        {
+                try {
+                        Start(threadsCount);
+                }
+                catch (...) {
+                        Done = true;
+                        throw;
+                }
+        }
+
+        TWorkStealingThreadPool(const TWorkStealingThreadPool&) = delete;
+
+        TWorkStealingThreadPool& operator=(const TWorkStealingThreadPool&) = delete;
+
+        // must not be called while tasks are pending
+        void Resize(size_t threadsCount) {
+                Clear();
+                Start(threadsCount);
+        }
+
+        size_t NumThreads() const {
+                return NumWorkers;
+        }
+
+        void Clear() {
+                Done = true;
+                {
+                        std::lock_guard<std::mutex> lock(SleepMutex);
+                        WakeUp.notify_all();
+                }
+                ThreadJoiner.Clear();
+                Threads.clear();
+                NumWorkers = 0;
+        }
+
+        ~TWorkStealingThreadPool() {
+                Clear();
+        }
+
+        template<typename TFunctor, typename... TArgs>
+        std::future<typename std::result_of<TFunctor(TArgs...)>::type> Submit(TFunctor&& f, TArgs... args) {
+                typedef typename std::result_of<TFunctor(TArgs...)>::type TResultType;
+                std::packaged_task < TResultType() > task(
+                        WithTimerContext(std::bind(std::forward<TFunctor>(f), std::forward<TArgs>(args)...)));
+                std::future <TResultType> res(task.get_future());
+
+                Enqueue(new TTask(std::move(task)));
+
+                return res;
+        }
+
+        // executes pending tasks of the pool until the result of future is available
+        template<typename TResult>
+        TResult Wait(std::future<TResult>& future) {
+                size_t index = CurrentIndex();
+                while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                        if (!RunPendingTask(index)) {
+                                std::this_thread::yield();
+                        }
+                }
+                return future.get();
+        }
+};
+
+// Only the subtrees of the parallel recursive bisection run on g_work_stealing_pool (see
+// graph_partitioner::perform_recursive_partitioning). g_thread_pool is stopped meanwhile, so the
+// bipartitionings inside of the subtrees are sequential. The parallel coarsening and refinement,
+// including the multitry FM, stay on g_thread_pool since they bind their work to fixed thread ids.
+// The local searches of the multitry FM are balanced by circular_task_queue instead, in which an
+// idle thread pops the start nodes of the other threads.
+extern TWorkStealingThreadPool g_work_stealing_pool;
+
+// Counterparts of submit_for_all for a TWorkStealingThreadPool. The functor is executed
+// pool.NumThreads() + 1 times, once with every id in [0, pool.NumThreads()]. Id 0 runs on the
+// calling thread, the others are tasks which may be executed by any thread of the pool. These may
+// be called from inside of tasks of the same pool.
+template<typename TFunctor>
+static void submit_for_all(TWorkStealingThreadPool& pool, TFunctor functor) {
+        std::vector<std::future<void>> futures;
+        futures.reserve(pool.NumThreads());
+        for (uint32_t i = 0; i < pool.NumThreads(); ++i) {
+                if constexpr (function_traits<TFunctor>::arity == 0) {
+                        futures.push_back(pool.Submit(functor));
+                }
+                if constexpr (function_traits<TFunctor>::arity == 1) {
+                        futures.push_back(pool.Submit(functor, i + 1));
+                }
+        }
+        if constexpr (function_traits<TFunctor>::arity == 0) {
+                functor();
+        }
+        if constexpr (function_traits<TFunctor>::arity == 1) {
+                functor(uint32_t(0));
+        }
+
+        std::for_each(futures.begin(), futures.end(), [&](auto& future) {
+                pool.Wait(future);
+        });
+};
+
+template<typename TFunctor, typename TFunctorResult, typename TArg>
+static typename std::result_of<TFunctorResult(TArg, TArg)>::type submit_for_all(TWorkStealingThreadPool& pool,
+                                                                               TFunctor functor,
+                                                                               TFunctorResult functor_result,
+                                                                               const TArg& init_value) {
+        std::vector<std::future<TArg>> futures;
+        futures.reserve(pool.NumThreads());
+        for (uint32_t i = 0; i < pool.NumThreads(); ++i) {
+                if constexpr (function_traits<TFunctor>::arity == 0) {
+                        futures.push_back(pool.Submit(functor));
+                }
+                if constexpr (function_traits<TFunctor>::arity == 1) {
+                        futures.push_back(pool.Submit(functor, i + 1));
+                }
+        }
+
+        using  res_type = typename std::result_of<TFunctorResult(TArg, TArg)>::type;
+
+        res_type res = res_type();
+        if constexpr (function_traits<TFunctor>::arity == 0) {
+                res = functor_result(init_value, functor());
+        }
+
+        if constexpr (function_traits<TFunctor>::arity == 1) {
+                res = functor_result(init_value, functor(uint32_t(0)));
+        }
+
+        std::for_each(futures.begin(), futures.end(), [&](auto& future) {
+                res = functor_result(res, pool.Wait(future));
+        });
+        return res;
+};
+
+}
@@ -42,13 +42,20 @@
  * Constants
  * ********************************************/
 //Types needed for the graph ds
+//MODE_64BIT_NODEIDS (scons node_id_width=64) is needed for graphs with more than 2^31 nodes.
+//the node weights are widened as well since they have to hold the total weight of the graph.
+#ifdef MODE_64BIT_NODEIDS
+typedef uint64_t 	NodeID;
+typedef uint64_t 	NodeWeight;
+#else
 typedef unsigned int 	NodeID;
+typedef unsigned int 	NodeWeight;
+#endif
 typedef double 		EdgeRatingType;
 //typedef unsigned int 	EdgeID;
 typedef uint64_t	EdgeID;
 typedef unsigned int 	PathID;
 typedef unsigned int 	PartitionID;
-typedef unsigned int 	NodeWeight;
 typedef int 		EdgeWeight;
 typedef EdgeWeight 	Gain;
 typedef int 		Color;
@@ -184,6 +191,13 @@ enum class BlockSizeUnit {
         EDGES
 };
 
+enum class FlowSolverType {
+        PUSH_RELABEL,
+        PARALLEL_PUSH_RELABEL,
+        BOYKOV_KOLMOGOROV,
+        AUTOMATIC
+};
+
 enum class ApplyMoveStrategy {
         LOCAL_SEARCH,
         GAIN_RECALCULATION,
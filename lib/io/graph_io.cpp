@@ -20,8 +20,115 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
 
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
 #include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "graph_io.h"
+#include "data_structure/parallel/thread_pool.h"
+
+namespace {
+// a range of complete lines of a memory mapped graph file
+struct text_chunk {
+        const char* begin;
+        const char* end;
+        NodeID num_nodes;
+        EdgeID num_edges;
+        NodeID first_node;
+        EdgeID first_edge;
+};
+
+inline bool is_blank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skip_blanks(const char* pos, const char* end) {
+        while (pos != end && is_blank(*pos)) {
+                ++pos;
+        }
+        return pos;
+}
+
+// parses the next unsigned number on the current line, returns false if the line is exhausted
+inline bool next_number(const char*& pos, const char* end, uint64_t& value) {
+        pos = skip_blanks(pos, end);
+        if (pos == end) {
+                return false;
+        }
+
+        value = 0;
+        while (pos != end && !is_blank(*pos)) {
+                value = 10 * value + (*pos - '0');
+                ++pos;
+        }
+        return true;
+}
+
+inline const char* line_end(const char* pos, const char* end) {
+        const char* newline = (const char*) memchr(pos, '\n', end - pos);
+        return newline != nullptr ? newline : end;
+}
+
+inline const char* next_line(const char* pos, const char* end) {
+        const char* eol = line_end(pos, end);
+        return eol != end ? eol + 1 : end;
+}
+
+// node ids are passed around as signed integers in some places, hence the top bit of NodeID is not usable
+bool exceeds_node_id_range(uint64_t num_nodes) {
+        if (num_nodes <= (uint64_t) std::numeric_limits<std::make_signed<NodeID>::type>::max()) {
+                return false;
+        }
+
+        std::cerr <<  "The graph is too large. Currently only " << 8 * sizeof(NodeID) << "bit supported!"  << std::endl;
+#ifndef MODE_64BIT_NODEIDS
+        std::cerr <<  "Rebuild with node_id_width=64 to partition it."  << std::endl;
+#endif
+        return true;
+}
+
+const char     BINARY_GRAPH_MAGIC[8]      = {'K', 'A', 'H', 'I', 'P', 'C', 'S', 'R'};
+const uint64_t BINARY_GRAPH_VERSION       = 1;
+const uint64_t BINARY_GRAPH_BYTE_ORDER    = 0x0102030405060708ull;
+const uint64_t BINARY_GRAPH_EDGE_WEIGHTED = 1;
+
+// the node array starts directly after the header and the edge array directly after the node array.
+// the sizes of the records are stored to detect files written by a build with other NodeID/EdgeID types.
+struct binary_graph_header {
+        char     magic[8];
+        uint64_t version;
+        uint64_t byte_order;
+        uint64_t node_record_size;
+        uint64_t edge_record_size;
+        uint64_t num_nodes;
+        uint64_t num_edges;
+        uint64_t flags;
+};
+
+// number of records written at once by write_records
+const size_t BINARY_GRAPH_WRITE_BLOCK = 1 << 16;
+
+// writes count records in the memory layout of Record, so that readGraphBinary can map them. the
+// records are assembled field by field in a zero-filled buffer, so their padding bytes are zero and
+// the file is the same for the same graph. write_fields(record, i) copies the fields of record i.
+template <typename Record, typename WriteFields>
+void write_records(std::ofstream& f, size_t count, WriteFields write_fields) {
+        std::vector<char> buffer(std::min(count, BINARY_GRAPH_WRITE_BLOCK) * sizeof(Record));
+        for (size_t begin = 0; begin < count; begin += BINARY_GRAPH_WRITE_BLOCK) {
+                size_t block = std::min(count - begin, BINARY_GRAPH_WRITE_BLOCK);
+                std::fill(buffer.begin(), buffer.begin() + block * sizeof(Record), 0);
+                for (size_t i = 0; i < block; ++i) {
+                        write_fields(buffer.data() + i * sizeof(Record), begin + i);
+                }
+                f.write(buffer.data(), block * sizeof(Record));
+        }
+}
+}
 
 graph_io::graph_io() {
                 
@@ -104,7 +211,7 @@ int graph_io::readGraphWeighted(graph_access & G, std::string filename) {
                 return 1;
         }
 
-        NodeID nmbNodes;
+        uint64_t nmbNodes;
         EdgeID nmbEdges;
 
         std::getline(in,line);
@@ -119,8 +226,7 @@ int graph_io::readGraphWeighted(graph_access & G, std::string filename) {
         ss >> nmbEdges;
         ss >> ew;
 
-        if (nmbNodes > std::numeric_limits<int>::max()) {
-                std::cerr <<  "The graph is too large. Currently only 32bit supported!"  << std::endl;
+        if (exceeds_node_id_range(nmbNodes)) {
                 exit(0);
         }
 
@@ -145,7 +251,7 @@ int graph_io::readGraphWeighted(graph_access & G, std::string filename) {
         
         NodeID node_counter   = 0;
         EdgeID edge_counter   = 0;
-        long long total_nodeweight = 0;
+        unsigned long long total_nodeweight = 0;
 
         G.start_construction(nmbNodes, nmbEdges);
 
@@ -164,7 +270,7 @@ int graph_io::readGraphWeighted(graph_access & G, std::string filename) {
                 if( read_nw ) {
                         ss >> weight;
                         total_nodeweight += weight;
-                        if( total_nodeweight > (long long) std::numeric_limits<NodeWeight>::max()) {
+                        if( total_nodeweight > (unsigned long long) std::numeric_limits<NodeWeight>::max()) {
                                 std::cerr <<  "The sum of the node weights is too large (it exceeds the node weight type)."  << std::endl;
                                 std::cerr <<  "Currently not supported. Please scale your node weights."  << std::endl;
                                 exit(0);
@@ -211,6 +317,316 @@ int graph_io::readGraphWeighted(graph_access & G, std::string filename) {
         return 0;
 }
 
+int graph_io::readGraphWeightedParallel(graph_access & G, std::string filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+                std::cerr << "Error opening " << filename << std::endl;
+                return 1;
+        }
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || file_stat.st_size == 0) {
+                close(fd);
+                return readGraphWeighted(G, filename);
+        }
+
+        size_t file_size = file_stat.st_size;
+        void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+                return readGraphWeighted(G, filename);
+        }
+        madvise(mapping, file_size, MADV_SEQUENTIAL);
+
+        const char* text_begin = (const char*) mapping;
+        const char* text_end   = text_begin + file_size;
+
+        if (file_size >= sizeof(binary_graph_header) && memcmp(text_begin, BINARY_GRAPH_MAGIC, sizeof(BINARY_GRAPH_MAGIC)) == 0) {
+                munmap(mapping, file_size);
+                return readGraphBinary(G, filename);
+        }
+
+        //skip comments
+        const char* pos = text_begin;
+        while (pos != text_end && *pos == '%') {
+                pos = next_line(pos, text_end);
+        }
+
+        uint64_t nmbNodes = 0;
+        uint64_t nmbEdges = 0;
+        uint64_t ew       = 0;
+        const char* eol = line_end(pos, text_end);
+        next_number(pos, eol, nmbNodes);
+        next_number(pos, eol, nmbEdges);
+        next_number(pos, eol, ew);
+        const char* body_begin = eol != text_end ? eol + 1 : text_end;
+
+        if (exceeds_node_id_range(nmbNodes)) {
+                exit(0);
+        }
+
+        bool read_ew = ew == 1 || ew == 11;
+        bool read_nw = ew == 10 || ew == 11;
+
+        G.setUnitWeightEdges(!read_ew);
+        nmbEdges *= 2; //since we have forward and backward edges
+
+        // split the body of the file into line aligned chunks
+        const size_t num_threads = parallel::g_thread_pool.NumThreads() + 1;
+        const size_t body_size   = text_end - body_begin;
+        const size_t num_chunks  = std::max<size_t>(1, std::min<size_t>(8 * num_threads, body_size / (1 << 20)));
+
+        std::vector<text_chunk> chunks(num_chunks);
+        const char* chunk_begin = body_begin;
+        for (size_t i = 0; i < num_chunks; ++i) {
+                const char* chunk_end = text_end;
+                if (i + 1 < num_chunks) {
+                        chunk_end = std::max(chunk_begin, body_begin + (i + 1) * (body_size / num_chunks));
+                        if (chunk_end != body_begin && chunk_end != text_end && *(chunk_end - 1) != '\n') {
+                                chunk_end = next_line(chunk_end, text_end);
+                        }
+                }
+                chunks[i].begin = chunk_begin;
+                chunks[i].end   = chunk_end;
+                chunk_begin     = chunk_end;
+        }
+
+        // first pass: count nodes and edges of each chunk
+        std::atomic<size_t> next_chunk(0);
+        parallel::submit_for_all([&](uint32_t) {
+                size_t chunk_id = next_chunk.fetch_add(1, std::memory_order_relaxed);
+                while (chunk_id < num_chunks) {
+                        text_chunk& chunk = chunks[chunk_id];
+                        chunk.num_nodes = 0;
+                        chunk.num_edges = 0;
+
+                        const char* line = chunk.begin;
+                        while (line != chunk.end) {
+                                const char* eol = line_end(line, chunk.end);
+                                if (*line != '%') { // a comment in the file
+                                        ++chunk.num_nodes;
+
+                                        EdgeID tokens = 0;
+                                        uint64_t value;
+                                        const char* cur = line;
+                                        while (next_number(cur, eol, value)) {
+                                                ++tokens;
+                                        }
+                                        if (read_nw && tokens > 0) {
+                                                --tokens;
+                                        }
+                                        chunk.num_edges += read_ew ? (tokens + 1) / 2 : tokens;
+                                }
+                                line = eol != chunk.end ? eol + 1 : chunk.end;
+                        }
+                        chunk_id = next_chunk.fetch_add(1, std::memory_order_relaxed);
+                }
+        });
+
+        // the number of chunks is small, so the offsets of the chunks are computed sequentially
+        NodeID node_counter = 0;
+        EdgeID edge_counter = 0;
+        for (auto& chunk : chunks) {
+                chunk.first_node = node_counter;
+                chunk.first_edge = edge_counter;
+                node_counter    += chunk.num_nodes;
+                edge_counter    += chunk.num_edges;
+        }
+
+        if( edge_counter != (EdgeID) nmbEdges ) {
+                std::cerr <<  "number of specified edges mismatch"  << std::endl;
+                std::cerr <<  edge_counter <<  " " <<  nmbEdges  << std::endl;
+                exit(0);
+        }
+
+        if( node_counter != (NodeID) nmbNodes) {
+                std::cerr <<  "number of specified nodes mismatch"  << std::endl;
+                std::cerr <<  node_counter <<  " " <<  nmbNodes  << std::endl;
+                exit(0);
+        }
+
+        G.start_construction(nmbNodes, nmbEdges);
+        basicGraph& graph = *G.graphref;
+
+        // second pass: parse the chunks and write nodes and edges directly into their final positions
+        std::atomic<unsigned long long> total_nodeweight(0);
+        std::atomic<bool> self_loops(false);
+        next_chunk.store(0, std::memory_order_relaxed);
+        parallel::submit_for_all([&](uint32_t) {
+                size_t chunk_id = next_chunk.fetch_add(1, std::memory_order_relaxed);
+                while (chunk_id < num_chunks) {
+                        const text_chunk& chunk = chunks[chunk_id];
+                        NodeID node = chunk.first_node;
+                        EdgeID e    = chunk.first_edge;
+                        unsigned long long chunk_nodeweight = 0;
+
+                        const char* line = chunk.begin;
+                        while (line != chunk.end) {
+                                const char* eol = line_end(line, chunk.end);
+                                if (*line != '%') { // a comment in the file
+                                        const char* cur = line;
+                                        uint64_t value;
+
+                                        NodeWeight weight = 1;
+                                        if (read_nw && next_number(cur, eol, value)) {
+                                                weight = value;
+                                                chunk_nodeweight += weight;
+                                        }
+                                        graph.m_nodes[node].firstEdge = e;
+                                        graph.m_nodes[node].weight    = weight;
+                                        graph.m_refinement_node_props[node].partitionIndex = 0;
+
+                                        while (next_number(cur, eol, value)) {
+                                                NodeID target = value - 1;
+                                                //check for self-loops
+                                                if (target == node) {
+                                                        self_loops.store(true, std::memory_order_relaxed);
+                                                }
+
+                                                EdgeWeight edge_weight = 1;
+                                                if (read_ew && next_number(cur, eol, value)) {
+                                                        edge_weight = value;
+                                                }
+                                                graph.m_edges[e].target = target;
+                                                graph.m_edges[e].weight = edge_weight;
+                                                ++e;
+                                        }
+                                        ++node;
+                                }
+                                line = eol != chunk.end ? eol + 1 : chunk.end;
+                        }
+                        total_nodeweight.fetch_add(chunk_nodeweight, std::memory_order_relaxed);
+                        chunk_id = next_chunk.fetch_add(1, std::memory_order_relaxed);
+                }
+        });
+        graph.m_nodes[nmbNodes].firstEdge = nmbEdges;
+        graph.m_building_graph = false;
+
+        munmap(mapping, file_size);
+
+        if (self_loops.load()) {
+                std::cerr <<  "The graph file contains self-loops. This is not supported. Please remove them from the file."  << std::endl;
+        }
+
+        if( total_nodeweight.load() > (unsigned long long) std::numeric_limits<NodeWeight>::max()) {
+                std::cerr <<  "The sum of the node weights is too large (it exceeds the node weight type)."  << std::endl;
+                std::cerr <<  "Currently not supported. Please scale your node weights."  << std::endl;
+                exit(0);
+        }
+
+        return 0;
+}
+
+int graph_io::writeGraphBinary(graph_access & G, std::string filename) {
+        std::ofstream f(filename.c_str(), std::ios::binary);
+        if (!f) {
+                std::cerr << "Error opening " << filename << std::endl;
+                return 1;
+        }
+
+        basicGraph& graph = *G.graphref;
+
+        binary_graph_header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic));
+        header.version          = BINARY_GRAPH_VERSION;
+        header.byte_order       = BINARY_GRAPH_BYTE_ORDER;
+        header.node_record_size = sizeof(Node);
+        header.edge_record_size = sizeof(Edge);
+        header.num_nodes        = G.number_of_nodes();
+        header.num_edges        = G.number_of_edges();
+        header.flags            = G.getUnitWeightEdges() ? 0 : BINARY_GRAPH_EDGE_WEIGHTED;
+
+        f.write((const char*) &header, sizeof(header));
+        write_records<Node>(f, header.num_nodes + 1, [&](char* record, size_t i) {
+                const Node& node = graph.m_nodes[i];
+                memcpy(record + offsetof(Node, firstEdge), &node.firstEdge, sizeof(node.firstEdge));
+                memcpy(record + offsetof(Node, weight), &node.weight, sizeof(node.weight));
+        });
+        write_records<Edge>(f, header.num_edges, [&](char* record, size_t i) {
+                const Edge& edge = graph.m_edges[i];
+                memcpy(record + offsetof(Edge, target), &edge.target, sizeof(edge.target));
+                memcpy(record + offsetof(Edge, weight), &edge.weight, sizeof(edge.weight));
+        });
+        f.close();
+
+        if (!f) {
+                std::cerr << "Error writing " << filename << std::endl;
+                return 1;
+        }
+        return 0;
+}
+
+int graph_io::readGraphBinary(graph_access & G, std::string filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+                std::cerr << "Error opening " << filename << std::endl;
+                return 1;
+        }
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0 || (size_t) file_stat.st_size < sizeof(binary_graph_header)) {
+                std::cerr << filename << " is not a binary graph file" << std::endl;
+                close(fd);
+                return 1;
+        }
+
+        // private writable mapping: refinement may change weights without touching the file
+        size_t file_size = file_stat.st_size;
+        void* mapping = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+                std::cerr << "Error mapping " << filename << std::endl;
+                return 1;
+        }
+        std::shared_ptr<void> region(mapping, [file_size](void* ptr) {
+                munmap(ptr, file_size);
+        });
+
+        const binary_graph_header& header = *(const binary_graph_header*) mapping;
+        if (memcmp(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic)) != 0) {
+                std::cerr << filename << " is not a binary graph file" << std::endl;
+                return 1;
+        }
+
+        if (header.version != BINARY_GRAPH_VERSION || header.byte_order != BINARY_GRAPH_BYTE_ORDER
+            || header.node_record_size != sizeof(Node) || header.edge_record_size != sizeof(Edge)) {
+                std::cerr << "The binary graph file " << filename << " was written by an incompatible version or node_id_width." << std::endl;
+                return 1;
+        }
+
+        if (exceeds_node_id_range(header.num_nodes)) {
+                exit(0);
+        }
+
+        size_t expected_size = sizeof(binary_graph_header) + (header.num_nodes + 1) * sizeof(Node)
+                               + header.num_edges * sizeof(Edge);
+        if (file_size != expected_size) {
+                std::cerr << "The binary graph file " << filename << " is truncated or corrupt." << std::endl;
+                return 1;
+        }
+
+        NodeID num_nodes = header.num_nodes;
+        EdgeID num_edges = header.num_edges;
+        G.setUnitWeightEdges((header.flags & BINARY_GRAPH_EDGE_WEIGHTED) == 0);
+
+        char* nodes_begin = (char*) mapping + sizeof(binary_graph_header);
+        char* edges_begin = nodes_begin + (num_nodes + 1) * sizeof(Node);
+
+        basicGraph& graph = *G.graphref;
+        graph.m_nodes.map((Node*) nodes_begin, num_nodes + 1, region);
+        graph.m_edges.map((Edge*) edges_begin, num_edges, region);
+        graph.m_refinement_node_props.assign(num_nodes + 1, refinementNode());
+        graph.m_coarsening_edge_props.assign(num_edges, coarseningEdge());
+        graph.m_building_graph = false;
+
+        if (graph.m_nodes[num_nodes].firstEdge != num_edges) {
+                std::cerr << "The binary graph file " << filename << " is corrupt." << std::endl;
+                exit(0);
+        }
+
+        return 0;
+}
 
 void graph_io::writePartition(graph_access & G, std::string filename) {
         std::ofstream f(filename.c_str());
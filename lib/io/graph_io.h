@@ -42,12 +42,29 @@ class graph_io {
                 static 
                 int readGraphWeighted(graph_access & G, std::string filename);
 
+                // reads a graph in METIS format using all threads of parallel::g_thread_pool.
+                // the file is mapped into memory and split into line aligned chunks that are
+                // parsed concurrently. falls back to readGraphWeighted if the file can not be mapped.
+                // files in the binary format (see writeGraphBinary) are loaded with readGraphBinary.
+                static 
+                int readGraphWeightedParallel(graph_access & G, std::string filename);
+
                 static
                 int writeGraphWeighted(graph_access & G, std::string filename);
 
                 static
                 int writeGraph(graph_access & G, std::string filename);
 
+                // binary CSR format: a versioned header followed by the node and the edge array of
+                // basicGraph (including node and edge weights) in their memory layout with zeroed padding.
+                static
+                int writeGraphBinary(graph_access & G, std::string filename);
+
+                // maps a file written by writeGraphBinary into memory. the node and edge arrays of G
+                // are backed by the mapping, i.e. nothing is parsed or copied.
+                static
+                int readGraphBinary(graph_access & G, std::string filename);
+
                 static 
                 int readPartition(graph_access& G, std::string filename); 
 
@@ -27,11 +27,11 @@
 #include "../edge_rating/edge_ratings.h"
 #include "../matching/gpa/gpa_matching.h"
 #include "data_structure/union_find.h"
-#include "data_structure/parallel/time.h"
 #include "node_ordering.h"
 #include "partition/uncoarsening/refinement/kway_graph_refinement/kway_graph_refinement.h"
 #include "partition/uncoarsening/refinement/kway_graph_refinement/kway_graph_refinement_commons.h"
 #include "partition/uncoarsening/refinement/label_propagation_refinement/label_propagation_refinement.h"
+#include "tools/instrumentation.h"
 #include "tools/quality_metrics.h"
 #include "tools/random_functions.h"
 #include "io/graph_io.h"
@@ -73,7 +73,7 @@ void size_constraint_label_propagation::match_internal(const PartitionConfig & p
                                               NodeID & no_of_coarse_vertices,
                                               NodePermutationMap&) {
 
-        std::vector<NodeWeight> cluster_id(G.number_of_nodes());
+        std::vector<NodeID> cluster_id(G.number_of_nodes());
         NodeWeight block_upperbound = ceil(partition_config.upper_bound_partition/(double)partition_config.cluster_coarsening_factor);
         std::cout << "BLOCK UPPER BOUND = " << block_upperbound << std::endl;
         if (!partition_config.parallel_coarsening_lp) {
@@ -151,7 +151,7 @@ void size_constraint_label_propagation::ensemble_clusterings(const PartitionConf
 
 void size_constraint_label_propagation::label_propagation(const PartitionConfig & partition_config, 
                                                          graph_access & G, 
-                                                         std::vector<NodeWeight> & cluster_id, 
+                                                         std::vector<NodeID> & cluster_id, 
                                                          NodeID & no_of_blocks ) {
         NodeWeight block_upperbound = ceil(partition_config.upper_bound_partition/(double)partition_config.cluster_coarsening_factor);
 
@@ -161,7 +161,7 @@ void size_constraint_label_propagation::label_propagation(const PartitionConfig
 void size_constraint_label_propagation::label_propagation(const PartitionConfig & partition_config, 
                                                          graph_access & G, 
                                                          const NodeWeight & block_upperbound,
-                                                         std::vector<NodeWeight> & cluster_id,  
+                                                         std::vector<NodeID> & cluster_id,  
                                                          NodeID & no_of_blocks) {
         // in this case the _matching paramter is not used 
         // coarse_mappng stores cluster id and the mapping (it is identical)
@@ -190,13 +190,13 @@ void size_constraint_label_propagation::label_propagation(const PartitionConfig
                         } endfor
 
                         //second sweep for finding max and resetting array
-                        PartitionID max_block = cluster_id[node];
-                        PartitionID my_block  = cluster_id[node];
+                        NodeID max_block = cluster_id[node];
+                        NodeID my_block  = cluster_id[node];
 
                         PartitionID max_value = 0;
                         forall_out_edges(G, e, node) {
                                 NodeID target             = G.getEdgeTarget(e);
-                                PartitionID cur_block     = cluster_id[target];
+                                NodeID cur_block          = cluster_id[target];
                                 PartitionID cur_value     = hash_map[cur_block];
                                 if((cur_value > max_value  || (cur_value == max_value && random_functions::nextBool())) 
                                 && (cluster_sizes[cur_block] + G.getNodeWeight(node) < block_upperbound || cur_block == my_block) 
@@ -276,7 +276,7 @@ uint32_t size_constraint_label_propagation::parallel_label_propagation(const Par
                                         }
                                         active[node].store(false, std::memory_order_relaxed);
 
-                                        const PartitionID my_block = cluster_id[node];
+                                        const NodeID my_block = cluster_id[node];
                                         //now move the node to the cluster that is most common in the neighborhood
                                         neighbor_parts.clear();
                                         neighbor_parts.reserve(G.getNodeDegree(node));
@@ -290,7 +290,7 @@ uint32_t size_constraint_label_propagation::parallel_label_propagation(const Par
                                         } endfor
 
                                         //second sweep for finding max and resetting array
-                                        PartitionID max_block = my_block;
+                                        NodeID max_block = my_block;
                                         NodeWeight max_cluster_size = cluster_sizes[max_block].load(
                                                 std::memory_order_relaxed);
 
@@ -360,7 +360,6 @@ uint32_t size_constraint_label_propagation::parallel_label_propagation(const Par
                 uint32_t na = 0;
                 uint32_t changed = 0;
 
-                CLOCK_START;
                 std::tie(changed, na) = process(0);
                 num_changed_label_all += changed;
                 num_active += na;
@@ -370,7 +369,6 @@ uint32_t size_constraint_label_propagation::parallel_label_propagation(const Par
                         num_changed_label_all += changed;
                         num_active += na;
                 });
-                CLOCK_END(std::string("Iteration ") + std::to_string(j) + " time");
                 active.swap(new_active);
                 block_size = std::max((uint32_t) sqrt(num_active), 1000u);
                 futures.clear();
@@ -492,9 +490,8 @@ uint32_t size_constraint_label_propagation::parallel_label_propagation(const Par
 void size_constraint_label_propagation::parallel_label_propagation(const PartitionConfig& config,
                                                                    graph_access& G,
                                                                    const NodeWeight block_upperbound,
-                                                                   std::vector<NodeWeight>& cluster_id,
+                                                                   std::vector<NodeID>& cluster_id,
                                                                    NodeID& no_of_blocks) {
-        CLOCK_START;
         std::vector<parallel::AtomicWrapper<NodeWeight>> cluster_sizes(G.number_of_nodes());
         std::vector<parallel::AtomicWrapper<char>> active(G.number_of_nodes(), true);
         std::vector<parallel::AtomicWrapper<char>> new_active(G.number_of_nodes(), false);
@@ -504,9 +501,6 @@ void size_constraint_label_propagation::parallel_label_propagation(const Partiti
                 cluster_sizes[node].store(G.getNodeWeight(node), std::memory_order_relaxed);
         } endfor
 
-        CLOCK_END("Init other vectors lp");
-
-        CLOCK_START_N;
         std::vector<pair_type> permutation;
         permutation.reserve(G.number_of_nodes());
 
@@ -517,17 +511,16 @@ void size_constraint_label_propagation::parallel_label_propagation(const Partiti
         parallel::g_thread_pool.Clear();
         parallel::Unpin();
         {
-                CLOCK_START;
+                SCOPED_TIMER("sort");
                 parallel::sort(permutation.begin(), permutation.end(), [&](const pair_type& lhs, const pair_type& rhs) {
                         return lhs.second < rhs.second || (lhs.second == rhs.second && lhs.first < rhs.first);
                 }, config.num_threads);
-                CLOCK_END("Sort");
         }
         parallel::PinToCore(0);
         parallel::g_thread_pool.Resize(config.num_threads - 1);
 
         {
-                CLOCK_START;
+                SCOPED_TIMER("shuffle");
                 parallel::random rnd(config.seed);
                 size_t i = 0;
                 while (i < permutation.size()) {
@@ -539,31 +532,27 @@ void size_constraint_label_propagation::parallel_label_propagation(const Partiti
                         rnd.shuffle(permutation.begin() + i, permutation.begin() + end + 1);
                         i = end + 1;
                 }
-                CLOCK_END("Shuffle");
         }
 
-        CLOCK_END("Parallel init of permutations lp");
-
-        CLOCK_START_N;
-
-        uint32_t num_changed_label = parallel_label_propagation(config, G, block_upperbound, cluster_sizes, cluster_id,
-                                                                permutation, no_of_blocks, active, new_active);
-
-        CLOCK_END("Main parallel (no queue) lp");
-        std::cout << "Improved\t" << num_changed_label << std::endl;
+        uint32_t num_changed_label = 0;
+        {
+                SCOPED_TIMER("iterations");
+                num_changed_label = parallel_label_propagation(config, G, block_upperbound, cluster_sizes, cluster_id,
+                                                               permutation, no_of_blocks, active, new_active);
+        }
+        INSTRUMENTATION_COUNT("label_propagation/changed_labels", num_changed_label);
 
-        CLOCK_START_N;
+        SCOPED_TIMER("remap_cluster_ids");
         if (config.num_threads > 1) {
                 parallel_remap_cluster_ids_fast(config, G, cluster_id, no_of_blocks);
         } else {
                 remap_cluster_ids_fast(config, G, cluster_id, no_of_blocks);
         }
-        CLOCK_END("Remap cluster ids");
 }
 
 void size_constraint_label_propagation::create_coarsemapping(const PartitionConfig & partition_config, 
                                                              graph_access & G,
-                                                             std::vector<NodeWeight>& cluster_id,
+                                                             std::vector<NodeID>& cluster_id,
                                                              CoarseMapping & coarse_mapping) {
         forall_nodes(G, node) {
                 coarse_mapping[node] = cluster_id[node];
@@ -572,13 +561,13 @@ void size_constraint_label_propagation::create_coarsemapping(const PartitionConf
 
 void size_constraint_label_propagation::remap_cluster_ids(const PartitionConfig & partition_config, 
                                                           graph_access & G,
-                                                          std::vector<NodeWeight> & cluster_id,
+                                                          std::vector<NodeID> & cluster_id,
                                                           NodeID & no_of_coarse_vertices, bool apply_to_graph) {
 
-        PartitionID cur_no_clusters = 0;
-        std::unordered_map<PartitionID, PartitionID> remap;
+        NodeID cur_no_clusters = 0;
+        std::unordered_map<NodeID, NodeID> remap;
         forall_nodes(G, node) {
-                PartitionID cur_cluster = cluster_id[node];
+                NodeID cur_cluster = cluster_id[node];
                 //check wether we already had that
                 if( remap.find( cur_cluster ) == remap.end() ) {
                         remap[cur_cluster] = cur_no_clusters++;
@@ -599,7 +588,7 @@ void size_constraint_label_propagation::remap_cluster_ids(const PartitionConfig
 
 void size_constraint_label_propagation::remap_cluster_ids_fast(const PartitionConfig& partition_config,
                                                                graph_access& G,
-                                                               std::vector<NodeWeight>& cluster_id,
+                                                               std::vector<NodeID>& cluster_id,
                                                                NodeID& no_of_coarse_vertices,
                                                                bool apply_to_graph) {
         if (cluster_id.empty()) {
@@ -607,9 +596,9 @@ void size_constraint_label_propagation::remap_cluster_ids_fast(const PartitionCo
                 return;
         }
 
-        std::vector<NodeWeight> cluster_map(G.number_of_nodes());
+        std::vector<NodeID> cluster_map(G.number_of_nodes());
         forall_nodes(G, node) {
-                PartitionID cur_cluster = cluster_id[node];
+                NodeID cur_cluster = cluster_id[node];
                 cluster_map[cur_cluster] = 1;
         } endfor
 
@@ -632,7 +621,7 @@ void size_constraint_label_propagation::remap_cluster_ids_fast(const PartitionCo
 
 void size_constraint_label_propagation::parallel_remap_cluster_ids_fast(const PartitionConfig& partition_config,
                                                                         graph_access& G,
-                                                                        std::vector<NodeWeight>& cluster_id,
+                                                                        std::vector<NodeID>& cluster_id,
                                                                         NodeID& no_of_coarse_vertices) {
         if (cluster_id.empty()) {
                 no_of_coarse_vertices = 0;
@@ -641,7 +630,7 @@ void size_constraint_label_propagation::parallel_remap_cluster_ids_fast(const Pa
 
         parallel::ParallelVector<NodeID> cluster_map(G.number_of_nodes());
         parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
-                PartitionID cur_cluster = cluster_id[node];
+                NodeID cur_cluster = cluster_id[node];
                 cluster_map[cur_cluster] = 1;
         });
 
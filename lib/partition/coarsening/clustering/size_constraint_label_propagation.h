@@ -125,13 +125,13 @@ class size_constraint_label_propagation : public matching {
 
                 void label_propagation(const PartitionConfig & partition_config, 
                                 graph_access & G, 
-                                std::vector<NodeWeight> & cluster_id,
+                                std::vector<NodeID> & cluster_id,
                                 NodeID & number_of_blocks );
 
                 void parallel_label_propagation(const PartitionConfig& config,
                                                 graph_access& G,
                                                 const NodeWeight block_upperbound,
-                                                std::vector<NodeWeight>& cluster_id,
+                                                std::vector<NodeID>& cluster_id,
                                                 NodeID& no_of_blocks);
 
                 uint32_t parallel_label_propagation(const PartitionConfig& config,
@@ -0,0 +1,150 @@
+#include "data_structure/parallel/algorithm.h"
+#include "data_structure/parallel/atomics.h"
+#include "data_structure/parallel/hash_function.h"
+#include "data_structure/parallel/thread_pool.h"
+#include "partition/coarsening/clustering/two_hop_clustering.h"
+#include "tools/instrumentation.h"
+
+#include <iostream>
+#include <tuple>
+
+void two_hop_clustering::match(const PartitionConfig& config,
+                               graph_access& G,
+                               Matching&,
+                               CoarseMapping& coarse_mapping,
+                               NodeID& no_of_coarse_vertices,
+                               NodePermutationMap&) {
+        cluster_singletons(config, G, coarse_mapping, no_of_coarse_vertices);
+}
+
+NodeID two_hop_clustering::favorite_neighbor(graph_access& G, NodeID node) const {
+        NodeID favorite = UNDEFINED_NODE;
+        EdgeWeight max_weight = 0;
+        forall_out_edges(G, e, node){
+                NodeID target = G.getEdgeTarget(e);
+                EdgeWeight weight = G.getEdgeWeight(e);
+                if (favorite == UNDEFINED_NODE || weight > max_weight || (weight == max_weight && target < favorite)) {
+                        favorite = target;
+                        max_weight = weight;
+                }
+        } endfor
+        return favorite;
+}
+
+void two_hop_clustering::cluster_singletons(const PartitionConfig& config,
+                                            graph_access& G,
+                                            CoarseMapping& coarse_mapping,
+                                            NodeID& no_of_coarse_vertices) {
+        const NodeID cluster_upperbound = (NodeID) ceil(
+                (config.upper_bound_partition + 0.0) / config.cluster_coarsening_factor);
+
+        if (coarse_mapping.empty()) {
+                return;
+        }
+
+        std::vector<candidate> singletons;
+        {
+                SCOPED_TIMER("favorite_neighbors");
+                std::vector<parallel::AtomicWrapper<NodeID>> cluster_nodes(G.number_of_nodes());
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                        cluster_nodes[coarse_mapping[node]].m_atomic.fetch_add(1, std::memory_order_relaxed);
+                });
+
+                parallel::MurmurHash<NodeID> hash(config.seed);
+                std::vector<candidate> candidates(G.number_of_nodes());
+                std::vector<uint8_t> is_candidate(G.number_of_nodes(), false);
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                        if (cluster_nodes[coarse_mapping[node]].m_atomic.load(std::memory_order_relaxed) > 1) {
+                                return;
+                        }
+                        NodeID favorite = favorite_neighbor(G, node);
+                        if (favorite == UNDEFINED_NODE) {
+                                return;
+                        }
+
+                        uint64_t neighborhood = 0;
+                        forall_out_edges(G, e, node){
+                                neighborhood ^= hash(G.getEdgeTarget(e));
+                        } endfor
+
+                        candidate& c   = candidates[node];
+                        c.favorite     = favorite;
+                        c.block        = config.graph_allready_partitioned ? G.getPartitionIndex(node) : 0;
+                        c.second_block = config.combine ? G.getSecondPartitionIndex(node) : 0;
+                        c.relative     = G.getNodeDegree(node) == 1 ? 0 : 1;
+                        c.neighborhood = neighborhood;
+                        c.node         = node;
+                        is_candidate[node] = true;
+                });
+
+                // drop the nodes that are already clustered, in node order
+                std::vector<NodeID> offsets(G.number_of_nodes());
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                        offsets[node] = is_candidate[node];
+                });
+                parallel::partial_sum(offsets.begin(), offsets.end(), offsets.begin(), config.num_threads);
+                if (offsets.back() < 2) {
+                        return;
+                }
+
+                singletons.resize(offsets.back());
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                        if (is_candidate[node]) {
+                                singletons[offsets[node] - 1] = candidates[node];
+                        }
+                });
+        }
+        const NodeID num_candidates = singletons.size();
+
+        // nodes with the same favorite neighbor (and block) form consecutive buckets. within a bucket the
+        // leaves come first and twins are next to each other.
+        {
+                SCOPED_TIMER("sort");
+                parallel::sort(singletons.begin(), singletons.end(), [](const candidate& lhs, const candidate& rhs) {
+                        return std::tie(lhs.favorite, lhs.block, lhs.second_block, lhs.relative, lhs.neighborhood, lhs.node)
+                               < std::tie(rhs.favorite, rhs.block, rhs.second_block, rhs.relative, rhs.neighborhood, rhs.node);
+                }, config.num_threads);
+        }
+
+        auto same_bucket = [&](const candidate& lhs, const candidate& rhs) {
+                return lhs.favorite == rhs.favorite && lhs.block == rhs.block && lhs.second_block == rhs.second_block;
+        };
+
+        // Every thread groups the buckets starting in its range, a bucket is grouped up to its end even if
+        // that lies in the range of the next thread. All nodes of a bucket are alone in their clusters, so a
+        // group only changes the clusters of its own nodes and no synchronization is needed.
+        {
+                SCOPED_TIMER("group");
+                const uint32_t num_threads = parallel::g_thread_pool.NumThreads() + 1;
+                parallel::submit_for_all([&](uint32_t thread_id) {
+                        size_t i = (size_t) num_candidates * thread_id / num_threads;
+                        size_t range_end = (size_t) num_candidates * (thread_id + 1) / num_threads;
+                        while (i > 0 && i < range_end && same_bucket(singletons[i], singletons[i - 1])) {
+                                ++i;
+                        }
+
+                        while (i < range_end) {
+                                // one group per iteration, a bucket heavier than cluster_upperbound is split
+                                // into several groups
+                                do {
+                                        NodeID cluster = coarse_mapping[singletons[i].node];
+                                        NodeWeight size = G.getNodeWeight(singletons[i].node);
+
+                                        while (++i < num_candidates && same_bucket(singletons[i], singletons[i - 1])) {
+                                                NodeID next_node = singletons[i].node;
+                                                NodeWeight weight = G.getNodeWeight(next_node);
+                                                if (size + weight > cluster_upperbound) {
+                                                        // start a new group with the rest of the bucket
+                                                        break;
+                                                }
+                                                size += weight;
+                                                coarse_mapping[next_node] = cluster;
+                                        }
+                                } while (i < num_candidates && same_bucket(singletons[i], singletons[i - 1]));
+                        }
+                });
+        }
+
+        SCOPED_TIMER("relabel");
+        no_of_coarse_vertices = parallel::remap_cluster_ids(coarse_mapping, config.num_threads);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "data_structure/graph_access.h"
+#include "partition/coarsening/matching/matching.h"
+
+// Groups nodes that are still alone in their cluster after label propagation and share the same favorite
+// neighbor (their heaviest edge). Leaves (degree one) of a hub are grouped first, then twins (equal
+// neighborhoods) and other relatives. Groups respect the cluster size constraint of label propagation.
+// Works on the coarse_mapping of a clustering, so both cluster contractions can use the result.
+class two_hop_clustering : public matching {
+public:
+        void match(const PartitionConfig& config,
+                   graph_access& G,
+                   Matching&,
+                   CoarseMapping& coarse_mapping,
+                   NodeID& no_of_coarse_vertices,
+                   NodePermutationMap&) override;
+
+        virtual ~two_hop_clustering() {}
+
+private:
+        struct candidate {
+                NodeID favorite;
+                PartitionID block;
+                PartitionID second_block;
+                // 0 for leaves, 1 for all other nodes
+                uint32_t relative;
+                uint64_t neighborhood;
+                NodeID node;
+        };
+
+        // heaviest neighbor of node, ties are broken by the smaller id. UNDEFINED_NODE for isolated nodes
+        NodeID favorite_neighbor(graph_access& G, NodeID node) const;
+
+        void cluster_singletons(const PartitionConfig& config,
+                                graph_access& G,
+                                CoarseMapping& coarse_mapping,
+                                NodeID& no_of_coarse_vertices);
+};
@@ -23,6 +23,7 @@
 #include <limits>
 #include <sstream>
 
+#include "clustering/two_hop_clustering.h"
 #include "coarsening.h"
 #include "coarsening_configurator.h"
 #include "contraction.h"
@@ -32,7 +33,7 @@
 #include "graph_io.h"
 #include "matching/gpa/gpa_matching.h"
 #include "matching/random_matching.h"
-#include "data_structure/parallel/time.h"
+#include "instrumentation.h"
 #include "min_hash/hash_common_neighborhood.h"
 
 coarsening::coarsening() {
@@ -48,7 +49,6 @@ void coarsening::perform_coarsening(const PartitionConfig & partition_config, gr
         NodeID no_of_coarser_vertices = G.number_of_nodes();
         NodeID no_of_finer_vertices   = G.number_of_nodes();
 
-        edge_ratings rating(partition_config);
         CoarseMapping* coarse_mapping = NULL;
 
         graph_access* finer                      = &G;
@@ -56,6 +56,12 @@ void coarsening::perform_coarsening(const PartitionConfig & partition_config, gr
         contraction* contracter                  = new contraction();
         PartitionConfig copy_of_partition_config = partition_config;
 
+        // the parallel node separator uses the parallel local max matching and contraction
+        if (partition_config.mode_node_separators && partition_config.parallel_node_separator) {
+                copy_of_partition_config.matching_type = MATCHING_PARALLEL_LOCAL_MAX;
+        }
+        edge_ratings rating(copy_of_partition_config);
+
         std::unique_ptr<stop_rule> coarsening_stop_rule = get_stop_rule(G, copy_of_partition_config);
 
         coarsening_configurator coarsening_config;
@@ -64,29 +70,34 @@ void coarsening::perform_coarsening(const PartitionConfig & partition_config, gr
         bool contraction_stop = false;
         bool common_neighborhood_clustering = partition_config.common_neighborhood_clustering;
 
+        // scratch of the matchers, the buffers of the finest level are large enough for all coarser levels
+        Matching edge_matching;
+        NodePermutationMap permutation;
+
         do {
                 graph_access* coarser = new graph_access();
                 coarse_mapping        = new CoarseMapping();
-                Matching edge_matching;
-                NodePermutationMap permutation;
+                edge_matching.clear();
+                permutation.clear();
 
                 coarsening_config.configure_coarsening(copy_of_partition_config, &edge_matcher, level);
+                SCOPED_LEVEL(level);
 
-                CLOCK_START;
                 if (partition_config.matching_type != CLUSTER_COARSENING) {
+                        SCOPED_TIMER("rate");
                         rating.rate(*finer, level);
                 }
-                CLOCK_END(">> Rate");
 
-                CLOCK_START_N;
-                edge_matcher->match(copy_of_partition_config, *finer, edge_matching,
-                                    *coarse_mapping, no_of_coarser_vertices, permutation);
-                delete edge_matcher;
-                CLOCK_END(">> Match or clustering");
+                {
+                        SCOPED_TIMER("match_or_cluster");
+                        edge_matcher->match(copy_of_partition_config, *finer, edge_matching,
+                                            *coarse_mapping, no_of_coarser_vertices, permutation);
+                        delete edge_matcher;
+                }
 
                 if (common_neighborhood_clustering) {
                         std::cout << "Number of coarse vertices before min_hash = " << no_of_coarser_vertices << std::endl;
-                        CLOCK_START;
+                        SCOPED_TIMER("hash_common_neighborhood");
                         hash_common_neighborhood().match(copy_of_partition_config, *finer, edge_matching,
                                                          *coarse_mapping, no_of_coarser_vertices, permutation);
 
@@ -94,7 +105,15 @@ void coarsening::perform_coarsening(const PartitionConfig & partition_config, gr
                         if (finer->number_of_nodes() == no_of_coarser_vertices) {
                                 common_neighborhood_clustering = false;
                         }
-                        CLOCK_END(">> Hashing neighbors");
+                }
+
+                // label propagation leaves the low degree nodes around hubs alone if the hub cluster is full
+                if (partition_config.two_hop_clustering && partition_config.matching_type == CLUSTER_COARSENING
+                    && no_of_coarser_vertices > partition_config.two_hop_clustering_threshold * finer->number_of_nodes()) {
+                        SCOPED_TIMER("two_hop_clustering");
+                        two_hop_clustering().match(copy_of_partition_config, *finer, edge_matching,
+                                                   *coarse_mapping, no_of_coarser_vertices, permutation);
+                        PRINT(std::cout << ">> two_hop_clustering: finer vertices = " << finer->number_of_nodes() << ", # of coarsed vertices = " << no_of_coarser_vertices << std::endl;)
                 }
 
 //                if (!copy_of_partition_config.accept_small_coarser_graphs && no_of_coarser_vertices < copy_of_partition_config.k * 1000) {
@@ -103,15 +122,19 @@ void coarsening::perform_coarsening(const PartitionConfig & partition_config, gr
 //                        break;
 //                }
 
-                CLOCK_START_N;
+                hierarchy.reserve_level(coarser, no_of_coarser_vertices, finer->number_of_edges());
                 if(partition_config.graph_allready_partitioned) {
+                        SCOPED_TIMER("contract");
                         contracter->contract_partitioned(copy_of_partition_config, *finer, *coarser, edge_matching, 
                                                          *coarse_mapping, no_of_coarser_vertices, permutation);
                 } else {
+                        SCOPED_TIMER("contract");
                         contracter->contract(copy_of_partition_config, *finer, *coarser, edge_matching,
                                              *coarse_mapping, no_of_coarser_vertices, permutation);
                 }
-                CLOCK_END(">> Contract");
+                hierarchy.finish_level(coarser);
+                INSTRUMENTATION_COUNT("coarsening/nodes", coarser->number_of_nodes());
+                INSTRUMENTATION_COUNT("coarsening/edges", coarser->number_of_edges());
 
                 hierarchy.push_back(finer, coarse_mapping);
 
@@ -28,6 +28,7 @@
 #include "definitions.h"
 #include "edge_rating/edge_ratings.h"
 #include "matching/gpa/gpa_matching.h"
+#include "matching/gpa/parallel_gpa_matching.h"
 #include "matching/random_matching.h"
 #include "partition/coarsening/matching/local_max.h"
 #include "clustering/size_constraint_label_propagation.h"
@@ -52,12 +53,20 @@ inline void coarsening_configurator::configure_coarsening( const PartitionConfig
                         *edge_matcher = new random_matching();
                         break; 
                 case MATCHING_GPA:
-                        *edge_matcher = new gpa_matching();
+                        if (partition_config.parallel_gpa) {
+                                *edge_matcher = new parallel_gpa_matching();
+                        } else {
+                                *edge_matcher = new gpa_matching();
+                        }
                         PRINT(std::cout <<  "gpa matching"  << std::endl;)
                         break;
                 case MATCHING_RANDOM_GPA:
                         PRINT(std::cout <<  "random gpa matching"  << std::endl;)
-                        *edge_matcher = new gpa_matching();
+                        if (partition_config.parallel_gpa) {
+                                *edge_matcher = new parallel_gpa_matching();
+                        } else {
+                                *edge_matcher = new gpa_matching();
+                        }
                         break;
                case CLUSTER_COARSENING:
                         PRINT(std::cout <<  "cluster_coarsening"  << std::endl;)
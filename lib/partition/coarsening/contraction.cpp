@@ -21,8 +21,9 @@
  *****************************************************************************/
 
 #include "contraction.h"
-#include "data_structure/parallel/time.h"
+#include "data_structure/parallel/graph_builder.h"
 #include "data_structure/parallel/thread_pool.h"
+#include "tools/instrumentation.h"
 #include "../uncoarsening/refinement/quotient_graph_refinement/complete_boundary.h"
 #include "macros_assertions.h"
 
@@ -48,6 +49,14 @@ void contraction::contract(const PartitionConfig& partition_config,
                            const NodePermutationMap& permutation) const {
         coarser.setUnitWeightEdges(false);
         if (partition_config.matching_type == CLUSTER_COARSENING) {
+#ifdef MODE_64BIT_NODEIDS
+                // the other variants pack two cluster ids into one 64bit key
+                if (no_of_coarse_vertices > std::numeric_limits<uint32_t>::max()) {
+                        parallel_contract_clustering_by_members(partition_config, G, coarser, coarse_mapping,
+                                                                no_of_coarse_vertices);
+                        return;
+                }
+#endif
                 if (!partition_config.fast_contract_clustering) {
                         contract_clustering(partition_config, G, coarser, edge_matching, coarse_mapping,
                                             no_of_coarse_vertices, permutation);
@@ -182,20 +191,17 @@ void contraction::parallel_fast_contract_clustering(const PartitionConfig& parti
                 return;
         }
 
-        CLOCK_START;
         // build set of new edges
         double avg_degree = (G.number_of_edges() + 0.0) / G.number_of_nodes();
         size_t num_cut_edges = std::min<size_t>(avg_degree * no_of_coarse_vertices, G.number_of_edges() / 10);
         std::cout << "overall ht capacity\t" << num_cut_edges << std::endl;
 
         growt::uaGrow<parallel::MurmurHash<uint64_t>> new_edges(2 * num_cut_edges);
-        CLOCK_END("Init hash tables");
 
-        CLOCK_START_N;
         std::atomic<NodeID> offset(0);
 
         NodeID block_size = (NodeID) sqrt(G.number_of_nodes());
-        block_size = std::max(block_size, 1000u);
+        block_size = std::max<NodeID>(block_size, 1000);
         std::cout << "block_size\t" << block_size << std::endl;
 
         auto task = [&](uint32_t id) {
@@ -206,12 +212,12 @@ void contraction::parallel_fast_contract_clustering(const PartitionConfig& parti
                         NodeID end = std::min(begin + block_size, G.number_of_nodes());
 
                         for (NodeID node = begin; node != end; ++node) {
-                                PartitionID source_cluster = coarse_mapping[node];
+                                NodeID source_cluster = coarse_mapping[node];
                                 my_block_infos[source_cluster] += G.getNodeWeight(node);
 
                                 forall_out_edges(G, e, node) {
                                         NodeID targetID = G.getEdgeTarget(e);
-                                        PartitionID target_cluster = coarse_mapping[targetID];
+                                        NodeID target_cluster = coarse_mapping[targetID];
                                         bool is_cut_edge = source_cluster != target_cluster;
 
                                         if (is_cut_edge) {
@@ -233,67 +239,47 @@ void contraction::parallel_fast_contract_clustering(const PartitionConfig& parti
         };
 
         std::vector<NodeWeight> block_infos;
-        parallel::submit_for_all(task, [&](auto& block_infos, auto&& cur_block_infos) {
-                if (block_infos.empty()) {
-                        block_infos.swap(cur_block_infos);
-                } else {
-                        for (size_t i = 0; i < no_of_coarse_vertices; ++i) {
-                                block_infos[i] += cur_block_infos[i];
+        {
+                SCOPED_TIMER("construct_hash_table");
+                parallel::submit_for_all(task, [&](auto& block_infos, auto&& cur_block_infos) {
+                        if (block_infos.empty()) {
+                                block_infos.swap(cur_block_infos);
+                        } else {
+                                for (size_t i = 0; i < no_of_coarse_vertices; ++i) {
+                                        block_infos[i] += cur_block_infos[i];
+                                }
                         }
-                }
-        }, block_infos);
-        CLOCK_END("Construct hash table and aux data");
+                }, block_infos);
+        }
 
-        CLOCK_START_N;
-        std::vector<parallel::AtomicWrapper<EdgeID>> offsets(no_of_coarse_vertices);
+        parallel::graph_builder builder(coarser, no_of_coarse_vertices, partition_config.num_threads);
         offset.store(0, std::memory_order_relaxed);
         auto task1 = [&](uint32_t thread_id) {
                 auto handle = new_edges.getHandle();
                 size_t size = handle.capacity();
                 const EdgeID block_size = std::max<EdgeID>(sqrt(size), 1000);
                 EdgeID begin = offset.fetch_add(block_size, std::memory_order_relaxed);
-                EdgeID num_edges = 0;
 
                 while (begin < size) {
                         auto it = handle.range(begin, begin + block_size);
                         for (; it != handle.range_end(); ++it) {
                                 std::pair<NodeID, NodeID> edge = get_pair_from_uint64((*it).first);
-                                ++num_edges;
-                                offsets[edge.first].fetch_add(1, std::memory_order_relaxed);
+                                builder.add_degree(edge.first);
                         }
                         begin = offset.fetch_add(block_size, std::memory_order_relaxed);
                 }
-
-                return num_edges;
         };
 
-
-        EdgeID num_edges = parallel::submit_for_all(task1,
-                                                    [](EdgeID num_edges, EdgeID cur_num_edges) {
-                                                            return num_edges + cur_num_edges;
-                                                    }, EdgeID(0));
-        std::cout << "num edges\t" << num_edges << std::endl;
-        CLOCK_END("Calculate offsets");
-
-        CLOCK_START_N;
-        NodeID last_node_degree = offsets.back();
         {
-                CLOCK_START;
-                parallel::partial_sum_open_interval(offsets.begin(), offsets.end(), offsets.begin(),
-                                                    partition_config.num_threads);
-                CLOCK_END("prefix sum");
+                SCOPED_TIMER("calculate_offsets");
+                parallel::submit_for_all(task1);
+                EdgeID num_edges = builder.compute_offsets();
+                std::cout << "num edges\t" << num_edges << std::endl;
+                parallel::parallel_for_index(NodeID(0), no_of_coarse_vertices, [&](NodeID node) {
+                        builder.set_node_weight(node, block_infos[node]);
+                });
         }
-        std::vector<Node> nodes(no_of_coarse_vertices + 1);
-        parallel::parallel_for_index(NodeID(0), no_of_coarse_vertices, [&](NodeID node) {
-                nodes[node].firstEdge = offsets[node];
-                nodes[node].weight = block_infos[node];
-        });
-        nodes.back().firstEdge = num_edges;
-        ALWAYS_ASSERT(num_edges == offsets.back() + last_node_degree);
-        CLOCK_END("Calculate prefix sum");
-
-        CLOCK_START_N;
-        std::vector<Edge> edges(num_edges);
+
         offset.store(0, std::memory_order_relaxed);
         auto task2 = [&](uint32_t thread_id) {
                 auto handle = new_edges.getHandle();
@@ -305,21 +291,20 @@ void contraction::parallel_fast_contract_clustering(const PartitionConfig& parti
                         auto it = handle.range(begin, begin + block_size);
                         for (; it != handle.range_end(); ++it) {
                                 std::pair<NodeID, NodeID> edge = get_pair_from_uint64((*it).first);
-                                auto edge_weight = (*it).second;
-                                EdgeID offset = offsets[edge.first].fetch_add(1, std::memory_order_relaxed);
-                                edges[offset].target = edge.second;
-                                edges[offset].weight = edge_weight;
+                                builder.set_edge(builder.claim_edge(edge.first), edge.second, (*it).second);
                         }
                         begin = offset.fetch_add(block_size, std::memory_order_relaxed);
                 }
         };
 
+        SCOPED_TIMER("make_edge_array");
         parallel::submit_for_all(task2);
 
-        coarser.start_construction(nodes, edges);
+        if (partition_config.deterministic_parallel) {
+                builder.sort_edges();
+        }
+        builder.finish();
         ALWAYS_ASSERT(!partition_config.graph_allready_partitioned);
-
-        CLOCK_END("Calculate edges array");
 }
 
 void contraction::parallel_fast_contract_clustering_multiple_threads_balls_and_bins_ht(
@@ -328,7 +313,6 @@ void contraction::parallel_fast_contract_clustering_multiple_threads_balls_and_b
         graph_access& coarser,
         const CoarseMapping& coarse_mapping,
         const NodeID& no_of_coarse_vertices) const {
-        CLOCK_START;
         const uint32_t num_threads = partition_config.num_threads;
 
         // build set of new edges
@@ -340,16 +324,17 @@ void contraction::parallel_fast_contract_clustering_multiple_threads_balls_and_b
         using concurrent_ht_type = growt::uaGrow<parallel::MurmurHash<uint64_t>>;
         parallel::ParallelVector<concurrent_ht_type> new_edges(num_threads);
 
-        parallel::submit_for_all([&](uint32_t thread_id) {
-                new(&new_edges[thread_id]) concurrent_ht_type(2 * num_cut_edges / num_threads);
-        });
-        CLOCK_END("Init hash tables");
+        {
+                SCOPED_TIMER("init_hash_tables");
+                parallel::submit_for_all([&](uint32_t thread_id) {
+                        new(&new_edges[thread_id]) concurrent_ht_type(2 * num_cut_edges / num_threads);
+                });
+        }
 
-        CLOCK_START_N;
         std::atomic<NodeID> offset(0);
 
         NodeID block_size = (NodeID) sqrt(G.number_of_nodes());
-        block_size = std::max(block_size, 1000u);
+        block_size = std::max<NodeID>(block_size, 1000);
         std::cout << "block_size\t" << block_size << std::endl;
 
         auto task_with_buffers = [&](uint32_t) {
@@ -383,13 +368,13 @@ void contraction::parallel_fast_contract_clustering_multiple_threads_balls_and_b
                         NodeID end = std::min(begin + block_size, G.number_of_nodes());
 
                         for (NodeID node = begin; node != end; ++node) {
-                                const PartitionID source_cluster = coarse_mapping[node];
+                                const NodeID source_cluster = coarse_mapping[node];
                                 my_block_infos[source_cluster] += G.getNodeWeight(node);
                                 uint32_t ht_num = num_threads;
 
                                 forall_out_edges(G, e, node){
                                                         NodeID targetID = G.getEdgeTarget(e);
-                                                        PartitionID target_cluster = coarse_mapping[targetID];
+                                                        NodeID target_cluster = coarse_mapping[targetID];
                                                         bool is_cut_edge = source_cluster != target_cluster;
 
                                                         if (is_cut_edge) {
@@ -430,13 +415,13 @@ void contraction::parallel_fast_contract_clustering_multiple_threads_balls_and_b
                         NodeID end = std::min(begin + block_size, G.number_of_nodes());
 
                         for (NodeID node = begin; node != end; ++node) {
-                                const PartitionID source_cluster = coarse_mapping[node];
+                                const NodeID source_cluster = coarse_mapping[node];
                                 my_block_infos[source_cluster] += G.getNodeWeight(node);
                                 concurrent_ht_type::Handle* handle_ptr = nullptr;
 
                                 forall_out_edges(G, e, node){
                                         NodeID targetID = G.getEdgeTarget(e);
-                                        PartitionID target_cluster = coarse_mapping[targetID];
+                                        NodeID target_cluster = coarse_mapping[targetID];
                                         bool is_cut_edge = source_cluster != target_cluster;
 
                                         if (is_cut_edge) {
@@ -464,82 +449,63 @@ void contraction::parallel_fast_contract_clustering_multiple_threads_balls_and_b
 
         std::vector<NodeWeight> block_infos;
         block_infos.reserve(no_of_coarse_vertices);
-        parallel::submit_for_all(task, [&](auto& block_infos, auto&& cur_block_infos) {
-                if (block_infos.empty()) {
-                        block_infos.swap(cur_block_infos);
-                } else {
-                        for (size_t i = 0; i < no_of_coarse_vertices; ++i) {
-                                block_infos[i] += cur_block_infos[i];
+        {
+                SCOPED_TIMER("construct_hash_table");
+                parallel::submit_for_all(task, [&](auto& block_infos, auto&& cur_block_infos) {
+                        if (block_infos.empty()) {
+                                block_infos.swap(cur_block_infos);
+                        } else {
+                                for (size_t i = 0; i < no_of_coarse_vertices; ++i) {
+                                        block_infos[i] += cur_block_infos[i];
+                                }
                         }
-                }
-        }, block_infos);
-
-        CLOCK_END("Construct hash table and aux data");
+                }, block_infos);
+        }
 
-        CLOCK_START_N;
-        std::vector<EdgeID> offsets(no_of_coarse_vertices);
+        // all edges of a coarse node are stored in the hash table of source_cluster % num_threads
+        parallel::graph_builder builder(coarser, no_of_coarse_vertices, num_threads);
         auto task1 = [&](uint32_t thread_id) {
                 auto handle = new_edges[thread_id].getHandle();
-                EdgeID num_edges = 0;
                 for (auto it = handle.begin(); it != handle.end(); ++it) {
                         std::pair<NodeID, NodeID> edge = get_pair_from_uint64((*it).first);
-                        ++num_edges;
-                        ++offsets[edge.first];
+                        builder.add_degree(edge.first);
                 }
-                return num_edges;
         };
 
-
-        EdgeID num_edges = parallel::submit_for_all(task1,
-                                                    [](EdgeID num_edges, EdgeID cur_num_edges) {
-                                                            return num_edges + cur_num_edges;
-                                                    }, EdgeID(0));
-        std::cout << "num edges\t" << num_edges << std::endl;
-        CLOCK_END("Calculate offsets");
-
-        CLOCK_START_N;
-        NodeID last_node_degree = offsets.back();
         {
-                CLOCK_START;
-                parallel::partial_sum_open_interval(offsets.begin(), offsets.end(), offsets.begin(),
-                                                    partition_config.num_threads);
-                CLOCK_END("prefix sum");
+                SCOPED_TIMER("calculate_offsets");
+                parallel::submit_for_all(task1);
+                EdgeID num_edges = builder.compute_offsets();
+                std::cout << "num edges\t" << num_edges << std::endl;
+                parallel::parallel_for_index(NodeID(0), no_of_coarse_vertices, [&](NodeID node) {
+                        builder.set_node_weight(node, block_infos[node]);
+                });
         }
-        std::vector<Node> nodes(no_of_coarse_vertices + 1);
-        parallel::parallel_for_index(NodeID(0), no_of_coarse_vertices, [&](NodeID node) {
-                nodes[node].firstEdge = offsets[node];
-                nodes[node].weight = block_infos[node];
-        });
-        nodes.back().firstEdge = num_edges;
-        ALWAYS_ASSERT(num_edges == offsets.back() + last_node_degree);
-        CLOCK_END("Calculate prefix sum");
-
-        CLOCK_START_N;
-        std::vector<Edge> edges(num_edges);
+
         auto task2 = [&](uint32_t thread_id) {
                 auto handle = new_edges[thread_id].getHandle();
                 for (auto it = handle.begin(); it != handle.end(); ++it) {
                         std::pair < NodeID, NodeID > edge = get_pair_from_uint64((*it).first);
-                        auto edge_weight = (*it).second;
-                        edges[offsets[edge.first]].target = edge.second;
-                        edges[offsets[edge.first]].weight = edge_weight;
-                        ++offsets[edge.first];
+                        builder.set_edge(builder.claim_edge(edge.first), edge.second, (*it).second);
                 }
         };
 
-        parallel::submit_for_all(task2);
-
-        coarser.start_construction(nodes, edges);
-        ALWAYS_ASSERT(!partition_config.graph_allready_partitioned);
+        {
+                SCOPED_TIMER("make_edge_array");
+                parallel::submit_for_all(task2);
 
-        CLOCK_END("Calculate edges array");
+                if (partition_config.deterministic_parallel) {
+                        builder.sort_edges();
+                }
+                builder.finish();
+                ALWAYS_ASSERT(!partition_config.graph_allready_partitioned);
+        }
 
-        CLOCK_START_N;
+        SCOPED_TIMER("clean_hash_tables");
         auto task_clean_ht = [&](uint32_t thread_id) {
                 new_edges[thread_id].~concurrent_ht_type();
         };
         parallel::submit_for_all(task_clean_ht);
-        CLOCK_END("Clean hash tables");
 }
 
 void contraction::parallel_contract_matching(const PartitionConfig& partition_config,
@@ -550,15 +516,12 @@ void contraction::parallel_contract_matching(const PartitionConfig& partition_co
                                              const NodeID& no_of_coarse_vertices,
                                              const NodePermutationMap&) const {
         NodeID node_block_size = (NodeID) sqrt(G.number_of_nodes());
-        node_block_size = std::max(node_block_size, 1000u);
+        node_block_size = std::max<NodeID>(node_block_size, 1000);
 
-        CLOCK_START;
-        std::vector<EdgeID> offsets(no_of_coarse_vertices);
-        std::vector<NodeWeight> coarse_node_weights(no_of_coarse_vertices);
+        parallel::graph_builder builder(coarser, no_of_coarse_vertices, partition_config.num_threads);
         std::atomic<NodeID> offset(0);
         auto task1 = [&](uint32_t thread_id) {
                 parallel::hash_set<NodeID> common_neighbors(512);
-                EdgeID num_edges = 0;
                 while (true) {
                         NodeID begin = offset.fetch_add(node_block_size, std::memory_order_relaxed);
                         NodeID end = begin + node_block_size;
@@ -586,76 +549,28 @@ void contraction::parallel_contract_matching(const PartitionConfig& partition_co
                                                 }
                                         } endfor
 
-                                        coarse_node_weights[coarse_mapping[node]] = G.getNodeWeight(node) + G.getNodeWeight(matched);
+                                        builder.set_node_weight(coarse_mapping[node], G.getNodeWeight(node) + G.getNodeWeight(matched));
                                 } else if (node == matched) {
                                         forall_out_edges(G, e, node) {
                                                 NodeID target = G.getEdgeTarget(e);
                                                 common_neighbors.insert(coarse_mapping[target]);
                                         } endfor
-                                        coarse_node_weights[coarse_mapping[node]] = G.getNodeWeight(node);
+                                        builder.set_node_weight(coarse_mapping[node], G.getNodeWeight(node));
                                 } else {
                                         continue;
                                 }
                                 degree = common_neighbors.size();
                                 common_neighbors.clear();
-                                offsets[coarse_mapping[node]] = degree;
-                                num_edges += degree;
+                                builder.set_degree(coarse_mapping[node], degree);
                         }
                 }
-                return num_edges;
         };
 
-        EdgeID num_edges = 0;
         {
-                CLOCK_START;
-                num_edges = parallel::submit_for_all(task1,
-                                                     [](EdgeID num_edges, EdgeID cur_num_edges) {
-                                                             return num_edges + cur_num_edges;
-                                                     }, EdgeID(0));
-                CLOCK_END("par");
+                SCOPED_TIMER("calculate_offsets");
+                parallel::submit_for_all(task1);
+                builder.compute_offsets();
         }
-        CLOCK_END("Calculate offsets");
-
-
-        CLOCK_START_N;
-        NodeID last_node_degree = offsets.back();
-        {
-                CLOCK_START;
-                parallel::partial_sum_open_interval(offsets.begin(), offsets.end(), offsets.begin(),
-                                                    partition_config.num_threads);
-                CLOCK_END("prefix sum");
-        }
-        std::vector<Node> nodes(no_of_coarse_vertices + 1);
-        parallel::parallel_for_index(NodeID(0), no_of_coarse_vertices, [&](NodeID node) {
-                nodes[node].firstEdge = offsets[node];
-                nodes[node].weight = coarse_node_weights[node];
-        });
-        nodes.back().firstEdge = num_edges;
-        ALWAYS_ASSERT(num_edges == offsets.back() + last_node_degree);
-        CLOCK_END("Calculate prefix sum");
-
-//        CLOCK_START_N;
-//        std::vector<Node> nodes(no_of_coarse_vertices + 1);
-//        {
-//                CLOCK_START;
-//                EdgeID cur_prefix = 0;
-//                for (size_t i = 0; i < no_of_coarse_vertices; ++i) {
-//                        EdgeID cur_offset = offsets[i];
-//
-//                        offsets[i] = cur_prefix;
-//                        nodes[i].firstEdge = cur_prefix;
-//                        nodes[i].weight = coarse_node_weights[i];
-//
-//                        cur_prefix += cur_offset;
-//                }
-//                nodes.back().firstEdge = cur_prefix;
-//                CLOCK_END("prefix sum");
-//        }
-//        CLOCK_END("Calculate prefix sum");
-
-        CLOCK_START_N;
-        std::vector<Edge> edges(num_edges);
-        CLOCK_END("Init edge array");
 
         offset.store(0, std::memory_order_relaxed);
         auto task2 = [&](uint32_t thread_id) {
@@ -694,24 +609,134 @@ void contraction::parallel_contract_matching(const PartitionConfig& partition_co
                                         continue;
                                 }
 
-                                NodeID coarse_node = coarse_mapping[node];
+                                EdgeID e = builder.first_edge(coarse_mapping[node]);
                                 for (const auto& record : common_neighbors) {
-                                        edges[offsets[coarse_node]].target = record.first;
-                                        edges[offsets[coarse_node]].weight = record.second;
-                                        ++offsets[coarse_node];
+                                        builder.set_edge(e++, record.first, record.second);
                                 }
                                 common_neighbors.clear();
                         }
                 }
         };
 
-        CLOCK_START_N;
+        SCOPED_TIMER("make_edge_array");
         parallel::submit_for_all(task2);
-        CLOCK_END("Make edge array");
+        builder.finish();
+}
+
+void contraction::parallel_contract_clustering_by_members(const PartitionConfig& partition_config,
+                                                          graph_access& G,
+                                                          graph_access& coarser,
+                                                          const CoarseMapping& coarse_mapping,
+                                                          const NodeID& no_of_coarse_vertices) const {
+        // the members of cluster c are members[cluster_begin[c]] to members[cluster_begin[c + 1] - 1]
+        std::vector<NodeID> members(G.number_of_nodes());
+        std::vector<NodeID> cluster_begin(no_of_coarse_vertices + 1);
+        {
+                SCOPED_TIMER("group_members");
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                        members[node] = node;
+                });
+                parallel::sort(members.begin(), members.end(), [&](NodeID lhs, NodeID rhs) {
+                        return coarse_mapping[lhs] < coarse_mapping[rhs] ||
+                               (coarse_mapping[lhs] == coarse_mapping[rhs] && lhs < rhs);
+                }, partition_config.num_threads);
+
+                // the cluster ids are 0 to no_of_coarse_vertices - 1 and no cluster is empty
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID i) {
+                        if (i == 0 || coarse_mapping[members[i]] != coarse_mapping[members[i - 1]]) {
+                                cluster_begin[coarse_mapping[members[i]]] = i;
+                        }
+                });
+                cluster_begin.back() = G.number_of_nodes();
+        }
+
+        NodeID cluster_block_size = (NodeID) sqrt(no_of_coarse_vertices);
+        cluster_block_size = std::max<NodeID>(cluster_block_size, 1000);
 
-        CLOCK_START_N;
-        coarser.start_construction(nodes, edges);
-        CLOCK_END("Make graph");
+        parallel::graph_builder builder(coarser, no_of_coarse_vertices, partition_config.num_threads);
+        std::atomic<NodeID> offset(0);
+        auto task1 = [&](uint32_t thread_id) {
+                parallel::hash_set<NodeID> neighbors(512);
+                NodeID begin = offset.fetch_add(cluster_block_size, std::memory_order_relaxed);
+                while (begin < no_of_coarse_vertices) {
+                        NodeID end = std::min(begin + cluster_block_size, no_of_coarse_vertices);
+
+                        for (NodeID cluster = begin; cluster != end; ++cluster) {
+                                NodeWeight weight = 0;
+                                for (NodeID i = cluster_begin[cluster]; i != cluster_begin[cluster + 1]; ++i) {
+                                        NodeID node = members[i];
+                                        weight += G.getNodeWeight(node);
+                                        forall_out_edges(G, e, node) {
+                                                NodeID target_cluster = coarse_mapping[G.getEdgeTarget(e)];
+                                                if (target_cluster != cluster) {
+                                                        neighbors.insert(target_cluster);
+                                                }
+                                        } endfor
+                                }
+                                builder.set_node_weight(cluster, weight);
+                                builder.set_degree(cluster, neighbors.size());
+                                neighbors.clear();
+                        }
+                        begin = offset.fetch_add(cluster_block_size, std::memory_order_relaxed);
+                }
+        };
+
+        {
+                SCOPED_TIMER("calculate_offsets");
+                parallel::submit_for_all(task1);
+                builder.compute_offsets();
+        }
+
+        offset.store(0, std::memory_order_relaxed);
+        auto task2 = [&](uint32_t thread_id) {
+                parallel::hash_map<NodeID, EdgeWeight> neighbors(512);
+                NodeID begin = offset.fetch_add(cluster_block_size, std::memory_order_relaxed);
+                while (begin < no_of_coarse_vertices) {
+                        NodeID end = std::min(begin + cluster_block_size, no_of_coarse_vertices);
+
+                        for (NodeID cluster = begin; cluster != end; ++cluster) {
+                                for (NodeID i = cluster_begin[cluster]; i != cluster_begin[cluster + 1]; ++i) {
+                                        NodeID node = members[i];
+                                        forall_out_edges(G, e, node) {
+                                                NodeID target_cluster = coarse_mapping[G.getEdgeTarget(e)];
+                                                if (target_cluster != cluster) {
+                                                        neighbors[target_cluster] += G.getEdgeWeight(e);
+                                                }
+                                        } endfor
+                                }
+
+                                EdgeID e = builder.first_edge(cluster);
+                                for (const auto& record : neighbors) {
+                                        builder.set_edge(e++, record.first, record.second);
+                                }
+                                neighbors.clear();
+                        }
+                        begin = offset.fetch_add(cluster_block_size, std::memory_order_relaxed);
+                }
+        };
+
+        {
+                SCOPED_TIMER("make_edge_array");
+                parallel::submit_for_all(task2);
+                if (partition_config.deterministic_parallel) {
+                        builder.sort_edges();
+                }
+                builder.finish();
+        }
+
+        // a cluster lies in one block, so its first member gives the block of the coarse node
+        if (partition_config.graph_allready_partitioned || partition_config.combine) {
+                if (partition_config.combine) {
+                        coarser.resizeSecondPartitionIndex(no_of_coarse_vertices);
+                }
+                parallel::parallel_for_index(NodeID(0), no_of_coarse_vertices, [&](NodeID cluster) {
+                        NodeID node = members[cluster_begin[cluster]];
+                        coarser.setPartitionIndex(cluster, G.getPartitionIndex(node));
+                        if (partition_config.combine) {
+                                coarser.setSecondPartitionIndex(cluster, G.getSecondPartitionIndex(node));
+                        }
+                });
+        }
 }
 
 void contraction::fast_contract_clustering(const PartitionConfig& partition_config,
@@ -725,7 +750,6 @@ void contraction::fast_contract_clustering(const PartitionConfig& partition_conf
                 coarser.resizeSecondPartitionIndex(no_of_coarse_vertices);
         }
 
-        CLOCK_START;
         std::vector<NodeWeight> block_infos(no_of_coarse_vertices);
 
         // build set of new edges
@@ -733,26 +757,28 @@ void contraction::fast_contract_clustering(const PartitionConfig& partition_conf
         size_t num_cut_edges = std::min<size_t>(avg_degree * no_of_coarse_vertices, G.number_of_edges() / 2);
         parallel::HashMap<uint64_t, EdgeWeight, parallel::MurmurHash<uint64_t>, true> new_edges(num_cut_edges);
 
-        forall_nodes(G, n) {
-                PartitionID source_cluster = coarse_mapping[n];
-                block_infos[source_cluster] += G.getNodeWeight(n);
-
-                forall_out_edges(G, e, n){
-                        NodeID targetID = G.getEdgeTarget(e);
-                        PartitionID target_cluster = coarse_mapping[targetID];
-                        bool is_cut_edge = source_cluster != target_cluster;
-
-                        if (is_cut_edge) {
-                                new_edges[get_uint64_from_pair_sorted(source_cluster, target_cluster)] +=
-                                        G.getEdgeWeight(e);
-                        }
+        {
+                SCOPED_TIMER("construct_hash_table");
+                forall_nodes(G, n) {
+                        NodeID source_cluster = coarse_mapping[n];
+                        block_infos[source_cluster] += G.getNodeWeight(n);
+
+                        forall_out_edges(G, e, n){
+                                NodeID targetID = G.getEdgeTarget(e);
+                                NodeID target_cluster = coarse_mapping[targetID];
+                                bool is_cut_edge = source_cluster != target_cluster;
+
+                                if (is_cut_edge) {
+                                        new_edges[get_uint64_from_pair_sorted(source_cluster, target_cluster)] +=
+                                                G.getEdgeWeight(e);
+                                }
+                        } endfor
                 } endfor
-        } endfor
-        CLOCK_END("Construct hash table and aux data");
+        }
 
         // construct graph
-        CLOCK_START_N;
-        std::vector<std::vector<std::pair<PartitionID, EdgeWeight>>> building_tool(no_of_coarse_vertices);
+        SCOPED_TIMER("construct_graph");
+        std::vector<std::vector<std::pair<NodeID, EdgeWeight>>> building_tool(no_of_coarse_vertices);
         for (auto& data : building_tool) {
                 data.reserve(avg_degree);
         }
@@ -786,7 +812,6 @@ void contraction::fast_contract_clustering(const PartitionConfig& partition_conf
                         }
                 } endfor
         }
-        CLOCK_END("Construct graph");
 }
 
 // for documentation see technical reports of christian schulz  
@@ -93,7 +93,7 @@ private:
                 NodeID target;
                 EdgeWeight weight;
 
-                edge_type(uint32_t _source, uint32_t _target, NodeWeight _weight)
+                edge_type(NodeID _source, NodeID _target, EdgeWeight _weight)
                         : source(_source), target(_target), weight(_weight) {}
 
                 bool operator<(const edge_type& other) {
@@ -125,6 +125,13 @@ private:
                 return std::make_pair(first, second);
         }
 
+        // contracts a clustering without packing cluster ids into 64bit keys, it supports any number of coarse vertices
+        void parallel_contract_clustering_by_members(const PartitionConfig& partition_config,
+                                                     graph_access& G,
+                                                     graph_access& coarser,
+                                                     const CoarseMapping& coarse_mapping,
+                                                     const NodeID& no_of_coarse_vertices) const;
+
         void parallel_fast_contract_clustering_multiple_threads_balls_and_bins_ht(
                 const PartitionConfig& partition_config,
                 graph_access& G,
@@ -38,6 +38,9 @@ edge_ratings::~edge_ratings() {
 }
 
 void edge_ratings::rate(graph_access & G, unsigned level) {
+        // the matchers read the ratings even if they are not computed below
+        G.allocate_edge_ratings();
+
         //rate the edges
         if(level == 0 && partition_config.first_level_random_matching) {
                 return;
@@ -96,7 +96,7 @@ void gpa_matching::match(const PartitionConfig & partition_config,
                 pathset.add_if_applicable(source, curEdge);
         } endfor 
 
-        extract_paths_apply_matching(G, sources, edge_matching, pathset); 
+        extract_paths_apply_matching(G, sources, edge_matching, pathset, 0, G.number_of_nodes()); 
 
         // all matched pairs are now in edge_matching 
         // now construct the coarsemapping
@@ -177,7 +177,9 @@ void gpa_matching::init(graph_access & G,
 void gpa_matching::extract_paths_apply_matching(graph_access & G, 
                                                 std::vector<NodeID> & sources,
                                                 Matching & edge_matching, 
-                                                path_set & pathset) {
+                                                path_set & pathset,
+                                                NodeID begin,
+                                                NodeID end) {
         // extract the paths in the path set into lists of edges.
         // then, apply the dynamic programming max weight function to them. Apply 
         // the matched edges.
@@ -185,7 +187,7 @@ void gpa_matching::extract_paths_apply_matching(graph_access & G,
         a_matching.reserve(100);
         unpacked_path.reserve(100);
 
-        forall_nodes(G, n) {
+        for (NodeID n = begin; n < end; n++) {
                 const path & p = pathset.get_path(n);
 
                 if(not p.is_active()) {
@@ -266,7 +268,7 @@ void gpa_matching::extract_paths_apply_matching(graph_access & G,
                         //apply matched edges
                         apply_matching(G, a_matching, sources, edge_matching); 
                 } 
-        } endfor
+        }
 }
 
 
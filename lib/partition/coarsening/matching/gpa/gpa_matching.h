@@ -38,6 +38,16 @@ class gpa_matching : public matching{
                                 CoarseMapping & coarse_mapping, 
                                 NodeID & no_of_coarse_vertices,
                                 NodePermutationMap & permutation);
+
+                // extracts the paths and cycles of pathset whose tail lies in [begin, end), computes an optimal
+                // matching on each of them and applies it to edge_matching. uses the buffers of this object,
+                // concurrent calls on disjoint node ranges need an object each.
+                void extract_paths_apply_matching( graph_access & G, 
+                                                   std::vector<NodeID> & sources,
+                                                   Matching & edge_matching, 
+                                                   path_set & pathset,
+                                                   NodeID begin,
+                                                   NodeID end); 
         private:
                 std::vector<EdgeRatingType> ratings;
                 std::vector< bool > decision;
@@ -51,11 +61,6 @@ class gpa_matching : public matching{
                           std::vector<std::pair<EdgeID, EdgeRatingType>>  & edge_permutation,
                           std::vector<NodeID> & sources);
 
-                void extract_paths_apply_matching( graph_access & G, 
-                                                   std::vector<NodeID> & sources,
-                                                   Matching & edge_matching, 
-                                                   path_set & pathset); 
-
                 template <typename VectorOrDeque> 
                         void unpack_path(const path & the_path, 
                                          const path_set & pathset,  
@@ -0,0 +1,175 @@
+#include "data_structure/parallel/algorithm.h"
+#include "data_structure/parallel/hash_function.h"
+#include "data_structure/parallel/thread_pool.h"
+#include "gpa_matching.h"
+#include "parallel_gpa_matching.h"
+#include "tools/instrumentation.h"
+
+#include <algorithm>
+
+void parallel_gpa_matching::match(const PartitionConfig& partition_config,
+                                  graph_access& G,
+                                  Matching& edge_matching,
+                                  CoarseMapping& coarse_mapping,
+                                  NodeID& no_of_coarse_vertices,
+                                  NodePermutationMap& permutation) {
+        PRINT(std::cout << "matching using parallel gpa" << std::endl;)
+        permutation.resize(G.number_of_nodes());
+        edge_matching.resize(G.number_of_nodes());
+        coarse_mapping.resize(G.number_of_nodes());
+
+        const uint32_t num_threads = parallel::g_thread_pool.NumThreads() + 1;
+        const NodeID n = G.number_of_nodes();
+        auto range_begin = [&](uint32_t thread_id) {
+                return (NodeID) ((uint64_t) n * thread_id / num_threads);
+        };
+
+        std::vector<NodeID> sources(G.number_of_edges());
+        std::vector<NodeID> range_of_node(n);
+        std::vector<std::vector<rated_edge>> local_edges(num_threads);
+        std::vector<std::vector<rated_edge>> gap_edges(num_threads);
+
+        {
+                SCOPED_TIMER("rate_and_sort_local_edges");
+                parallel::submit_for_all([&](uint32_t thread_id) {
+                        for (NodeID node = range_begin(thread_id); node < range_begin(thread_id + 1); ++node) {
+                                permutation[node]   = node;
+                                edge_matching[node] = node;
+                                range_of_node[node] = thread_id;
+                                forall_out_edges(G, e, node) {
+                                        sources[e] = node;
+                                        if (partition_config.edge_rating == WEIGHT) {
+                                                // in that case we need to copy it
+                                                G.setEdgeRating(e, G.getEdgeWeight(e));
+                                        }
+                                } endfor
+                        }
+                });
+
+                parallel::MurmurHash<uint64_t> hash(partition_config.seed);
+                parallel::submit_for_all([&](uint32_t thread_id) {
+                        for (NodeID node = range_begin(thread_id); node < range_begin(thread_id + 1); ++node) {
+                                forall_out_edges(G, e, node) {
+                                        if (!is_candidate(partition_config, G, node, e)) {
+                                                continue;
+                                        }
+                                        uint64_t tiebreak = partition_config.edge_rating_tiebreaking ? hash(e) : e;
+                                        rated_edge edge = {G.getEdgeRating(e), tiebreak, e};
+                                        if (range_of_node[G.getEdgeTarget(e)] == thread_id) {
+                                                local_edges[thread_id].push_back(edge);
+                                        } else {
+                                                gap_edges[thread_id].push_back(edge);
+                                        }
+                                } endfor
+                        }
+                        std::sort(local_edges[thread_id].begin(), local_edges[thread_id].end(), higher_rating);
+                });
+        }
+
+        path_set pathset(&G, &partition_config);
+
+        // both endpoints of a local edge lie in the range of the thread, so are all nodes of the paths it
+        // touches. the threads work on disjoint parts of the path set.
+        {
+                SCOPED_TIMER("grow_local_paths");
+                parallel::submit_for_all([&](uint32_t thread_id) {
+                        for (const rated_edge& edge : local_edges[thread_id]) {
+                                pathset.add_if_applicable(sources[edge.edge], edge.edge);
+                        }
+                        std::vector<rated_edge>().swap(local_edges[thread_id]);
+                });
+        }
+
+        {
+                SCOPED_TIMER("grow_gap_paths");
+                std::vector<size_t> gap_offsets(num_threads + 1, 0);
+                for (uint32_t thread_id = 0; thread_id < num_threads; ++thread_id) {
+                        gap_offsets[thread_id + 1] = gap_offsets[thread_id] + gap_edges[thread_id].size();
+                }
+                std::vector<rated_edge> all_gap_edges(gap_offsets.back());
+                parallel::submit_for_all([&](uint32_t thread_id) {
+                        std::copy(gap_edges[thread_id].begin(), gap_edges[thread_id].end(),
+                                  all_gap_edges.begin() + gap_offsets[thread_id]);
+                        std::vector<rated_edge>().swap(gap_edges[thread_id]);
+                });
+                parallel::sort(all_gap_edges.begin(), all_gap_edges.end(), higher_rating, num_threads);
+
+                // an edge is only applicable if both endpoints are endpoints of paths, so most gap edges are
+                // rejected in constant time
+                for (const rated_edge& edge : all_gap_edges) {
+                        pathset.add_if_applicable(sources[edge.edge], edge.edge);
+                }
+        }
+
+        // every path is handled by the thread owning its tail, the matched nodes of different paths are
+        // disjoint
+        {
+                SCOPED_TIMER("match_paths");
+                std::vector<gpa_matching> workers(num_threads);
+                parallel::submit_for_all([&](uint32_t thread_id) {
+                        workers[thread_id].extract_paths_apply_matching(G, sources, edge_matching, pathset,
+                                                                        range_begin(thread_id), range_begin(thread_id + 1));
+                });
+        }
+
+        {
+                SCOPED_TIMER("coarse_mapping");
+                compute_coarse_mapping(partition_config, G, edge_matching, coarse_mapping, no_of_coarse_vertices);
+        }
+}
+
+bool parallel_gpa_matching::is_candidate(const PartitionConfig& partition_config, graph_access& G,
+                                         NodeID source, EdgeID e) const {
+        NodeID target = G.getEdgeTarget(e);
+        if (target < source) {
+                // get rid of double edges
+                return false;
+        }
+
+        if (G.getEdgeRating(e) == 0.0) {
+                return false;
+        }
+
+        //max vertex weight constraint
+        if (G.getNodeWeight(source) + G.getNodeWeight(target) > partition_config.max_vertex_weight) {
+                return false;
+        }
+
+        if (partition_config.combine && G.getSecondPartitionIndex(source) != G.getSecondPartitionIndex(target)) {
+                return false;
+        }
+        return true;
+}
+
+void parallel_gpa_matching::compute_coarse_mapping(const PartitionConfig& partition_config,
+                                                   graph_access& G,
+                                                   Matching& edge_matching,
+                                                   CoarseMapping& coarse_mapping,
+                                                   NodeID& no_of_coarse_vertices) const {
+        // v cycle... matched nodes of different blocks shouldnt be contracted. both nodes of such a pair
+        // see the same blocks and unmatch themselves.
+        parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                NodeID partner = edge_matching[node];
+                if (partition_config.graph_allready_partitioned
+                    && G.getPartitionIndex(node) != G.getPartitionIndex(partner)) {
+                        edge_matching[node] = node;
+                }
+                if (partition_config.combine
+                    && G.getSecondPartitionIndex(node) != G.getSecondPartitionIndex(partner)) {
+                        edge_matching[node] = node;
+                }
+        });
+
+        // the smaller node of a pair gets the next coarse id, as in gpa_matching
+        std::vector<NodeID> first_of_pair(G.number_of_nodes());
+        parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                first_of_pair[node] = node <= edge_matching[node];
+        });
+        parallel::partial_sum(first_of_pair.begin(), first_of_pair.end(), first_of_pair.begin(),
+                              partition_config.num_threads);
+
+        parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                coarse_mapping[node] = first_of_pair[std::min(node, edge_matching[node])] - 1;
+        });
+        no_of_coarse_vertices = G.number_of_nodes() > 0 ? first_of_pair.back() : 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "coarsening/matching/matching.h"
+#include "path_set.h"
+
+// Parallel variant of gpa_matching. The nodes are split into one contiguous range per thread. Every thread
+// sorts the edges inside its range by rating and grows paths and cycles from them. The edges between
+// ranges are sorted in parallel and added afterwards in one sequential sweep. At last, every thread
+// computes the optimal matchings of the paths with a tail in its range.
+class parallel_gpa_matching : public matching {
+public:
+        void match(const PartitionConfig& partition_config,
+                   graph_access& G,
+                   Matching& edge_matching,
+                   CoarseMapping& coarse_mapping,
+                   NodeID& no_of_coarse_vertices,
+                   NodePermutationMap& permutation) override;
+
+        virtual ~parallel_gpa_matching() {}
+
+private:
+        struct rated_edge {
+                EdgeRatingType rating;
+                // random tie breaking, the edge id if it is disabled
+                uint64_t tiebreak;
+                EdgeID edge;
+        };
+
+        static bool higher_rating(const rated_edge& lhs, const rated_edge& rhs) {
+                return lhs.rating > rhs.rating || (lhs.rating == rhs.rating && lhs.tiebreak < rhs.tiebreak);
+        }
+
+        // the edges of the path set in one direction with the constraints of gpa_matching
+        bool is_candidate(const PartitionConfig& partition_config, graph_access& G, NodeID source, EdgeID e) const;
+
+        void compute_coarse_mapping(const PartitionConfig& partition_config,
+                                    graph_access& G,
+                                    Matching& edge_matching,
+                                    CoarseMapping& coarse_mapping,
+                                    NodeID& no_of_coarse_vertices) const;
+};
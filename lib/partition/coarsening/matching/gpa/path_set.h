@@ -23,6 +23,8 @@
 #ifndef PATH_SET_80E9CQT1
 #define PATH_SET_80E9CQT1
 
+#include <atomic>
+
 #include "data_structure/graph_access.h"
 #include "macros_assertions.h"
 #include "partition_config.h"
@@ -65,8 +67,9 @@ class path_set {
                 const PartitionConfig * config;
 
 
-                // Number of Paths
-                PathID m_no_of_paths;
+                // Number of Paths. add_if_applicable may be called concurrently for edges whose endpoints
+                // lie in disjoint sets of paths, only this counter is shared.
+                std::atomic<PathID> m_no_of_paths;
 
                 // for every vertex v, vertex_to_path[v] is the id of the path
                 std::vector<PathID> m_vertex_to_path;
@@ -106,7 +109,7 @@ inline const path& path_set::get_path(const NodeID & v) const {
 }
 
 inline PathID path_set::path_count() const {
-        return m_no_of_paths;
+        return m_no_of_paths.load(std::memory_order_relaxed);
 }
 
 inline NodeID path_set::next_vertex( const NodeID & v ) const {
@@ -167,7 +170,7 @@ inline bool path_set::add_if_applicable(const NodeID & source, const EdgeID & e)
         if(sourcePathID != targetPathID) {
                 // then we wont close a cycle, and we will join the paths
                 // else case handles cycles
-                m_no_of_paths--;
+                m_no_of_paths.fetch_sub(1, std::memory_order_relaxed);
                 source_path.set_length(source_path.get_length() + target_path.get_length() + 1);
 
                 // first we update the path data structure
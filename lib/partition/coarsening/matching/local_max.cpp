@@ -1,7 +1,7 @@
 #include "data_structure/parallel/hash_function.h"
 #include "coarsening/matching/local_max.h"
 #include "data_structure/parallel/thread_pool.h"
-#include "data_structure/parallel/time.h"
+#include "tools/instrumentation.h"
 
 #include <tbb/concurrent_queue.h>
 
@@ -22,6 +22,11 @@ void local_max_matching::match(const PartitionConfig& partition_config,
                                          permutation);
                         break;
                 case MATCHING_PARALLEL_LOCAL_MAX:
+                        if (partition_config.deterministic_parallel) {
+                                parallel_match_deterministic(partition_config, G, edge_matching, mapping,
+                                                             no_of_coarse_vertices);
+                                break;
+                        }
                         // with queue is slower since we do not process vertices in increasing order of their degree
                         // and shuffle them
                         if (!partition_config.remove_edges_in_matching) {
@@ -45,77 +50,74 @@ void local_max_matching::sequential_match(const PartitionConfig& partition_confi
                                           CoarseMapping& mapping,
                                           NodeID& no_of_coarse_vertices,
                                           NodePermutationMap& permutation) {
-        std::cout << "MAX VERTEX WEIGHT = " << partition_config.max_vertex_weight << std::endl;
-        CLOCK_START;
         std::vector<std::pair<NodeID, uint32_t>> max_neighbours;
-
-        permutation.clear();
-        permutation.reserve(G.number_of_nodes());
-        edge_matching.reserve(G.number_of_nodes());
-        max_neighbours.reserve(G.number_of_nodes());
-
-        for (size_t i = 0; i < G.number_of_nodes(); ++i) {
-                permutation.push_back(i);
-                edge_matching.push_back(i);
-                max_neighbours.emplace_back(i, 0);
-        }
-        std::random_shuffle(permutation.begin(), permutation.end());
-
         // need two queues to save max_neighbour in array
         std::unique_ptr<std::queue<NodeID>> node_queue = std::make_unique<std::queue<NodeID>>();
         std::unique_ptr<std::queue<NodeID>> node_queue_next = std::make_unique<std::queue<NodeID>>();
-        for (NodeID node : permutation) {
-                node_queue->push(node);
-        }
         random rnd(partition_config.seed);
-        CLOCK_END("Coarsening: Matching: Init");
 
-        CLOCK_START_N;
+        {
+                SCOPED_TIMER("init");
+                permutation.clear();
+                permutation.reserve(G.number_of_nodes());
+                edge_matching.reserve(G.number_of_nodes());
+                max_neighbours.reserve(G.number_of_nodes());
+
+                for (size_t i = 0; i < G.number_of_nodes(); ++i) {
+                        permutation.push_back(i);
+                        edge_matching.push_back(i);
+                        max_neighbours.emplace_back(i, 0);
+                }
+                std::random_shuffle(permutation.begin(), permutation.end());
+
+                for (NodeID node : permutation) {
+                        node_queue->push(node);
+                }
+        }
+
         uint32_t round = 1;
         uint32_t threshold = (uint32_t) (2.0 * G.number_of_nodes() / 3.0);
         uint32_t remaining_vertices = G.number_of_nodes();
-        while (!node_queue->empty() && round < m_max_round + 1 && remaining_vertices > threshold) {
-                std::cout << round - 1 << std::endl;
-                std::cout << remaining_vertices << std::endl;
-                CLOCK_START;
-                while (!node_queue->empty()) {
-                        NodeID node = node_queue->front();
-                        node_queue->pop();
-
-                        // already mathed
-                        if (edge_matching[node] != node) {
-                                continue;
-                        }
+        {
+                SCOPED_TIMER("rounds");
+                while (!node_queue->empty() && round < m_max_round + 1 && remaining_vertices > threshold) {
+                        while (!node_queue->empty()) {
+                                NodeID node = node_queue->front();
+                                node_queue->pop();
+
+                                // already mathed
+                                if (edge_matching[node] != node) {
+                                        continue;
+                                }
 
-                        NodeID max_neighbour = find_max_neighbour_sequential(node, round, G, partition_config,
-                                                                             max_neighbours, edge_matching, rnd);
+                                NodeID max_neighbour = find_max_neighbour_sequential(node, round, G, partition_config,
+                                                                                     max_neighbours, edge_matching, rnd);
 
-                        if (max_neighbour == m_none) {
-                                continue;
-                        }
+                                if (max_neighbour == m_none) {
+                                        continue;
+                                }
 
 
-                        NodeID max_neighbour_neighbour = find_max_neighbour_sequential(max_neighbour, round, G,
-                                                                                       partition_config, max_neighbours,
-                                                                                       edge_matching, rnd);
+                                NodeID max_neighbour_neighbour = find_max_neighbour_sequential(max_neighbour, round, G,
+                                                                                               partition_config, max_neighbours,
+                                                                                               edge_matching, rnd);
 
-                        if (max_neighbour_neighbour == node) {
-                                // match
-                                edge_matching[node] = max_neighbour;
-                                edge_matching[max_neighbour] = node;
-                                --remaining_vertices;
-                        } else {
-                                node_queue_next->push(node);
+                                if (max_neighbour_neighbour == node) {
+                                        // match
+                                        edge_matching[node] = max_neighbour;
+                                        edge_matching[max_neighbour] = node;
+                                        --remaining_vertices;
+                                } else {
+                                        node_queue_next->push(node);
+                                }
                         }
+                        ++round;
+                        std::swap(node_queue, node_queue_next);
                 }
-                ++round;
-                std::swap(node_queue, node_queue_next);
-                CLOCK_END("Round time");
         }
-        std::cout << remaining_vertices << std::endl;
-        CLOCK_END("Coarsening: Matching: Main");
+        INSTRUMENTATION_COUNT("local_max_matching/rounds", round - 1);
 
-        CLOCK_START_N;
+        SCOPED_TIMER("remap");
         no_of_coarse_vertices = 0;
         mapping.resize(G.number_of_edges());
         for (NodeID i = 0; i < permutation.size(); ++i) {
@@ -126,8 +128,6 @@ void local_max_matching::sequential_match(const PartitionConfig& partition_confi
                         ++no_of_coarse_vertices;
                 }
         }
-        std::cout << no_of_coarse_vertices << std::endl;
-        CLOCK_END("Coarsening: Matching: Remap");
 }
 
 void local_max_matching::parallel_match_with_queue(const PartitionConfig& partition_config,
@@ -137,28 +137,29 @@ void local_max_matching::parallel_match_with_queue(const PartitionConfig& partit
                                         NodeID& no_of_coarse_vertices) {
 
         // init
-        CLOCK_START;
         uint32_t num_threads = partition_config.num_threads;
 
         parallel::ParallelVector<AtomicWrapper<int>> vertex_mark(G.number_of_nodes());
         parallel::ParallelVector<atomic_pair_type> max_neighbours(G.number_of_nodes());
         parallel::ParallelVector<NodeID> permutation(G.number_of_nodes());
 
-        parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
-                vertex_mark[node] = MatchingPhases::NOT_STARTED;
-                new (max_neighbours.begin() + node) atomic_pair_type(0, 0);
-                permutation[node] = node;
-        });
-
-        edge_matching.reserve(G.number_of_nodes());
-        for (NodeID i = 0; i < G.number_of_nodes(); ++i) {
-                edge_matching.push_back(i);
+        {
+                SCOPED_TIMER("init");
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                        vertex_mark[node] = MatchingPhases::NOT_STARTED;
+                        new (max_neighbours.begin() + node) atomic_pair_type(0, 0);
+                        permutation[node] = node;
+                });
+
+                edge_matching.reserve(G.number_of_nodes());
+                for (NodeID i = 0; i < G.number_of_nodes(); ++i) {
+                        edge_matching.push_back(i);
+                }
         }
 
         {
-                CLOCK_START;
+                SCOPED_TIMER("shuffle");
                 parallel::random_shuffle(permutation.begin(), permutation.end(), partition_config.num_threads);
-                CLOCK_END("Shuffle");
         }
 
         Cvector<random> randoms;
@@ -173,33 +174,35 @@ void local_max_matching::parallel_match_with_queue(const PartitionConfig& partit
         const size_t block_size_edges = std::max((uint32_t) sqrt(G.number_of_edges()), 1000u);
         std::atomic<NodeID> offset(0);
         const NodeID block_size = std::max<NodeID>(sqrt(permutation.size()), 1000);
-        parallel::submit_for_all([&]() {
-                block_type block;
-                block.reserve(block_size_edges);
-                size_t cur_block_size = 0;
-                NodeID begin = offset.fetch_add(block_size, std::memory_order_relaxed);
-
-                while (begin < permutation.size()) {
-                        NodeID end = std::min<NodeID>(begin + block_size, permutation.size());
-                        for (NodeID node = begin; node != end; ++node) {
-                                block.push_back(node);
-                                cur_block_size += G.getNodeDegree(node);
-                                if (cur_block_size >= block_size_edges) {
-                                        node_queue->push(std::move(block));
-                                        block.clear();
-                                        block.reserve(block_size_edges);
-                                        cur_block_size = 0;
+        {
+                SCOPED_TIMER("fill_queue");
+                parallel::submit_for_all([&]() {
+                        block_type block;
+                        block.reserve(block_size_edges);
+                        size_t cur_block_size = 0;
+                        NodeID begin = offset.fetch_add(block_size, std::memory_order_relaxed);
+
+                        while (begin < permutation.size()) {
+                                NodeID end = std::min<NodeID>(begin + block_size, permutation.size());
+                                for (NodeID node = begin; node != end; ++node) {
+                                        block.push_back(node);
+                                        cur_block_size += G.getNodeDegree(node);
+                                        if (cur_block_size >= block_size_edges) {
+                                                node_queue->push(std::move(block));
+                                                block.clear();
+                                                block.reserve(block_size_edges);
+                                                cur_block_size = 0;
+                                        }
                                 }
-                        }
-                        begin = offset.fetch_add(block_size, std::memory_order_relaxed);
+                                begin = offset.fetch_add(block_size, std::memory_order_relaxed);
 
-                }
-                if (!block.empty()) {
-                        node_queue->push(std::move(block));
-                }
-        });
+                        }
+                        if (!block.empty()) {
+                                node_queue->push(std::move(block));
+                        }
+                });
+        }
 
-        CLOCK_END("Coarsening: Matching: Init");
         uint32_t round = 1;
 
         auto task = [&](uint32_t id) {
@@ -258,34 +261,28 @@ void local_max_matching::parallel_match_with_queue(const PartitionConfig& partit
                 return matched_vertices;
         };
 
-        CLOCK_START_N;
         // add loop for rounds with two queues
         std::vector<std::future<NodeID>> futures;
         futures.reserve(num_threads);
         NodeID coarse_vertices = G.number_of_nodes();
-        while (!node_queue->empty()) {
-                std::cout << round - 1 << std::endl;
-                std::cout << coarse_vertices << std::endl;
-
-                NodeID old_coarse_vertices = coarse_vertices;
-                CLOCK_START;
-                coarse_vertices -= parallel::submit_for_all(task, std::plus<uint32_t>(), uint32_t(0));
-                node_queue.swap(node_queue_next);
-                ++round;
-                CLOCK_END("Round time");
-
-                if (old_coarse_vertices == coarse_vertices) {
-                        break;
+        {
+                SCOPED_TIMER("rounds");
+                while (!node_queue->empty()) {
+                        NodeID old_coarse_vertices = coarse_vertices;
+                        coarse_vertices -= parallel::submit_for_all(task, std::plus<NodeID>(), NodeID(0));
+                        node_queue.swap(node_queue_next);
+                        ++round;
+
+                        if (old_coarse_vertices == coarse_vertices) {
+                                break;
+                        }
                 }
         }
-        std::cout << coarse_vertices << std::endl;
+        INSTRUMENTATION_COUNT("local_max_matching/rounds", round - 1);
 
-        CLOCK_END("Coarsening: Matching: Main");
-
-        CLOCK_START_N;
+        SCOPED_TIMER("remap");
         no_of_coarse_vertices = coarse_vertices;
         remap_matching(partition_config, G, edge_matching, mapping, no_of_coarse_vertices);
-        CLOCK_END("Coarsening: Matching: Remap");
 }
 
 void local_max_matching::parallel_match_with_queue_exp(const PartitionConfig& partition_config,
@@ -295,26 +292,27 @@ void local_max_matching::parallel_match_with_queue_exp(const PartitionConfig& pa
                                                                     NodeID& no_of_coarse_vertices) {
 
         // init
-        CLOCK_START;
         uint32_t num_threads = partition_config.num_threads;
 
         parallel::ParallelVector<int> vertex_mark(G.number_of_nodes());
         parallel::ParallelVector<NodeID> permutation(G.number_of_nodes());
 
-        parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
-                permutation[node] = node;
-                vertex_mark[node] = NOT_STARTED;
-        });
-
-        edge_matching.reserve(G.number_of_nodes());
-        for (NodeID i = 0; i < G.number_of_nodes(); ++i) {
-                edge_matching.push_back(i);
+        {
+                SCOPED_TIMER("init");
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                        permutation[node] = node;
+                        vertex_mark[node] = NOT_STARTED;
+                });
+
+                edge_matching.reserve(G.number_of_nodes());
+                for (NodeID i = 0; i < G.number_of_nodes(); ++i) {
+                        edge_matching.push_back(i);
+                }
         }
 
         {
-                CLOCK_START;
+                SCOPED_TIMER("shuffle");
                 parallel::random_shuffle(permutation.begin(), permutation.end(), partition_config.num_threads);
-                CLOCK_END("Shuffle");
         }
 
         std::unique_ptr<tbb::concurrent_queue<block_type>> node_queue = std::make_unique<tbb::concurrent_queue<block_type>>();
@@ -323,33 +321,35 @@ void local_max_matching::parallel_match_with_queue_exp(const PartitionConfig& pa
         const EdgeID block_size_edges = std::max<EdgeID>(sqrt(G.number_of_edges()), 1000);
         std::atomic<NodeID> offset(0);
         const NodeID block_size = std::max<NodeID>(sqrt(permutation.size()), 1000);
-        parallel::submit_for_all([&]() {
-                block_type block;
-                block.reserve(block_size_edges);
-                size_t cur_block_size = 0;
-                NodeID begin = offset.fetch_add(block_size, std::memory_order_relaxed);
-
-                while (begin < permutation.size()) {
-                        NodeID end = std::min<NodeID>(begin + block_size, permutation.size());
-                        for (NodeID node = begin; node != end; ++node) {
-                                block.push_back(node);
-                                cur_block_size += G.getNodeDegree(node);
-                                if (cur_block_size >= block_size_edges) {
-                                        node_queue->push(std::move(block));
-                                        block.clear();
-                                        block.reserve(block_size_edges);
-                                        cur_block_size = 0;
+        {
+                SCOPED_TIMER("fill_queue");
+                parallel::submit_for_all([&]() {
+                        block_type block;
+                        block.reserve(block_size_edges);
+                        size_t cur_block_size = 0;
+                        NodeID begin = offset.fetch_add(block_size, std::memory_order_relaxed);
+
+                        while (begin < permutation.size()) {
+                                NodeID end = std::min<NodeID>(begin + block_size, permutation.size());
+                                for (NodeID node = begin; node != end; ++node) {
+                                        block.push_back(node);
+                                        cur_block_size += G.getNodeDegree(node);
+                                        if (cur_block_size >= block_size_edges) {
+                                                node_queue->push(std::move(block));
+                                                block.clear();
+                                                block.reserve(block_size_edges);
+                                                cur_block_size = 0;
+                                        }
                                 }
-                        }
-                        begin = offset.fetch_add(block_size, std::memory_order_relaxed);
+                                begin = offset.fetch_add(block_size, std::memory_order_relaxed);
 
-                }
-                if (!block.empty()) {
-                        node_queue->push(std::move(block));
-                }
-        });
+                        }
+                        if (!block.empty()) {
+                                node_queue->push(std::move(block));
+                        }
+                });
+        }
 
-        CLOCK_END("Coarsening: Matching: Init");
         uint32_t round = 1;
 
         auto task = [&]() {
@@ -431,34 +431,28 @@ void local_max_matching::parallel_match_with_queue_exp(const PartitionConfig& pa
                 return matched_vertices;
         };
 
-        CLOCK_START_N;
         // add loop for rounds with two queues
         std::vector<std::future<NodeID>> futures;
         futures.reserve(num_threads);
         NodeID coarse_vertices = G.number_of_nodes();
-        while (!node_queue->empty()) {
-                std::cout << round - 1 << std::endl;
-                std::cout << coarse_vertices << std::endl;
-
-                NodeID old_coarse_vertices = coarse_vertices;
-                CLOCK_START;
-                parallel::submit_for_all(task);
-                coarse_vertices -= parallel::submit_for_all(task1, std::plus<uint32_t>(), uint32_t(0));
-                ++round;
-                CLOCK_END("Round time");
-
-                if (old_coarse_vertices == coarse_vertices) {
-                        break;
+        {
+                SCOPED_TIMER("rounds");
+                while (!node_queue->empty()) {
+                        NodeID old_coarse_vertices = coarse_vertices;
+                        parallel::submit_for_all(task);
+                        coarse_vertices -= parallel::submit_for_all(task1, std::plus<NodeID>(), NodeID(0));
+                        ++round;
+
+                        if (old_coarse_vertices == coarse_vertices) {
+                                break;
+                        }
                 }
         }
-        std::cout << coarse_vertices << std::endl;
-
-        CLOCK_END("Coarsening: Matching: Main");
+        INSTRUMENTATION_COUNT("local_max_matching/rounds", round - 1);
 
-        CLOCK_START_N;
+        SCOPED_TIMER("remap");
         no_of_coarse_vertices = coarse_vertices;
         remap_matching(partition_config, G, edge_matching, mapping, no_of_coarse_vertices);
-        CLOCK_END("Coarsening: Matching: Remap");
 }
 
 void local_max_matching::parallel_match_with_queue_exp_with_removal(const PartitionConfig& partition_config,
@@ -468,28 +462,29 @@ void local_max_matching::parallel_match_with_queue_exp_with_removal(const Partit
                                                    NodeID& no_of_coarse_vertices) {
 
         // init
-        CLOCK_START;
         uint32_t num_threads = partition_config.num_threads;
 
         parallel::ParallelVector<int> vertex_mark(G.number_of_nodes());
         parallel::ParallelVector<NodeID> new_degrees(G.number_of_nodes());
         parallel::ParallelVector<NodeID> permutation(G.number_of_nodes());
 
-        parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
-                permutation[node] = node;
-                vertex_mark[node] = NOT_STARTED;
-                new_degrees[node] = G.getNodeDegree(node);
-        });
-
-        edge_matching.reserve(G.number_of_nodes());
-        for (NodeID i = 0; i < G.number_of_nodes(); ++i) {
-                edge_matching.push_back(i);
+        {
+                SCOPED_TIMER("init");
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                        permutation[node] = node;
+                        vertex_mark[node] = NOT_STARTED;
+                        new_degrees[node] = G.getNodeDegree(node);
+                });
+
+                edge_matching.reserve(G.number_of_nodes());
+                for (NodeID i = 0; i < G.number_of_nodes(); ++i) {
+                        edge_matching.push_back(i);
+                }
         }
 
         {
-                CLOCK_START;
+                SCOPED_TIMER("shuffle");
                 parallel::random_shuffle(permutation.begin(), permutation.end(), partition_config.num_threads);
-                CLOCK_END("Shuffle");
         }
 
         std::unique_ptr<tbb::concurrent_queue<block_type>> node_queue = std::make_unique<tbb::concurrent_queue<block_type>>();
@@ -498,33 +493,35 @@ void local_max_matching::parallel_match_with_queue_exp_with_removal(const Partit
         const size_t block_size_edges = std::max((uint32_t) sqrt(G.number_of_edges()), 1000u);
         std::atomic<NodeID> offset(0);
         const NodeID block_size = std::max<NodeID>(sqrt(permutation.size()), 1000);
-        parallel::submit_for_all([&]() {
-                block_type block;
-                block.reserve(block_size_edges);
-                size_t cur_block_size = 0;
-                NodeID begin = offset.fetch_add(block_size, std::memory_order_relaxed);
-
-                while (begin < permutation.size()) {
-                        NodeID end = std::min<NodeID>(begin + block_size, permutation.size());
-                        for (NodeID node = begin; node != end; ++node) {
-                                block.push_back(node);
-                                cur_block_size += G.getNodeDegree(node);
-                                if (cur_block_size >= block_size_edges) {
-                                        node_queue->push(std::move(block));
-                                        block.clear();
-                                        block.reserve(block_size_edges);
-                                        cur_block_size = 0;
+        {
+                SCOPED_TIMER("fill_queue");
+                parallel::submit_for_all([&]() {
+                        block_type block;
+                        block.reserve(block_size_edges);
+                        size_t cur_block_size = 0;
+                        NodeID begin = offset.fetch_add(block_size, std::memory_order_relaxed);
+
+                        while (begin < permutation.size()) {
+                                NodeID end = std::min<NodeID>(begin + block_size, permutation.size());
+                                for (NodeID node = begin; node != end; ++node) {
+                                        block.push_back(node);
+                                        cur_block_size += G.getNodeDegree(node);
+                                        if (cur_block_size >= block_size_edges) {
+                                                node_queue->push(std::move(block));
+                                                block.clear();
+                                                block.reserve(block_size_edges);
+                                                cur_block_size = 0;
+                                        }
                                 }
-                        }
-                        begin = offset.fetch_add(block_size, std::memory_order_relaxed);
+                                begin = offset.fetch_add(block_size, std::memory_order_relaxed);
 
-                }
-                if (!block.empty()) {
-                        node_queue->push(std::move(block));
-                }
-        });
+                        }
+                        if (!block.empty()) {
+                                node_queue->push(std::move(block));
+                        }
+                });
+        }
 
-        CLOCK_END("Coarsening: Matching: Init");
         uint32_t round = 1;
 
         auto task = [&]() {
@@ -650,36 +647,120 @@ void local_max_matching::parallel_match_with_queue_exp_with_removal(const Partit
                 }
         };
 
-        CLOCK_START_N;
         // add loop for rounds with two queues
         std::vector<std::future<NodeID>> futures;
         futures.reserve(num_threads);
         NodeID coarse_vertices = G.number_of_nodes();
-        while (!node_queue->empty()) {
-                std::cout << round - 1 << std::endl;
-                std::cout << coarse_vertices << std::endl;
-
-                NodeID old_coarse_vertices = coarse_vertices;
-                CLOCK_START;
-                parallel::submit_for_all(task);
-                coarse_vertices -= parallel::submit_for_all(task1, std::plus<uint32_t>(), uint32_t(0));
-                parallel::submit_for_all(task2);
-                std::swap(node_queue, node_queue_next);
-                ++round;
-                CLOCK_END("Round time");
-
-                if (old_coarse_vertices == coarse_vertices) {
-                        break;
+        {
+                SCOPED_TIMER("rounds");
+                while (!node_queue->empty()) {
+                        NodeID old_coarse_vertices = coarse_vertices;
+                        parallel::submit_for_all(task);
+                        coarse_vertices -= parallel::submit_for_all(task1, std::plus<NodeID>(), NodeID(0));
+                        parallel::submit_for_all(task2);
+                        std::swap(node_queue, node_queue_next);
+                        ++round;
+
+                        if (old_coarse_vertices == coarse_vertices) {
+                                break;
+                        }
                 }
         }
-        std::cout << coarse_vertices << std::endl;
+        INSTRUMENTATION_COUNT("local_max_matching/rounds", round - 1);
 
-        CLOCK_END("Coarsening: Matching: Main");
+        SCOPED_TIMER("remap");
+        no_of_coarse_vertices = coarse_vertices;
+        remap_matching(partition_config, G, edge_matching, mapping, no_of_coarse_vertices);
+}
 
-        CLOCK_START_N;
+// Every round has two phases over the unmatched nodes that still have a candidate. First each node picks
+// its heaviest unmatched neighbor, ties are broken by a hash of the seed and the neighbor. The matched
+// nodes only change in the second phase, in which mutual picks are matched, so the first phase reads a
+// snapshot of the previous round. The nodes of the next round keep their order. Hence the matching
+// neither depends on the thread schedule nor on the number of threads.
+void local_max_matching::parallel_match_deterministic(const PartitionConfig& partition_config,
+                                                      graph_access& G,
+                                                      Matching& edge_matching,
+                                                      CoarseMapping& mapping,
+                                                      NodeID& no_of_coarse_vertices) {
+        const parallel::MurmurHash<uint64_t> hash(partition_config.seed);
+        std::vector<NodeID> candidate(G.number_of_nodes());
+        std::vector<NodeID> active(G.number_of_nodes());
+
+        {
+                SCOPED_TIMER("init");
+                edge_matching.resize(G.number_of_nodes());
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                        edge_matching[node] = node;
+                        active[node] = node;
+                });
+        }
+
+        uint32_t round = 1;
+        NodeID coarse_vertices = G.number_of_nodes();
+        {
+                SCOPED_TIMER("rounds");
+                while (!active.empty()) {
+                        // a node is matched iff edge_matching[node] != node
+                        parallel::parallel_for_index(size_t(0), active.size(), [&](size_t index) {
+                                NodeID node = active[index];
+                                NodeWeight node_weight = G.getNodeWeight(node);
+                                EdgeRatingType max_rating = 0.0;
+                                uint64_t max_tiebreak = 0;
+                                NodeID max_neighbor = node;
+
+                                forall_out_edges(G, e, node) {
+                                        NodeID target = G.getEdgeTarget(e);
+                                        if (edge_matching[target] != target
+                                            || G.getNodeWeight(target) + node_weight > partition_config.max_vertex_weight) {
+                                                continue;
+                                        }
+
+                                        EdgeRatingType edge_rating = G.getEdgeRating(e);
+                                        uint64_t tiebreak = hash(target);
+                                        if (max_neighbor == node || edge_rating > max_rating
+                                            || (edge_rating == max_rating && tiebreak > max_tiebreak)) {
+                                                max_neighbor = target;
+                                                max_rating = edge_rating;
+                                                max_tiebreak = tiebreak;
+                                        }
+                                } endfor
+                                candidate[node] = max_neighbor;
+                        });
+
+                        parallel::parallel_for_index(size_t(0), active.size(), [&](size_t index) {
+                                NodeID node = active[index];
+                                NodeID max_neighbor = candidate[node];
+                                if (max_neighbor != node && candidate[max_neighbor] == node) {
+                                        edge_matching[node] = max_neighbor;
+                                }
+                        });
+
+                        // nodes without a candidate do not get one in later rounds
+                        NodeID old_coarse_vertices = coarse_vertices;
+                        size_t num_active = 0;
+                        for (NodeID node : active) {
+                                if (edge_matching[node] != node) {
+                                        if (node < edge_matching[node]) {
+                                                --coarse_vertices;
+                                        }
+                                } else if (candidate[node] != node) {
+                                        active[num_active++] = node;
+                                }
+                        }
+                        active.resize(num_active);
+                        ++round;
+
+                        if (old_coarse_vertices == coarse_vertices) {
+                                break;
+                        }
+                }
+        }
+        INSTRUMENTATION_COUNT("local_max_matching/rounds", round - 1);
+
+        SCOPED_TIMER("remap");
         no_of_coarse_vertices = coarse_vertices;
         remap_matching(partition_config, G, edge_matching, mapping, no_of_coarse_vertices);
-        CLOCK_END("Coarsening: Matching: Remap");
 }
 
 void local_max_matching::parallel_match(const PartitionConfig& partition_config,
@@ -689,28 +770,29 @@ void local_max_matching::parallel_match(const PartitionConfig& partition_config,
                                         NodeID& no_of_coarse_vertices) {
 
         // init
-        CLOCK_START;
         uint32_t num_threads = partition_config.num_threads;
 
         parallel::ParallelVector<AtomicWrapper<int>> vertex_mark(G.number_of_nodes());
         parallel::ParallelVector<atomic_pair_type> max_neighbours(G.number_of_nodes());
         parallel::ParallelVector<NodeID> permutation(G.number_of_nodes());
 
-        parallel::parallel_for_index(0u, G.number_of_nodes(), [&](NodeID node) {
-                vertex_mark[node] = MatchingPhases::NOT_STARTED;
-                new (max_neighbours.begin() + node) atomic_pair_type(0, 0);
-                permutation[node] = node;
-        });
-
-        edge_matching.reserve(G.number_of_nodes());
-        for (size_t i = 0; i < G.number_of_nodes(); ++i) {
-                edge_matching.push_back(i);
+        {
+                SCOPED_TIMER("init");
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                        vertex_mark[node] = MatchingPhases::NOT_STARTED;
+                        new (max_neighbours.begin() + node) atomic_pair_type(0, 0);
+                        permutation[node] = node;
+                });
+
+                edge_matching.reserve(G.number_of_nodes());
+                for (size_t i = 0; i < G.number_of_nodes(); ++i) {
+                        edge_matching.push_back(i);
+                }
         }
 
         {
-                CLOCK_START;
+                SCOPED_TIMER("shuffle");
                 parallel::random_shuffle(permutation.begin(), permutation.end(), partition_config.num_threads);
-                CLOCK_END("Shuffle");
         }
 
         Cvector<random> randoms;
@@ -718,7 +800,6 @@ void local_max_matching::parallel_match(const PartitionConfig& partition_config,
         for (uint32_t id = 0; id < num_threads; ++id) {
                 randoms.emplace_back(partition_config.seed + id);
         }
-        CLOCK_END("Coarsening: Matching: Init");
 
         uint32_t round = 1;
         std::atomic<NodeID> offset(0);
@@ -772,33 +853,27 @@ void local_max_matching::parallel_match(const PartitionConfig& partition_config,
                 return matched_vertices;
         };
 
-        CLOCK_START_N;
         std::vector<std::future<NodeID>> futures;
         futures.reserve(num_threads);
         NodeID coarse_vertices = G.number_of_nodes();
-        while (true) {
-                std::cout << round - 1 << std::endl;
-                std::cout << coarse_vertices << std::endl;
-
-                NodeID old_coarse_vertices = coarse_vertices;
-                CLOCK_START;
-                offset.store(0, std::memory_order_acquire);
-                coarse_vertices -= parallel::submit_for_all(task, std::plus<uint32_t>(), uint32_t(0));
-                ++round;
-                CLOCK_END("Round time");
-
-                if (old_coarse_vertices == coarse_vertices) {
-                        break;
+        {
+                SCOPED_TIMER("rounds");
+                while (true) {
+                        NodeID old_coarse_vertices = coarse_vertices;
+                        offset.store(0, std::memory_order_acquire);
+                        coarse_vertices -= parallel::submit_for_all(task, std::plus<NodeID>(), NodeID(0));
+                        ++round;
+
+                        if (old_coarse_vertices == coarse_vertices) {
+                                break;
+                        }
                 }
         }
-        std::cout << coarse_vertices << std::endl;
-
-        CLOCK_END("Coarsening: Matching: Main");
+        INSTRUMENTATION_COUNT("local_max_matching/rounds", round - 1);
 
-        CLOCK_START_N;
+        SCOPED_TIMER("remap");
         no_of_coarse_vertices = coarse_vertices;
         remap_matching(partition_config, G, edge_matching, mapping, no_of_coarse_vertices);
-        CLOCK_END("Coarsening: Matching: Remap");
 }
 
 void local_max_matching::remap_matching(const PartitionConfig& partition_config, graph_access& G,
@@ -43,6 +43,13 @@ private:
                                                         CoarseMapping& mapping,
                                                         NodeID& no_of_coarse_vertices);
 
+        // the matching only depends on the seed, see local_max.cpp
+        void parallel_match_deterministic(const PartitionConfig& partition_config,
+                                          graph_access& G,
+                                          Matching& edge_matching,
+                                          CoarseMapping& mapping,
+                                          NodeID& no_of_coarse_vertices);
+
         void parallel_match(const PartitionConfig& partition_config,
                             graph_access& G,
                             Matching& edge_matching,
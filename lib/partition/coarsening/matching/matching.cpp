@@ -32,7 +32,7 @@ matching::~matching() {
 
 void matching::print_matching(FILE * out, Matching & edge_matching) {
         for (NodeID n = 0; n < edge_matching.size(); n++) {
-                fprintf(out, "%d:%d\n", n, edge_matching[n]);
+                fprintf(out, "%llu:%llu\n", (unsigned long long) n, (unsigned long long) edge_matching[n]);
         }        
 }
 
@@ -1,8 +1,12 @@
+#include "data_structure/parallel/algorithm.h"
+#include "data_structure/parallel/atomics.h"
 #include "data_structure/parallel/hash_function.h"
+#include "data_structure/parallel/thread_pool.h"
 #include "partition/coarsening/min_hash/hash_common_neighborhood.h"
+#include "tools/instrumentation.h"
 
-#include <unordered_map>
 #include <iostream>
+#include <limits>
 
 void hash_common_neighborhood::match(const PartitionConfig& config,
                                      graph_access& G,
@@ -13,6 +17,25 @@ void hash_common_neighborhood::match(const PartitionConfig& config,
         find_vertices_with_common_neighbors(config, G, coarse_mapping, no_of_coarse_vertices);
 }
 
+uint64_t hash_common_neighborhood::signature(const PartitionConfig& config, graph_access& G, NodeID node,
+                                             uint32_t band) const {
+        if (config.common_neighborhood_min_hashes == 0) {
+                parallel::MurmurHash<NodeID> hash(config.seed);
+                uint64_t hash_value = 0;
+                forall_out_edges(G, e, node){
+                        hash_value ^= hash(G.getEdgeTarget(e));
+                } endfor
+                return hash_value;
+        }
+
+        parallel::MurmurHash<NodeID> hash(config.seed + band + 1);
+        uint64_t min_hash = std::numeric_limits<uint64_t>::max();
+        forall_out_edges(G, e, node){
+                min_hash = std::min(min_hash, hash(G.getEdgeTarget(e)));
+        } endfor
+        return min_hash;
+}
+
 void hash_common_neighborhood::find_vertices_with_common_neighbors(const PartitionConfig& config,
                                                                    graph_access& G,
                                                                    CoarseMapping& coarse_mapping,
@@ -20,59 +43,91 @@ void hash_common_neighborhood::find_vertices_with_common_neighbors(const Partiti
         const NodeID cluster_upperbound = (NodeID) ceil(
                 (config.upper_bound_partition + 0.0) / config.cluster_coarsening_factor);
 
-        std::vector<NodeID> cluster_sizes(G.number_of_nodes());
-        std::unordered_map<uint64_t, std::vector<NodeID>> buckets;
-        parallel::MurmurHash<NodeID> hash(config.seed);
+        if (coarse_mapping.empty()) {
+                return;
+        }
 
-        for (NodeID node = 0; node < G.number_of_nodes(); ++node) {
-                uint64_t hash_value = 0;
-                //uint64_t hash_value = std::numeric_limits<uint64_t>::max();
-                forall_out_edges(G, e, node){
-                        NodeID neighbor = G.getEdgeTarget(e);
-                        hash_value ^= hash(neighbor);
-                        //hash_value = std::min(hash(neighbor), hash_value);
-                } endfor
+        using signature_type = std::pair<uint64_t, NodeID>;
+        std::vector<signature_type> signatures(G.number_of_nodes());
+        std::vector<parallel::AtomicWrapper<NodeWeight>> cluster_sizes(G.number_of_nodes());
+        parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                cluster_sizes[coarse_mapping[node]].m_atomic.fetch_add(G.getNodeWeight(node),
+                                                                       std::memory_order_relaxed);
+        });
 
+        // nodes that joined a cluster or were joined by another node in an earlier band, they do not move again
+        std::vector<uint8_t> grouped(G.number_of_nodes(), false);
 
-                buckets[hash_value].push_back(node);
-                cluster_sizes[coarse_mapping[node]] += G.getNodeWeight(node);
-        }
+        // every min-hash is a band of its own, two nodes are grouped if any of their min-hashes is equal
+        const uint32_t num_bands = std::max<uint32_t>(config.common_neighborhood_min_hashes, 1);
+        for (uint32_t band = 0; band < num_bands; ++band) {
+                {
+                        SCOPED_TIMER("signatures");
+                        parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                                signatures[node] = std::make_pair(signature(config, G, node, band), node);
+                        });
+                }
 
-        for (const auto& bucket : buckets) {
-                size_t i = 0;
-                while (i < bucket.second.size()) {
-                        NodeID node = bucket.second[i];
-                        NodeID cluster = coarse_mapping[node];
-
-                        while (++i < bucket.second.size()) {
-                                NodeID next_node = bucket.second[i];
-
-                                if (G.getNodeWeight(next_node) + cluster_sizes[cluster] <= cluster_upperbound) {
-                                        cluster_sizes[coarse_mapping[next_node]] -= G.getNodeWeight(next_node);
-                                        coarse_mapping[next_node] = cluster;
-                                        cluster_sizes[cluster] += G.getNodeWeight(next_node);
-                                } else {
-                                        break;
-                                }
-                        }
+                // nodes with equal signatures form consecutive buckets
+                {
+                        SCOPED_TIMER("sort");
+                        parallel::sort(signatures.begin(), signatures.end(),
+                                       [](const signature_type& lhs, const signature_type& rhs) {
+                                               return lhs < rhs;
+                                       }, config.num_threads);
                 }
-        }
 
-        if (coarse_mapping.empty()) {
-                return;
-        }
+                // Every thread merges the buckets starting in its range of the sorted signatures and follows the
+                // last of them to its end. A node belongs to exactly one bucket of a band, so only the cluster
+                // sizes are shared and these are updated atomically.
+                SCOPED_TIMER("merge_buckets");
+                const size_t num_signatures = signatures.size();
+                const uint32_t num_threads = parallel::g_thread_pool.NumThreads() + 1;
+                auto same_bucket = [&](size_t i) {
+                        return signatures[i].first == signatures[i - 1].first;
+                };
 
-        std::vector<NodeWeight> cluster_map(G.number_of_nodes());
-        forall_nodes(G, node){
-                                PartitionID cur_cluster = coarse_mapping[node];
-                                cluster_map[cur_cluster] = 1;
-        } endfor
+                parallel::submit_for_all([&](uint32_t thread_id) {
+                        size_t i = num_signatures * thread_id / num_threads;
+                        size_t range_end = num_signatures * (thread_id + 1) / num_threads;
+                        while (i > 0 && i < range_end && same_bucket(i)) {
+                                ++i;
+                        }
 
-        for (size_t i = 1; i < cluster_map.size(); ++i)
-                cluster_map[i] += cluster_map[i - 1];
+                        while (i < range_end) {
+                                do {
+                                        NodeID head = signatures[i].second;
+                                        NodeID cluster = coarse_mapping[head];
 
-        forall_nodes(G, node){
-                                coarse_mapping[node] = cluster_map[coarse_mapping[node]] - 1;
-        } endfor
-        no_of_coarse_vertices = cluster_map.back();
-}
\ No newline at end of file
+                                        while (++i < num_signatures && same_bucket(i)) {
+                                                NodeID next_node = signatures[i].second;
+                                                if (grouped[next_node]) {
+                                                        continue;
+                                                }
+
+                                                NodeWeight weight = G.getNodeWeight(next_node);
+                                                auto& cluster_size = cluster_sizes[cluster].m_atomic;
+
+                                                NodeWeight size = cluster_size.load(std::memory_order_relaxed);
+                                                while (size + weight <= cluster_upperbound &&
+                                                       !cluster_size.compare_exchange_weak(size, size + weight,
+                                                                                           std::memory_order_relaxed)) {}
+                                                if (size + weight > cluster_upperbound) {
+                                                        // start a new cluster with the rest of the bucket
+                                                        break;
+                                                }
+
+                                                cluster_sizes[coarse_mapping[next_node]].m_atomic.fetch_sub(
+                                                        weight, std::memory_order_relaxed);
+                                                coarse_mapping[next_node] = cluster;
+                                                grouped[next_node] = true;
+                                                grouped[head] = true;
+                                        }
+                                } while (i < num_signatures && same_bucket(i));
+                        }
+                });
+        }
+
+        SCOPED_TIMER("relabel");
+        no_of_coarse_vertices = parallel::remap_cluster_ids(coarse_mapping, config.num_threads);
+}
@@ -15,6 +15,10 @@ public:
         virtual ~hash_common_neighborhood() {}
 
 private:
+        // hash of the neighborhood of node, the xor of the hashes of all neighbors (equal for twins) or
+        // the min-hash number band of config.common_neighborhood_min_hashes (likely equal for near-twins)
+        uint64_t signature(const PartitionConfig& config, graph_access& G, NodeID node, uint32_t band) const;
+
         void find_vertices_with_common_neighbors(const PartitionConfig& config,
                                                  graph_access& G,
                                                  CoarseMapping& coarse_mapping,
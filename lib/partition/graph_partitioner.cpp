@@ -22,6 +22,7 @@
 
 #include "coarsening/coarsening.h"
 #include "graph_extractor.h"
+#include "instrumentation.h"
 #include "graph_partitioner.h"
 #include "initial_partitioning/initial_partitioning.h"
 #include "quality_metrics.h"
@@ -31,7 +32,10 @@
 #include "w_cycles/wcycle_partitioner.h"
 #include "uncoarsening/refinement/parallel_kway_graph_refinement/multitry_kway_fm.h"
 
-#include "data_structure/parallel/time.h"
+#include "data_structure/parallel/thread_pool.h"
+#include "data_structure/parallel/work_stealing_pool.h"
+
+#include <future>
 
 graph_partitioner::graph_partitioner() {
 
@@ -47,13 +51,32 @@ void graph_partitioner::perform_recursive_partitioning(PartitionConfig & config,
         m_rnd_bal = random_functions::nextDouble(1,2);
         m_global_work_load = config.work_load;
 
-        perform_recursive_partitioning_internal(config, G, 0, config.k-1, 1.0);
+        if (!config.parallel_recursive_bisection || config.num_threads == 1) {
+                perform_recursive_partitioning_internal(config, G, 0, config.k-1, 1.0, 1);
+                return;
+        }
+
+        // the subproblems are partitioned by tasks on the work stealing pool since the subtrees
+        // are of irregular size. The bipartitioning itself runs sequentially in this case, i.e. the
+        // parallel coarsening and refinement has to be off. The workers of g_thread_pool busy wait,
+        // so they are stopped while the work stealing pool runs.
+        size_t num_pool_threads = parallel::g_thread_pool.NumThreads();
+        parallel::g_thread_pool.Clear();
+        parallel::g_work_stealing_pool.Resize(config.num_threads - 1);
+
+        PartitionConfig rec_config = config;
+        rec_config.parallel_subgraph_extraction = false;
+        perform_recursive_partitioning_internal(rec_config, G, 0, config.k-1, 1.0, config.num_threads);
+
+        parallel::g_work_stealing_pool.Clear();
+        parallel::g_thread_pool.Resize(num_pool_threads);
 }
 
 void graph_partitioner::perform_recursive_partitioning_internal(PartitionConfig & config, 
                                                                 graph_access & G, 
                                                                 PartitionID lb, 
-                                                                PartitionID ub, double part_fraction) {
+                                                                PartitionID ub, double part_fraction,
+                                                                uint32_t num_threads) {
 
         G.set_partition_count(2);
         
@@ -131,19 +154,60 @@ void graph_partitioner::perform_recursive_partitioning_internal(PartitionConfig
                NodeWeight weight_lhs_block = 0;
                NodeWeight weight_rhs_block = 0;
 
-               extractor.extract_two_blocks(G, extracted_block_lhs, 
-                                               extracted_block_rhs, 
-                                               mapping_extracted_to_G_lhs, 
-                                               mapping_extracted_to_G_rhs, 
-                                               weight_lhs_block, weight_rhs_block);
+               if (config.parallel_subgraph_extraction && config.num_threads > 1) {
+                       std::vector<graph_access*> blocks = {&extracted_block_lhs, &extracted_block_rhs};
+                       std::vector<std::vector<NodeID>> mappings;
+                       std::vector<NodeWeight> block_weights;
+                       extractor.extract_all_blocks_parallel(G, blocks, mappings, block_weights);
 
-               PartitionConfig rec_config = config;
-               if(num_blocks_lhs > 1) {
-                       rec_config.k = num_blocks_lhs;
+                       mapping_extracted_to_G_lhs.swap(mappings[0]);
+                       mapping_extracted_to_G_rhs.swap(mappings[1]);
+                       weight_lhs_block = block_weights[0];
+                       weight_rhs_block = block_weights[1];
+               } else {
+                       extractor.extract_two_blocks(G, extracted_block_lhs, 
+                                                       extracted_block_rhs, 
+                                                       mapping_extracted_to_G_lhs, 
+                                                       mapping_extracted_to_G_rhs, 
+                                                       weight_lhs_block, weight_rhs_block);
+               }
+
+               PartitionConfig rec_config_lhs      = config;
+               rec_config_lhs.k                    = num_blocks_lhs;
+               rec_config_lhs.largest_graph_weight = weight_lhs_block;
+               rec_config_lhs.work_load            = weight_lhs_block;
+               double part_fraction_lhs            = part_fraction * num_blocks_lhs/(num_blocks_lhs + num_blocks_rhs + 0.0);
+
+               PartitionConfig rec_config_rhs      = config;
+               rec_config_rhs.k                    = num_blocks_rhs;
+               rec_config_rhs.largest_graph_weight = weight_rhs_block;
+               rec_config_rhs.work_load            = weight_rhs_block;
+               double part_fraction_rhs            = part_fraction * num_blocks_rhs/(num_blocks_lhs + num_blocks_rhs + 0.0);
+
+               // if both sides have to be partitioned further, the rhs is submitted to the work stealing
+               // pool while this thread continues with the lhs. The thread budget is split proportional
+               // to the block weights and bounds how deep the subtrees are split into tasks.
+               uint32_t num_threads_lhs  = num_threads;
+               uint32_t num_threads_rhs  = num_threads;
+               bool spawn_rhs            = num_threads > 1 && num_blocks_lhs > 1 && num_blocks_rhs > 1;
+               std::future<void> rhs_done;
+               if (spawn_rhs) {
+                       NodeWeight total_weight = weight_lhs_block + weight_rhs_block;
+                       double lhs_share        = total_weight > 0 ? weight_lhs_block / (double) total_weight : 0.5;
+                       num_threads_lhs         = std::max<uint32_t>(1, std::min<uint32_t>(num_threads - 1, round(lhs_share * num_threads)));
+                       num_threads_rhs         = num_threads - num_threads_lhs;
+
+                       int seed_rhs = random_functions::nextInt(0, std::numeric_limits<int>::max());
+                       rhs_done = parallel::g_work_stealing_pool.Submit([&, seed_rhs]() {
+                               random_functions::setSeed(seed_rhs);
+                               perform_recursive_partitioning_internal(rec_config_rhs, extracted_block_rhs, new_lb_rhs, ub, 
+                                                                       part_fraction_rhs, num_threads_rhs);
+                       });
+               }
 
-                       rec_config.largest_graph_weight = weight_lhs_block;
-                       rec_config.work_load            = weight_lhs_block;
-                       perform_recursive_partitioning_internal( rec_config, extracted_block_lhs, lb, new_ub_lhs, part_fraction * num_blocks_lhs/(num_blocks_lhs + num_blocks_rhs + 0.0));
+               if(num_blocks_lhs > 1) {
+                       perform_recursive_partitioning_internal( rec_config_lhs, extracted_block_lhs, lb, new_ub_lhs, 
+                                                                part_fraction_lhs, num_threads_lhs);
                        
                        //apply partition
                        forall_nodes(extracted_block_lhs, node) {
@@ -158,10 +222,13 @@ void graph_partitioner::perform_recursive_partitioning_internal(PartitionConfig
                }
 
                if(num_blocks_rhs > 1) {
-                       rec_config.k = num_blocks_rhs;
-                       rec_config.largest_graph_weight = weight_rhs_block;
-                       rec_config.work_load            = weight_rhs_block;
-                       perform_recursive_partitioning_internal( rec_config, extracted_block_rhs, new_lb_rhs, ub, part_fraction * num_blocks_rhs/(num_blocks_lhs + num_blocks_rhs + 0.0));
+                       if (spawn_rhs) {
+                               // runs pending tasks of the pool until the rhs is done
+                               parallel::g_work_stealing_pool.Wait(rhs_done);
+                       } else {
+                               perform_recursive_partitioning_internal( rec_config_rhs, extracted_block_rhs, new_lb_rhs, ub, 
+                                                                        part_fraction_rhs, num_threads_rhs);
+                       }
 
                        forall_nodes(extracted_block_rhs, node) {
                                G.setPartitionIndex(mapping_extracted_to_G_rhs[node], extracted_block_rhs.getPartitionIndex(node));
@@ -200,6 +267,9 @@ void graph_partitioner::single_run( PartitionConfig & config, graph_access & G)
                                 uncoarsening uncoarsen;
 
                                 graph_hierarchy hierarchy;
+                                if (!config.spill_hierarchy_directory.empty()) {
+                                        hierarchy.spill_to(config.spill_hierarchy_directory);
+                                }
 
                                 if( config.mode_node_separators ) {
                                         int rnd = random_functions::nextInt(0,3);
@@ -213,17 +283,18 @@ void graph_partitioner::single_run( PartitionConfig & config, graph_access & G)
                                                 config.edge_rating = SEPARATOR_LOG;
                                         } 
                                 }
-                                CLOCK_START;
-                                coarsen.perform_coarsening(config, G, hierarchy);
-                                CLOCK_END("Coarsening");
-
-                                CLOCK_START_N;
-                                init_part.perform_initial_partitioning(config, hierarchy);
-                                CLOCK_END("Initial partitioning");
-
-                                CLOCK_START_N;
-                                uncoarsen.perform_uncoarsening(config, hierarchy);
-                                CLOCK_END("Uncoarsening");
+                                {
+                                        SCOPED_TIMER("coarsening");
+                                        coarsen.perform_coarsening(config, G, hierarchy);
+                                }
+                                {
+                                        SCOPED_TIMER("initial_partitioning");
+                                        init_part.perform_initial_partitioning(config, hierarchy);
+                                }
+                                {
+                                        SCOPED_TIMER("uncoarsening");
+                                        uncoarsen.perform_uncoarsening(config, hierarchy);
+                                }
                                 if( config.mode_node_separators ) {
                                         quality_metrics qm;
                                         std::cerr <<  "vcycle result " << qm.separator_weight(G)  << std::endl;
@@ -235,6 +306,7 @@ void graph_partitioner::single_run( PartitionConfig & config, graph_access & G)
 }
 
 void graph_partitioner::perform_partitioning( PartitionConfig & config, graph_access & G) {
+        SCOPED_TIMER("partitioning");
         if(config.only_first_level) {
                 if( !config.graph_allready_partitioned) {
                         initial_partitioning init_part;
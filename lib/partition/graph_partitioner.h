@@ -38,9 +38,12 @@ public:
         void perform_recursive_partitioning(PartitionConfig & graph_partitioner_config, graph_access & G);
 
 private:
+        // num_threads is the share of the thread budget of the subproblem, its subtrees are submitted
+        // to parallel::g_work_stealing_pool as long as the share is larger than one
         void perform_recursive_partitioning_internal(PartitionConfig & graph_partitioner_config, 
                                                      graph_access & G, 
-                                                     PartitionID lb, PartitionID ub, double part_fraction);
+                                                     PartitionID lb, PartitionID ub, double part_fraction,
+                                                     uint32_t num_threads);
         void single_run( PartitionConfig & config, graph_access & G);
 
         unsigned m_global_k;
@@ -21,6 +21,7 @@
  *****************************************************************************/
 
 #include <fstream>
+#include "algorithms/max_flow_solver.h"
 #include "initial_partition_bipartition.h"
 #include "uncoarsening/refinement/kway_graph_refinement/kway_graph_refinement.h"
 #include "uncoarsening/refinement/mixed_refinement.h"
@@ -45,7 +46,7 @@ void initial_partition_bipartition::initial_partition( const PartitionConfig & c
         rec_config.use_wcycles                      = false;
         rec_config.use_fullmultigrid                = false;
         rec_config.fm_search_limit                  = config.bipartition_post_ml_limits;
-        rec_config.matching_type                    = MATCHING_GPA;
+        rec_config.matching_type                    = config.initial_partitioning_random_matching ? MATCHING_RANDOM : MATCHING_GPA;
         rec_config.permutation_quality              = PERMUTATION_QUALITY_GOOD;
         rec_config.initial_partitioning             = true;
 	rec_config.graph_allready_partitioned       = false;
@@ -64,10 +65,20 @@ void initial_partition_bipartition::initial_partition( const PartitionConfig & c
         rec_config.parallel_coarsening_lp = false;
         rec_config.lp_before_local_search = false;
         rec_config.fast_contract_clustering = false;
+        rec_config.parallel_gpa = false;
+        rec_config.parallel_pairwise_refinement = false;
+        rec_config.flow_solver = max_flow_solver::sequential_flow_solver(config.flow_solver);
+        // the parallel initial partitioning already runs this inside of pool tasks
+        rec_config.parallel_subgraph_extraction = config.parallel_subgraph_extraction && !config.parallel_initial_partitioning;
+        rec_config.parallel_recursive_bisection = config.parallel_recursive_bisection && !config.parallel_initial_partitioning;
         //rec_config.accept_small_coarser_graphs = true;
 
-        // turn off common_neighborhood_clustering
+        // turn off common_neighborhood_clustering and two_hop_clustering, both use the thread pool
         rec_config.common_neighborhood_clustering = false;
+        rec_config.two_hop_clustering = false;
+
+        // the hierarchies of the initial partitioning are small, keep them in memory
+        rec_config.spill_hierarchy_directory = "";
 
         if (rec_config.fastmultitry) {
                 rec_config.fastmultitry = false;
@@ -2,6 +2,7 @@
 #include "data_structure/parallel/thread_pool.h"
 #include "data_structure/parallel/time.h"
 #include "graph_partition_assertions.h"
+#include "instrumentation.h"
 #include "initial_partitioning/initial_partition_bipartition.h"
 #include "initial_partitioning/parallel/initial_partitioning.h"
 #include "quality_metrics.h"
@@ -13,6 +14,56 @@
 
 namespace parallel {
 
+namespace {
+
+// the algorithms of the portfolio, the repetitions cycle through them
+enum class ip_algorithm {
+        configured,             // recursive bipartitioning as configured
+        other_bipartition,      // BFS and FM bipartitioning swapped
+        random_matching,        // random matchings instead of GPA in the coarsening
+        count
+};
+
+PartitionConfig portfolio_config(const PartitionConfig& config, uint32_t rep) {
+        PartitionConfig working_config = config;
+        working_config.combine = false;
+
+        switch (static_cast<ip_algorithm>(rep % static_cast<uint32_t>(ip_algorithm::count))) {
+                case ip_algorithm::configured:
+                        break;
+                case ip_algorithm::other_bipartition:
+                        working_config.bipartition_algorithm = config.bipartition_algorithm == BIPARTITION_BFS ?
+                                                               BIPARTITION_FM : BIPARTITION_BFS;
+                        break;
+                case ip_algorithm::random_matching:
+                        working_config.initial_partitioning_random_matching = true;
+                        break;
+                case ip_algorithm::count:
+                        break;
+        }
+        return working_config;
+}
+
+// best partition found by one thread and the repetition which computed it
+struct ip_result {
+        EdgeWeight cut = std::numeric_limits<EdgeWeight>::max();
+        uint32_t rep = std::numeric_limits<uint32_t>::max();
+        std::unique_ptr<int[]> map;
+
+        // the repetition breaks ties in deterministic mode, so the result does not depend on the thread schedule
+        bool is_better(const ip_result& other, bool deterministic, parallel::random& rnd) const {
+                if (!other.map) {
+                        return true;
+                }
+                if (cut != other.cut) {
+                        return cut < other.cut;
+                }
+                return deterministic ? rep < other.rep : rnd.bit();
+        }
+};
+
+}
+
 initial_partitioning::initial_partitioning() {
 }
 
@@ -30,14 +81,31 @@ void initial_partitioning::perform_initial_partitioning(const PartitionConfig& c
         uint32_t reps_to_do = (unsigned) std::max((int)ceil(config.initial_partitioning_repetitions/(double)log2(config.k)),2);
         reps_to_do = std::max(reps_to_do, config.num_threads);
 
-        std::atomic<uint32_t> reps_done(0);
+        // the threads stop once this many repetitions in a row did not improve the best cut, in
+        // deterministic mode all repetitions are done since which ones run first depends on the schedule
+        uint32_t plateau = std::max(config.num_threads, 2u);
+        const bool deterministic = config.deterministic_parallel;
+
+        std::atomic<uint32_t> reps_started(0);
+        std::atomic<uint32_t> reps_without_improvement(0);
+        std::atomic<EdgeWeight> global_best_cut(std::numeric_limits<EdgeWeight>::max());
+
+        // lowers global_best_cut to cut, returns false if it already was at most cut
+        auto publish_cut = [&global_best_cut] (EdgeWeight cut) {
+                EdgeWeight cur_best = global_best_cut.load(std::memory_order_relaxed);
+                while (cut < cur_best) {
+                        if (global_best_cut.compare_exchange_weak(cur_best, cut, std::memory_order_relaxed)) {
+                                return true;
+                        }
+                }
+                return false;
+        };
 
-        auto task_impl = [&qm, &config, &reps_done, &reps_to_do] (graph_access& G, uint32_t id)
-                -> std::pair<EdgeWeight, std::unique_ptr<int[]>>{
+        auto task_impl = [&] (graph_access& G, uint32_t id) -> ip_result {
                 initial_partition_bipartition partition;
 
-                EdgeWeight best_cut = std::numeric_limits<EdgeWeight>::max();
-                std::unique_ptr<int[]> best_map = std::make_unique<int[]>(G.number_of_nodes());
+                // only results which improve the best cut of all threads are kept
+                ip_result best;
                 ALWAYS_ASSERT(!(config.graph_allready_partitioned && !config.omit_given_partitioning));
 
                 std::unique_ptr<int[]> partition_map = std::make_unique<int[]>(G.number_of_nodes());
@@ -45,40 +113,53 @@ void initial_partitioning::perform_initial_partitioning(const PartitionConfig& c
                 parallel::random rnd(id + config.seed);
                 if (!((config.graph_allready_partitioned && config.no_new_initial_partitioning) ||
                       config.omit_given_partitioning)) {
-                        uint32_t rep = 0;
-                        while ((rep = reps_done.fetch_add(1, std::memory_order_release) < reps_to_do)) {
-                                uint32_t seed = rnd.random_number(0u, std::numeric_limits<uint32_t>::max());
-                                PartitionConfig working_config = config;
-                                working_config.combine = false;
+                        uint32_t rep;
+                        while ((rep = reps_started.fetch_add(1, std::memory_order_relaxed)) < reps_to_do) {
+                                if (!deterministic && (reps_without_improvement.load(std::memory_order_relaxed) >= plateau ||
+                                                       global_best_cut.load(std::memory_order_relaxed) == 0)) {
+                                        break;
+                                }
 
+                                uint32_t seed = rnd.random_number(0u, std::numeric_limits<uint32_t>::max());
+                                if (deterministic) {
+                                        // the repetition alone decides the random choices, not the thread running it
+                                        seed = config.seed + rep;
+                                        random_functions::setSeed(seed);
+                                }
+                                PartitionConfig working_config = portfolio_config(config, rep);
                                 partition.initial_partition(working_config, seed, G, partition_map.get());
+                                INSTRUMENTATION_COUNT("initial_partitioning/repetitions", 1);
 
                                 EdgeWeight cur_cut = qm.edge_cut(G, partition_map.get());
-                                if (cur_cut < best_cut) {
-                                        best_map.swap(partition_map);
-                                        best_cut = cur_cut;
-
-                                        if (best_cut == 0) {
-                                                break;
+                                bool improved = deterministic ? (!best.map || cur_cut < best.cut) : publish_cut(cur_cut);
+                                if (improved) {
+                                        reps_without_improvement.store(0, std::memory_order_relaxed);
+                                        best.map.swap(partition_map);
+                                        best.cut = cur_cut;
+                                        best.rep = rep;
+                                        if (!partition_map) {
+                                                partition_map = std::make_unique<int[]>(G.number_of_nodes());
                                         }
+                                } else {
+                                        reps_without_improvement.fetch_add(1, std::memory_order_relaxed);
                                 }
                         }
                 }
-                return std::make_pair(best_cut, std::move(best_map));
+                return best;
         };
 
+        // all threads share the nodes and edges of G and only have their own partition, G stays unchanged
         auto task = [&] (uint32_t id) {
+                SCOPED_TIMER("initial_partitioning_portfolio");
                 if (id > 0) {
                         random_functions::setSeed(id + config.seed);
-                        graph_access my_graph;
-                        G.copy(my_graph);
-                        return task_impl(my_graph, id);
-                } else {
-                        return task_impl(G, id);
                 }
+                graph_access my_graph;
+                G.share_structure(my_graph);
+                return task_impl(my_graph, id);
         };
 
-        std::vector<std::future<std::pair<EdgeWeight, std::unique_ptr<int[]>>>> futures;
+        std::vector<std::future<ip_result>> futures;
         futures.reserve(g_thread_pool.NumThreads());
 
         // start initial
@@ -91,37 +172,38 @@ void initial_partitioning::perform_initial_partitioning(const PartitionConfig& c
                 futures.push_back(parallel::g_thread_pool.Submit(id, task, id + 1));
         }
 
-        EdgeWeight best_cut;
-        std::unique_ptr<int[]> best_map;
-
-        std::tie(best_cut, best_map) = task(0);
+        ip_result best = task(0);
 
         parallel::random rnd(config.seed);
-        std::vector<std::pair<EdgeWeight, std::unique_ptr<int[]>>> cuts;
+        std::vector<ip_result> results;
         std::for_each(futures.begin(), futures.end(), [&](auto& future) {
-                cuts.push_back(future.get());
+                results.push_back(future.get());
         });
         ofs.close();
         std::cout.rdbuf(backup);
 
-        for (auto& cut : cuts) {
-                EdgeWeight cur_cut = cut.first;
-                std::unique_ptr<int[]> cur_map = std::move(cut.second);
+        for (auto& result : results) {
+                if (!result.map) {
+                        continue;
+                }
 
-                if (cur_cut < best_cut || (cur_cut == best_cut && rnd.bit())) {
+                if (result.is_better(best, deterministic, rnd)) {
                         PRINT(std::cout << "log>"
                                         << "improved the current initial partitiong from "
-                                        << best_cut
-                                        << " to " << cur_cut << std::endl;)
-                        best_cut = cur_cut;
-                        best_map = std::move(cur_map);
+                                        << best.cut
+                                        << " to " << result.cut << std::endl;)
+                        best = std::move(result);
                 }
         }
+        EdgeWeight best_cut = best.cut;
+        std::unique_ptr<int[]> best_map = std::move(best.map);
 
         G.set_partition_count(config.k);
-        forall_nodes(G, n) {
-                G.setPartitionIndex(n, best_map[n]);
-        } endfor
+        if (best_map) {
+                forall_nodes(G, n) {
+                        G.setPartitionIndex(n, best_map[n]);
+                } endfor
+        }
 
         PRINT(std::cout << "initial partitioning took " << t.elapsed()                << std::endl;)
         PRINT(std::cout << "log>"                       << "current initial balance " << qm.balance(G) << std::endl;)
@@ -416,6 +416,8 @@ struct PartitionConfig
         std::string configuration;
         bool lp_before_local_search = false;
         bool parallel_initial_partitioning = false;
+        // coarsen with random matchings instead of GPA during recursive bipartitioning
+        bool initial_partitioning_random_matching = false;
         bool parallel_coarsening_lp = false;
         bool check_cut = false;
         bool fast_contract_clustering = false;
@@ -423,12 +425,50 @@ struct PartitionConfig
         uint32_t stop_mls_threshold = 5;
         bool sort_edges = false;
         bool common_neighborhood_clustering = false;
+        // 0: group nodes with identical neighborhoods, otherwise number of min-hashes, nodes sharing one of them are grouped
+        uint32_t common_neighborhood_min_hashes = 0;
+        // group nodes left alone by label propagation that share their heaviest neighbor, if the clustering
+        // keeps more than two_hop_clustering_threshold of the nodes
+        bool two_hop_clustering = false;
+        double two_hop_clustering_threshold = 0.5;
+        // gpa matching grows paths in parallel on one node range per thread
+        bool parallel_gpa = false;
+        // refine the block pairs of the quotient graph that share no block concurrently
+        bool parallel_pairwise_refinement = false;
+        // max flow algorithm of the flow based refinements, AUTOMATIC uses the parallel push-relabel for
+        // flow problems with at least parallel_flow_solver_threshold nodes and boykov-kolmogorov otherwise
+        FlowSolverType flow_solver = FlowSolverType::PUSH_RELABEL;
+        NodeID parallel_flow_solver_threshold = 100000;
+        // a region of the flow refinement that was rejected is shrunk and its flow problem is solved again
+        // starting from the previous maximum flow, always with boykov-kolmogorov. a region only grows after
+        // an accepted cut changed the bipartition, its flow problem is built from scratch
+        bool reuse_flow_on_shrink = false;
+        // node separator mode that coarsens with the parallel local max matching and refines the separator on the
+        // finer levels with localized fm searches on disjoint regions of at most parallel_node_separator_region_size
+        // nodes that run concurrently
+        bool parallel_node_separator = false;
+        NodeID parallel_node_separator_region_size = 1000;
         bool use_numa_aware_graph = false;
+        // place node ranges of the input graph on the sockets of their threads and process local ranges first
+        bool numa_graph_layout = false;
         uint32_t threads_per_socket = 8;
         uint32_t l2_cache_size = 256 * 1024;
         uint32_t l3_cache_size = 20480 * 1024;
         bool balls_and_bins_ht = false;
         bool remove_edges_in_matching  = false;
+        bool parallel_subgraph_extraction = false;
+        bool parallel_recursive_bisection = false;
+        // file to write the quality_report of the final partition to, as JSON
+        std::string metrics_json_filename = "";
+        // parallel label propagation, cluster contraction, initial partitioning and multitry fm give the
+        // same partition in every run with the same seed and number of threads
+        bool deterministic_parallel = false;
+        // file to write the phase timers and counters of tools/instrumentation.h to, CSV if the name
+        // ends with .csv and JSON otherwise
+        std::string instrumentation_filename = "";
+        // directory for scratch files of the graph hierarchy. if set, every finer level is written to a
+        // file during coarsening and read back during uncoarsening. empty keeps all levels in memory.
+        std::string spill_hierarchy_directory = "";
         //bool accept_small_coarser_graphs = false;
 };
 
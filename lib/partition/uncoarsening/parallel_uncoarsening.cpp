@@ -1,8 +1,8 @@
-#include "data_structure/parallel/time.h"
 #include "partition/uncoarsening/parallel_uncoarsening.h"
 #include "partition/uncoarsening/refinement/label_propagation_refinement/label_propagation_refinement.h"
 #include "partition/uncoarsening/refinement/parallel_kway_graph_refinement/multitry_kway_fm.h"
 #include "tools/graph_partition_assertions.h"
+#include "tools/instrumentation.h"
 #include "tools/quality_metrics.h"
 
 #include <memory>
@@ -14,44 +14,66 @@ int uncoarsening::perform_uncoarsening_cut(const PartitionConfig& config, graph_
         std::unique_ptr<graph_access> coarsest(hierarchy.get_coarsest());
         PRINT(std::cout << "log>" << "unrolling graph with " << coarsest->number_of_nodes() << std::endl;)
 
-        if (config.lp_before_local_search) {
-                CLOCK_START;
-                perform_label_propagation(cfg, *coarsest);
-                CLOCK_END(">> Uncoarsening: Label propagation");
-        }
-
         double factor = config.balance_factor;
         cfg.upper_bound_partition = ((!hierarchy.isEmpty()) * factor + 1.0) * config.upper_bound_partition;
 
+        // the boundary of a finer graph is derived from the boundary of the coarser graph while projecting.
+        // label propagation before the local search moves vertices after the projection, in this case
+        // the boundary is constructed from scratch.
+        bool fused_projection = config.parallel_multitry_kway && !config.lp_before_local_search;
+        std::vector<uint8_t> coarser_boundary;
+
         EdgeWeight improvement = 0;
-        if (config.parallel_multitry_kway) {
-                CLOCK_START;
-                boundary_type boundary(*coarsest, cfg);
-                boundary.construct_boundary();
-                if (config.check_cut) {
-                        boundary.check_boundary();
+        // the hierarchy still contains the coarsest graph, level 0 is the input graph
+        uint32_t level = hierarchy.size() - 1;
+        {
+                SCOPED_LEVEL(level);
+                if (config.lp_before_local_search) {
+                        SCOPED_TIMER("label_propagation");
+                        perform_label_propagation(cfg, *coarsest);
                 }
-                CLOCK_END(">> Build boundary");
 
-                CLOCK_START_N;
-                improvement += perform_multitry_kway(cfg, *coarsest, boundary);
-                CLOCK_END(">> Refinement");
+                if (config.parallel_multitry_kway) {
+                        boundary_type boundary(*coarsest, cfg);
+                        {
+                                SCOPED_TIMER("build_boundary");
+                                boundary.construct_boundary();
+                                if (config.check_cut) {
+                                        boundary.check_boundary();
+                                }
+                        }
+
+                        improvement += perform_multitry_kway(cfg, *coarsest, boundary);
+
+                        if (fused_projection && !hierarchy.isEmpty()) {
+                                boundary.get_boundary_vertices(coarser_boundary);
+                        }
+                }
         }
 
         uint32_t hierarchy_deepth = hierarchy.size();
-        std::vector<std::unique_ptr<graph_access>> graphs_to_delete;
+        // a graph is deleted once the next finer graph is refined, starting with the coarsest graph, so the
+        // hierarchy frees the levels in stack order
+        std::unique_ptr<graph_access> to_delete(std::move(coarsest));
 
         while (!hierarchy.isEmpty()) {
-                CLOCK_START;
-                graph_access* G = hierarchy.parallel_pop_finer_and_project();
-                CLOCK_END("Projection");
+                graph_access* G = nullptr;
+                graph_access* coarser = nullptr;
+                CoarseMapping* coarse_mapping = nullptr;
+                --level;
+                SCOPED_LEVEL(level);
+                if (fused_projection) {
+                        G = hierarchy.pop_finer(coarser, coarse_mapping);
+                } else {
+                        SCOPED_TIMER("projection");
+                        G = hierarchy.parallel_pop_finer_and_project();
+                }
 
                 PRINT(std::cout << "log>" << "unrolling graph with " << G->number_of_nodes() << std::endl;)
 
                 if (config.lp_before_local_search) {
-                        CLOCK_START_N;
+                        SCOPED_TIMER("label_propagation");
                         perform_label_propagation(cfg, *G);
-                        CLOCK_END(">> Uncoarsening: Label propagation");
                 }
 
                 //call refinement
@@ -60,23 +82,29 @@ int uncoarsening::perform_uncoarsening_cut(const PartitionConfig& config, graph_
                 PRINT(std::cout << "cfg upperbound " << cfg.upper_bound_partition << std::endl;)
 
                 if (config.parallel_multitry_kway) {
-                        CLOCK_START_N;
                         boundary_type boundary(*G, cfg);
-                        boundary.construct_boundary();
+                        if (fused_projection) {
+                                SCOPED_TIMER("projection_and_build_boundary");
+                                boundary.project_and_construct_boundary(*coarser, *coarse_mapping, coarser_boundary);
+                        } else {
+                                SCOPED_TIMER("build_boundary");
+                                boundary.construct_boundary();
+                        }
                         if (config.check_cut) {
                                 boundary.check_boundary();
                         }
-                        CLOCK_END(">> Build boundary");
 
-                        CLOCK_START_N;
                         improvement += perform_multitry_kway(cfg, *G, boundary);
-                        CLOCK_END(">> Refinement");
+
+                        if (fused_projection && !hierarchy.isEmpty()) {
+                                boundary.get_boundary_vertices(coarser_boundary);
+                        }
                 }
 
                 ASSERT_TRUE(graph_partition_assertions::assert_graph_has_kway_partition(config, *G));
 
                 if (!hierarchy.isEmpty()) {
-                        graphs_to_delete.emplace_back(G);
+                        to_delete.reset(G);
                 }
         }
 
@@ -105,7 +133,7 @@ void uncoarsening::perform_label_propagation(PartitionConfig& config, graph_acce
 }
 
 EdgeWeight uncoarsening::perform_multitry_kway(PartitionConfig& config, graph_access& G, boundary_type& boundary) {
-        CLOCK_START;
+        SCOPED_TIMER("multitry_kway_fm");
         quality_metrics qm;
         EdgeWeight old_cut = 0;
         double old_balance = 0.0;
@@ -128,7 +156,7 @@ EdgeWeight uncoarsening::perform_multitry_kway(PartitionConfig& config, graph_ac
                 std::cout << "improvement\t" << improvement << std::endl;
                 ALWAYS_ASSERT(old_cut - new_cut == improvement);
         }
-        CLOCK_END("Multitry kway refinement");
+        INSTRUMENTATION_COUNT("multitry_kway_fm/improvement", improvement);
         return improvement;
 }
 
@@ -23,7 +23,6 @@
 #include <algorithm>
 #include <unordered_map>
 
-#include "data_structure/parallel/time.h"
 #include "kway_graph_refinement_core.h"
 #include "kway_stop_rule.h"
 #include "multitry_kway_fm.h"
@@ -67,10 +66,8 @@ int multitry_kway_fm::perform_refinement(PartitionConfig& config, graph_access&
         int overall_improvement = 0;
         //while (true) {
         for (unsigned i = 0; i < rounds; i++) {
-                CLOCK_START;
                 boundary_starting_nodes start_nodes;
                 boundary.setup_start_nodes_all(G, start_nodes);
-                //time_setup_start_nodes += CLOCK_END_TIME;
 
                 if (start_nodes.size() == 0) {
                         return 0;
@@ -83,11 +80,9 @@ int multitry_kway_fm::perform_refinement(PartitionConfig& config, graph_access&
                         todolist.push_back(start_nodes[i]);
                 }
 
-                CLOCK_START_N;
                 std::unordered_map<PartitionID, PartitionID> touched_blocks;
                 EdgeWeight improvement = start_more_locallized_search(config, G, boundary, init_neighbors, false,
                                                                       touched_blocks, todolist);
-                //time_local_search += CLOCK_END_TIME;
 
                 if (improvement == 0) {
                         break;
@@ -118,10 +113,8 @@ int multitry_kway_fm::perform_refinement_around_parts(PartitionConfig& config, g
         int overall_improvement = 0;
 
         for (unsigned i = 0; i < config.local_multitry_rounds; i++) {
-                CLOCK_START;
                 boundary_starting_nodes start_nodes;
                 boundary.setup_start_nodes_around_blocks(G, lhs, rhs, start_nodes);
-                //time_setup_start_nodes += CLOCK_END_TIME;
 
                 if (start_nodes.size() == 0) {
                         return 0;
@@ -133,11 +126,9 @@ int multitry_kway_fm::perform_refinement_around_parts(PartitionConfig& config, g
                         todolist.push_back(start_nodes[i]);
                 }
 
-                CLOCK_START_N;
                 EdgeWeight improvement = start_more_locallized_search(config, G, boundary,
                                                                       init_neighbors, true,
                                                                       touched_blocks, todolist);
-                //time_local_search += CLOCK_END_TIME;
 
                 if (improvement == 0) break;
 
@@ -169,7 +160,6 @@ int multitry_kway_fm::start_more_locallized_search(PartitionConfig& config, grap
         unsigned idx = todolist.size() - 1;
         int overall_improvement = 0;
 
-        CLOCK_START;
         while (!todolist.empty()) {
                 int random_idx = random_functions::nextInt(0, idx);
                 NodeID node = todolist[random_idx];
@@ -224,8 +214,6 @@ int multitry_kway_fm::start_more_locallized_search(PartitionConfig& config, grap
                 std::swap(todolist[random_idx], todolist[idx--]);
                 todolist.pop_back();
         }
-        //auto t = CLOCK_END_TIME;
-        //time_generate_moves += t;
 
         return overall_improvement;
 }
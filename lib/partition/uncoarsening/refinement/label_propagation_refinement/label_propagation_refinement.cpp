@@ -20,13 +20,19 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
 
+#include <chrono>
+#include <numeric>
+
 #include "data_structure/parallel/thread_pool.h"
-#include "data_structure/parallel/time.h"
 #include "label_propagation_refinement.h"
 #include "partition/coarsening/clustering/node_ordering.h"
+#include "tools/instrumentation.h"
 
 using namespace parallel;
 
+constexpr NodeID label_propagation_refinement::deterministic_rounds;
+constexpr NodeID label_propagation_refinement::deterministic_min_slice_size;
+
 label_propagation_refinement::label_propagation_refinement() {
 }
 
@@ -36,34 +42,22 @@ label_propagation_refinement::~label_propagation_refinement() {
 EdgeWeight label_propagation_refinement::perform_refinement(PartitionConfig& config, graph_access& G, complete_boundary&) {
         std::vector<uint8_t> boundary_nodes;
         if (!config.parallel_lp) {
-                CLOCK_START;
-                auto res = sequential_label_propagation(config, G);
-                CLOCK_END("Uncoarsening: Sequential lp");
-
-                return res;
+                SCOPED_TIMER("sequential_lp");
+                return sequential_label_propagation(config, G);
         } else {
-                CLOCK_START;
-                auto res = parallel_label_propagation(config, G);
-                CLOCK_END("Uncoarsening: Parallel lp");
-
-                return res;
+                SCOPED_TIMER("parallel_lp");
+                return parallel_label_propagation(config, G);
         }
 }
 
 EdgeWeight label_propagation_refinement::perform_refinement(PartitionConfig& config, graph_access& G) {
 
         if (!config.parallel_lp) {
-                CLOCK_START;
-                auto res = sequential_label_propagation(config, G);
-                CLOCK_END("Uncoarsening: Sequential lp");
-
-                return res;
+                SCOPED_TIMER("sequential_lp");
+                return sequential_label_propagation(config, G);
         } else {
-                CLOCK_START;
-                auto res = parallel_label_propagation(config, G);
-                CLOCK_END("Uncoarsening: Parallel lp");
-
-                return res;
+                SCOPED_TIMER("parallel_lp");
+                return parallel_label_propagation(config, G);
         }
 }
 
@@ -78,12 +72,8 @@ EdgeWeight label_propagation_refinement::sequential_label_propagation(PartitionC
         std::vector<NodeID> permutation(G.number_of_nodes());
         std::vector<NodeWeight> cluster_sizes(partition_config.k, 0);
 
-        auto b = std::chrono::high_resolution_clock::now();
         node_ordering n_ordering;
         n_ordering.order_nodes(partition_config, G, permutation);
-        auto e = std::chrono::high_resolution_clock::now();
-        std::cout << "Uncoarsening: Sequential init of permutations lp:\t" << std::chrono::duration_cast<std::chrono::microseconds>(e - b).count()
-                  << std::endl;
 
         std::queue< NodeID > * Q             = new std::queue< NodeID >();
         std::queue< NodeID > * next_Q        = new std::queue< NodeID >();
@@ -94,8 +84,7 @@ EdgeWeight label_propagation_refinement::sequential_label_propagation(PartitionC
                 Q->push(permutation[node]);
         } endfor
         auto end = std::chrono::high_resolution_clock::now();
-        std::cout << "Uncoarsening: Init sequential lp:\t" << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
-                  << std::endl;
+        INSTRUMENTATION_TIME("init", std::chrono::duration<double>(end - begin).count());
 
         begin = std::chrono::high_resolution_clock::now();
 
@@ -194,9 +183,8 @@ EdgeWeight label_propagation_refinement::sequential_label_propagation(PartitionC
         }
 
         end = std::chrono::high_resolution_clock::now();
-        std::cout << "Uncoarsening: Main sequential lp:\t" << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
-                  << std::endl;
-        std::cout << "Uncoarsening: Improved:\t" << change_counter << std::endl;
+        INSTRUMENTATION_TIME("iterations", std::chrono::duration<double>(end - begin).count());
+        INSTRUMENTATION_COUNT("label_propagation/changed_labels", change_counter);
 
         delete Q;
         delete next_Q;
@@ -311,7 +299,6 @@ void label_propagation_refinement::par_init_for_edge_unit(graph_access& G, const
                                                       Cvector<AtomicWrapper<NodeWeight>>& cluster_sizes,
                                                       std::unique_ptr<ConcurrentQueue>& queue) {
 
-        CLOCK_START;
         std::atomic<NodeID> start_node(0);
         auto task = [&]() {
                 const NodeID nodes_count = std::max<NodeID>(sqrt(G.number_of_nodes()), 4000);
@@ -349,7 +336,6 @@ void label_propagation_refinement::par_init_for_edge_unit(graph_access& G, const
         for (size_t i = 0; i < cluster_sizes.size(); ++i) {
                 cluster_sizes[i].get().store(cur_cluster_sizes[i], std::memory_order_relaxed);
         }
-        CLOCK_END("Init cluster sizes");
 
         par_init_for_edge_unit(G, block_size, permutation, queue);
 }
@@ -359,10 +345,10 @@ void label_propagation_refinement::par_init_for_edge_unit(graph_access& G, const
                                                           const T& permutation,
                                                           std::unique_ptr<ConcurrentQueue>& queue) {
 
-        CLOCK_START;
+        SCOPED_TIMER("init_queue");
         std::atomic<NodeID> offset(0);
         NodeID node_block_size = (NodeID) sqrt(G.number_of_nodes());
-        node_block_size = std::max(node_block_size, 1000u);
+        node_block_size = std::max<NodeID>(node_block_size, 1000);
         parallel::submit_for_all([&](uint32_t thread_id) {
                 Block block;
                 block.reserve(100);
@@ -392,7 +378,6 @@ void label_propagation_refinement::par_init_for_edge_unit(graph_access& G, const
                         queue->push(std::move(block));
                 }
         });
-        CLOCK_END("Init queue lp");
 }
 
 
@@ -401,7 +386,6 @@ EdgeWeight label_propagation_refinement::parallel_label_propagation_with_queue(g
                                                                                Cvector<AtomicWrapper<NodeWeight>>& cluster_sizes,
                                                                                std::vector<std::vector<PartitionID>>& hash_maps,
                                                                                const parallel::ParallelVector<Pair>& permutation) {
-        CLOCK_START;
         const NodeWeight block_upperbound = config.upper_bound_partition;
         auto queue = std::make_unique<ConcurrentQueue>();
         auto next_queue = std::make_unique<ConcurrentQueue>();
@@ -410,29 +394,30 @@ EdgeWeight label_propagation_refinement::parallel_label_propagation_with_queue(g
         std::vector<AtomicWrapper<bool>> next_queue_contains(G.number_of_nodes());
 
         uint32_t max_block_size = get_block_size(G, config);
-        std::cout << "Uncoarsening: Block size\t" << max_block_size << std::endl;
 
 //        TODO: check what is better with cache_aligned vector or not
 //        std::vector<AtomicWrapper<NodeWeight>> cluster_sizes(config.k);
 
         bool use_edge_unit = config.block_size_unit == BlockSizeUnit::EDGES;
-        if (use_edge_unit) {
-                if (G.number_of_nodes() < 100) {
-                        seq_init_for_edge_unit(G, max_block_size, permutation, cluster_sizes, queue);
+        {
+                SCOPED_TIMER("init");
+                if (use_edge_unit) {
+                        if (G.number_of_nodes() < 100) {
+                                seq_init_for_edge_unit(G, max_block_size, permutation, cluster_sizes, queue);
+                        } else {
+                                par_init_for_edge_unit(G, max_block_size, permutation, cluster_sizes, queue);
+                        }
                 } else {
-                        par_init_for_edge_unit(G, max_block_size, permutation, cluster_sizes, queue);
+                        init_for_node_unit(G, max_block_size, permutation, cluster_sizes, queue);
                 }
-        } else {
-                init_for_node_unit(G, max_block_size, permutation, cluster_sizes, queue);
         }
-        CLOCK_END("Uncoarsening: Parallel lp: Init queue lp");
 
         std::vector<std::future<NodeWeight>> futures;
         futures.reserve(parallel::g_thread_pool.NumThreads());
         NodeWeight num_changed_label = 0;
 
-        CLOCK_START_N;
-        std::cout << "Uncoarsening: Num blocks\t" << queue->unsafe_size() << std::endl;
+        INSTRUMENTATION_COUNT("label_propagation/blocks", queue->unsafe_size());
+        SCOPED_TIMER("iterations");
         for (int j = 0; j < config.label_iterations_refinement; j++) {
                 if (queue->empty()) {
                         break;
@@ -545,17 +530,14 @@ EdgeWeight label_propagation_refinement::parallel_label_propagation_with_queue(g
                         //futures.push_back(parallel::g_thread_pool.Submit(process, i + 1));
                 }
 
-                //CLOCK_START;
                 num_changed_label += process(0);
                 std::for_each(futures.begin(), futures.end(), [&](auto& future){
                         num_changed_label += future.get();
                 });
-                //CLOCK_END(std::string("Iteration ") + std::to_string(j) + " time");
                 std::swap(queue, next_queue);
                 std::swap(queue_contains, next_queue_contains);
                 futures.clear();
         }
-        CLOCK_END("Uncoarsening: Parallel lp: iterations");
 
         return num_changed_label;
 }
@@ -663,11 +645,11 @@ EdgeWeight label_propagation_refinement::parallel_label_propagation(graph_access
 EdgeWeight label_propagation_refinement::parallel_label_propagation_with_queue_with_many_clusters(graph_access& G,
                                                                                const PartitionConfig& config,
                                                                                const NodeWeight block_upperbound,
-                                                                               std::vector<NodeWeight>& cluster_id,
+                                                                               std::vector<NodeID>& cluster_id,
                                                                                std::vector<AtomicWrapper<NodeWeight>>& cluster_sizes,
                                                                                std::vector<std::vector<PartitionID>>& hash_maps,
-                                                                               const parallel::ParallelVector<Triple>& permutation) {
-        CLOCK_START;
+                                                                               const parallel::ParallelVector<Triple>& permutation,
+                                                                               parallel::local_first_scheduler* local_scheduler) {
         ALWAYS_ASSERT(config.block_size_unit == BlockSizeUnit::EDGES);
         auto queue = std::make_unique<ConcurrentQueue>();
         auto next_queue = std::make_unique<ConcurrentQueue>();
@@ -676,11 +658,11 @@ EdgeWeight label_propagation_refinement::parallel_label_propagation_with_queue_w
         std::vector<AtomicWrapper<bool>> next_queue_contains(G.number_of_nodes());
 
         uint64_t max_block_size = get_block_size(G, config);
-        std::cout << "Block size\t" << max_block_size << std::endl;
-
 
-        par_init_for_edge_unit(G, max_block_size, permutation, queue);
-        CLOCK_END("Parallel lp: Init queue lp");
+        // with a local_scheduler the first iteration takes the nodes from the scheduler instead of the queue
+        if (!local_scheduler) {
+                par_init_for_edge_unit(G, max_block_size, permutation, queue);
+        }
 
         NodeWeight num_changed_label = 0;
 
@@ -690,13 +672,31 @@ EdgeWeight label_propagation_refinement::parallel_label_propagation_with_queue_w
         using hash_function_type = parallel::MurmurHash<NodeID>;
         using hash_value_type = hash_function_type::hash_type;
 
-        CLOCK_START_N;
-        std::cout << "Num blocks\t" << queue->unsafe_size() << std::endl;
+        INSTRUMENTATION_COUNT("label_propagation/blocks", queue->unsafe_size());
+        SCOPED_TIMER("iterations");
         for (int j = 0; j < config.label_iterations; j++) {
-                if (queue->empty()) {
+                const bool use_scheduler = j == 0 && local_scheduler;
+                if (queue->empty() && !use_scheduler) {
                         break;
                 }
 
+                auto next_block = [&](const size_t id, Block& block) {
+                        if (!use_scheduler) {
+                                return queue->try_pop(block);
+                        }
+
+                        size_t begin;
+                        size_t end;
+                        if (!local_scheduler->next_chunk(id, begin, end)) {
+                                return false;
+                        }
+                        block.clear();
+                        for (size_t i = begin; i != end; ++i) {
+                                block.push_back(permutation[i].first);
+                        }
+                        return true;
+                };
+
                 auto process = [&](const size_t id) {
                         hash_function_type hash;
                         parallel::HashMap<NodeID, EdgeWeight, TabularHash<NodeID, 3, 2, 10, true>, true> hash_map(128);
@@ -709,7 +709,7 @@ EdgeWeight label_propagation_refinement::parallel_label_propagation_with_queue_w
 
                         parallel::random rnd(config.seed + id);
                         std::vector<NodeID> neighbor_parts;
-                        while (queue->try_pop(cur_block)) {
+                        while (next_block(id, cur_block)) {
                                 for (auto node : cur_block) {
                                         hash.reset(config.seed + j + node);
                                         queue_contains[node].store(false, std::memory_order_relaxed);
@@ -799,25 +799,134 @@ EdgeWeight label_propagation_refinement::parallel_label_propagation_with_queue_w
                         return num_changed_label;
                 };
 
-                CLOCK_START;
                 num_changed_label += parallel::submit_for_all(process, std::plus<NodeWeight>(), NodeWeight(0));
-                CLOCK_END(std::string("Iteration ") + std::to_string(j) + " time");
 
                 std::swap(queue, next_queue);
                 std::swap(queue_contains, next_queue_contains);
         }
-        CLOCK_END("Parallel lp: iterations");
 
         return num_changed_label;
 }
 
 
+EdgeWeight label_propagation_refinement::deterministic_label_propagation(graph_access& G,
+                                                                         const PartitionConfig& config,
+                                                                         const NodeWeight block_upperbound,
+                                                                         const int iterations,
+                                                                         const std::vector<NodeID>& order,
+                                                                         std::vector<NodeID>& labels,
+                                                                         std::vector<NodeWeight>& label_sizes) {
+        using hash_function_type = parallel::MurmurHash<NodeID>;
+        using hash_value_type = hash_function_type::hash_type;
+
+        const NodeID num_nodes = order.size();
+        // small graphs are not split, every slice costs a synchronization of the threads
+        const NodeID slice_size = std::max<NodeID>((num_nodes + deterministic_rounds - 1) / deterministic_rounds,
+                                                   deterministic_min_slice_size);
+        const NodeID chunk_size = std::max<NodeID>(sqrt(slice_size), 1000);
+
+        // label chosen by order[i] in the current slice
+        std::vector<NodeID> best_labels(num_nodes);
+        // a node is visited in iteration j if active_iteration[node] == j
+        std::vector<AtomicWrapper<int>> active_iteration(G.number_of_nodes(), 0);
+        std::vector<NodeID> moved;
+
+        NodeWeight num_changed_label = 0;
+        for (int j = 0; j < iterations; j++) {
+                moved.clear();
+                for (NodeID slice_begin = 0; slice_begin < num_nodes; slice_begin += slice_size) {
+                        const NodeID slice_end = std::min(slice_begin + slice_size, num_nodes);
+
+                        // labels and label_sizes are read only until all nodes of the slice are done
+                        std::atomic<NodeID> offset(slice_begin);
+                        parallel::submit_for_all([&]() {
+                                hash_function_type hash;
+                                parallel::HashMap<NodeID, EdgeWeight, TabularHash<NodeID, 3, 2, 10, true>, true> hash_map(128);
+                                std::vector<NodeID> neighbor_labels;
+
+                                NodeID begin = offset.fetch_add(chunk_size, std::memory_order_relaxed);
+                                while (begin < slice_end) {
+                                        const NodeID end = std::min(begin + chunk_size, slice_end);
+                                        for (NodeID i = begin; i != end; ++i) {
+                                                const NodeID node = order[i];
+                                                const NodeID my_label = labels[node];
+                                                best_labels[i] = my_label;
+                                                if (active_iteration[node].load(std::memory_order_relaxed) != j) {
+                                                        continue;
+                                                }
+
+                                                neighbor_labels.clear();
+                                                forall_out_edges(G, e, node) {
+                                                        NodeID label = labels[G.getEdgeTarget(e)];
+                                                        auto& rating = hash_map[label];
+                                                        if (rating == 0) {
+                                                                neighbor_labels.push_back(label);
+                                                        }
+                                                        rating += G.getEdgeWeight(e);
+                                                } endfor
+
+                                                hash.reset(config.seed + j + node);
+                                                const NodeWeight node_weight = G.getNodeWeight(node);
+                                                NodeID max_label = my_label;
+                                                EdgeWeight max_value = 0;
+                                                hash_value_type max_label_hash = 0;
+                                                for (NodeID cur_label : neighbor_labels) {
+                                                        EdgeWeight cur_value = hash_map[cur_label];
+                                                        NodeWeight cur_label_size = label_sizes[cur_label];
+                                                        hash_value_type cur_label_hash = hash(cur_label);
+
+                                                        if ((cur_value > max_value || (cur_value == max_value && cur_label_hash > max_label_hash))
+                                                            && (cur_label_size + node_weight < block_upperbound
+                                                                || (cur_label == my_label && cur_label_size <= block_upperbound))) {
+                                                                max_value = cur_value;
+                                                                max_label = cur_label;
+                                                                max_label_hash = cur_label_hash;
+                                                        }
+                                                }
+                                                hash_map.clear();
+                                                best_labels[i] = max_label;
+                                        }
+                                        begin = offset.fetch_add(chunk_size, std::memory_order_relaxed);
+                                }
+                        });
+
+                        // moves which would overload a label because of earlier moves of the slice are dropped
+                        for (NodeID i = slice_begin; i != slice_end; ++i) {
+                                const NodeID node = order[i];
+                                const NodeID from = labels[node];
+                                const NodeID to = best_labels[i];
+                                const NodeWeight node_weight = G.getNodeWeight(node);
+                                if (from == to || label_sizes[to] + node_weight > block_upperbound) {
+                                        continue;
+                                }
+
+                                label_sizes[from] -= node_weight;
+                                label_sizes[to] += node_weight;
+                                labels[node] = to;
+                                moved.push_back(node);
+                        }
+                }
+                num_changed_label += moved.size();
+
+                if (moved.empty()) {
+                        break;
+                }
+
+                parallel::parallel_for_index(size_t(0), moved.size(), [&](size_t i) {
+                        forall_out_edges(G, e, moved[i]) {
+                                active_iteration[G.getEdgeTarget(e)].store(j + 1, std::memory_order_relaxed);
+                        } endfor
+                });
+        }
+        return num_changed_label;
+}
+
+
 EdgeWeight label_propagation_refinement::parallel_label_propagation_many_clusters(const PartitionConfig& config,
                                                                                   graph_access& G,
                                                                                   const NodeWeight block_upperbound,
-                                                                                  std::vector<NodeWeight>& cluster_id,
+                                                                                  std::vector<NodeID>& cluster_id,
                                                                                   NodeID& no_of_blocks) {
-        CLOCK_START;
         std::vector<std::vector<PartitionID>> hash_maps(config.num_threads);
         std::vector<parallel::AtomicWrapper<NodeWeight>> cluster_sizes(G.number_of_nodes());
 
@@ -826,18 +935,17 @@ EdgeWeight label_propagation_refinement::parallel_label_propagation_many_cluster
                 cluster_sizes[node].store(G.getNodeWeight(node), std::memory_order_relaxed);
         } endfor
 
-        CLOCK_END("Init other vectors lp");
-
-        CLOCK_START_N;
         parallel::ParallelVector<Triple> permutation(G.number_of_nodes());
         {
-                CLOCK_START;
+                SCOPED_TIMER("generate_permutation");
                 std::atomic<NodeID> offset(0);
                 NodeID block_size = (NodeID) sqrt(G.number_of_nodes());
-                block_size = std::max(block_size, 1000u);
+                block_size = std::max<NodeID>(block_size, 1000);
 
                 parallel::submit_for_all([&](uint32_t thread_id) {
                         parallel::random rnd(config.seed + thread_id);
+                        // which thread handles which node is not fixed, so the deterministic mode hashes instead
+                        parallel::MurmurHash<NodeID> hash(config.seed);
                         while (true) {
                                 NodeID begin = offset.fetch_add(block_size, std::memory_order_relaxed);
                                 NodeID end = begin + block_size;
@@ -850,82 +958,96 @@ EdgeWeight label_propagation_refinement::parallel_label_propagation_many_cluster
                                 for (NodeID node = begin; node != end; ++node) {
                                         permutation[node].first = node;
                                         permutation[node].second = G.getNodeDegree(node);
-                                        permutation[node].rnd = rnd.random_number(0u, G.number_of_nodes() - 1);
+                                        if (config.deterministic_parallel) {
+                                                permutation[node].rnd = hash(node) % G.number_of_nodes();
+                                        } else {
+                                                permutation[node].rnd = rnd.random_number<NodeID>(0, G.number_of_nodes() - 1);
+                                        }
                                 }
                         }
                 });
-
-                CLOCK_END("Generate permutation");
         }
 
         parallel::g_thread_pool.Clear();
         parallel::Unpin();
 
         {
-                CLOCK_START;
+                SCOPED_TIMER("sort");
                 parallel::sort(permutation.begin(), permutation.end(),
                                [](const Triple& lhs, const Triple& rhs) {
                                        return lhs.second < rhs.second
-                                              || (lhs.second == rhs.second && lhs.rnd < rhs.rnd);
+                                              || (lhs.second == rhs.second && lhs.rnd < rhs.rnd)
+                                              || (lhs.second == rhs.second && lhs.rnd == rhs.rnd && lhs.first < rhs.first);
                                },
                                config.num_threads);
-                CLOCK_END("Sort");
         }
         parallel::PinToCore(0);
         parallel::g_thread_pool.Resize(config.num_threads - 1);
 
-        CLOCK_END("Parallel init of permutations lp");
+        // With the NUMA layout the permutation is grouped by the thread owning the node (keeping the order
+        // within a group) and in the first iteration every thread starts with its own group.
+        std::unique_ptr<parallel::local_first_scheduler> local_scheduler;
+        if (config.numa_graph_layout && !config.deterministic_parallel) {
+                SCOPED_TIMER("group_by_owner");
+                parallel::numa_graph_layout layout(G, config.num_threads, config.threads_per_socket);
+                std::vector<NodeID> segments(config.num_threads + 1, 0);
+                std::vector<uint32_t> owners(permutation.size());
+                for (size_t i = 0; i < permutation.size(); ++i) {
+                        owners[i] = layout.owner(permutation[i].first);
+                        ++segments[owners[i] + 1];
+                }
+                std::partial_sum(segments.begin(), segments.end(), segments.begin());
 
-        EdgeWeight res = 0;
-        CLOCK_START_N;
-        res = parallel_label_propagation_with_queue_with_many_clusters(G, config, block_upperbound, cluster_id,
-                                                                       cluster_sizes, hash_maps, permutation);
-        CLOCK_END("Main parallel (no queue) lp");
+                std::vector<NodeID> position(segments.begin(), segments.end() - 1);
+                parallel::ParallelVector<Triple> grouped(permutation.size());
+                for (size_t i = 0; i < permutation.size(); ++i) {
+                        grouped[position[owners[i]]++] = permutation[i];
+                }
+                permutation.swap(grouped);
 
-        std::cout << "Improved\t" << res << std::endl;
+                NodeID block_size = (NodeID) sqrt(G.number_of_nodes());
+                block_size = std::max<NodeID>(block_size, 1000);
+                local_scheduler = std::make_unique<parallel::local_first_scheduler>(segments,
+                                                                                    config.threads_per_socket,
+                                                                                    block_size);
+        }
+
+        EdgeWeight res = 0;
+        if (config.deterministic_parallel) {
+                std::vector<NodeID> order(G.number_of_nodes());
+                std::vector<NodeWeight> label_sizes(G.number_of_nodes());
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID i) {
+                        order[i] = permutation[i].first;
+                        label_sizes[i] = G.getNodeWeight(i);
+                });
+                res = deterministic_label_propagation(G, config, block_upperbound, config.label_iterations, order,
+                                                      cluster_id, label_sizes);
+        } else {
+                res = parallel_label_propagation_with_queue_with_many_clusters(G, config, block_upperbound, cluster_id,
+                                                                               cluster_sizes, hash_maps, permutation,
+                                                                               local_scheduler.get());
+        }
+        INSTRUMENTATION_COUNT("label_propagation/changed_labels", res);
 
-        CLOCK_START_N;
+        SCOPED_TIMER("remap_cluster_ids");
         if (config.num_threads > 1) {
                 parallel_remap_cluster_ids_fast(config, G, cluster_id, no_of_blocks);
         } else {
                 remap_cluster_ids_fast(config, G, cluster_id, no_of_blocks);
         }
-        CLOCK_END("Remap cluster ids");
         return res;
 }
 
 void label_propagation_refinement::parallel_remap_cluster_ids_fast(const PartitionConfig& partition_config,
                                                                    graph_access& G,
-                                                                   std::vector<NodeWeight>& cluster_id,
+                                                                   std::vector<NodeID>& cluster_id,
                                                                    NodeID& no_of_coarse_vertices) {
-        if (cluster_id.empty()) {
-                no_of_coarse_vertices = 0;
-                return;
-        }
-
-        parallel::ParallelVector<AtomicWrapper<NodeID>> cluster_map(G.number_of_nodes());
-        parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
-                cluster_map[node] = 0;
-        });
-
-        parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
-                PartitionID cur_cluster = cluster_id[node];
-                cluster_map[cur_cluster] = 1;
-        });
-
-        parallel::partial_sum(cluster_map.begin(), cluster_map.end(), cluster_map.begin(),
-                              partition_config.num_threads);
-
-        parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
-                cluster_id[node] = cluster_map[cluster_id[node]] - 1;
-        });
-
-        no_of_coarse_vertices = cluster_map.back();
+        no_of_coarse_vertices = parallel::remap_cluster_ids(cluster_id, partition_config.num_threads);
 }
 
 void label_propagation_refinement::remap_cluster_ids_fast(const PartitionConfig& partition_config,
                                                           graph_access& G,
-                                                          std::vector<NodeWeight>& cluster_id,
+                                                          std::vector<NodeID>& cluster_id,
                                                           NodeID& no_of_coarse_vertices,
                                                           bool apply_to_graph) {
         if (cluster_id.empty()) {
@@ -957,18 +1079,15 @@ void label_propagation_refinement::remap_cluster_ids_fast(const PartitionConfig&
 }
 
 EdgeWeight label_propagation_refinement::parallel_label_propagation(PartitionConfig& config, graph_access& G) {
-        CLOCK_START;
         std::vector <std::vector<PartitionID>> hash_maps(config.num_threads, std::vector<PartitionID>(config.k));
         Cvector <AtomicWrapper<NodeWeight>> cluster_sizes(config.k);
-        CLOCK_END("Uncoarsening: Init other vectors lp");
 
-        CLOCK_START_N;
         parallel::ParallelVector<Pair> permutation(G.number_of_nodes());
         {
-                CLOCK_START;
+                SCOPED_TIMER("generate_permutation");
                 std::atomic<NodeID> offset(0);
                 NodeID block_size = (NodeID) sqrt(G.number_of_nodes());
-                block_size = std::max(block_size, 1000u);
+                block_size = std::max<NodeID>(block_size, 1000);
 
                 parallel::submit_for_all([&](uint32_t thread_id) {
                         parallel::random rnd(config.seed + thread_id);
@@ -987,38 +1106,46 @@ EdgeWeight label_propagation_refinement::parallel_label_propagation(PartitionCon
                                 }
                         }
                 });
-
-                CLOCK_END("Generate permutation");
         }
-        CLOCK_START_N;
         parallel::g_thread_pool.Clear();
         parallel::Unpin();
         {
-                CLOCK_START;
+                SCOPED_TIMER("sort");
                 parallel::sort(permutation.begin(), permutation.end(),
                                [&](const Pair& lhs, const Pair& rhs) {
                                        return lhs.second < rhs.second
                                               || (lhs.second == rhs.second && lhs.first < rhs.first);
                                }, config.num_threads);
-                CLOCK_END("Uncoarsening: Sort");
         }
         parallel::PinToCore(0);
         parallel::g_thread_pool.Resize(config.num_threads - 1);
-        CLOCK_END("Uncoarsening: Sort with pool release");
-
 
         EdgeWeight res = 0;
-        CLOCK_START_N;
-        if (config.parallel_lp_type == ParallelLPType::NO_QUEUE) {
+        if (config.deterministic_parallel) {
+                std::vector<NodeID> order(G.number_of_nodes());
+                std::vector<NodeID> labels(G.number_of_nodes());
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID i) {
+                        order[i] = permutation[i].first;
+                        labels[i] = G.getPartitionIndex(i);
+                });
+                std::vector<NodeWeight> block_weights(config.k, 0);
+                forall_nodes(G, node) {
+                        block_weights[labels[node]] += G.getNodeWeight(node);
+                } endfor
+
+                res = deterministic_label_propagation(G, config, config.upper_bound_partition,
+                                                      config.label_iterations_refinement, order, labels, block_weights);
+                parallel::parallel_for_index(NodeID(0), G.number_of_nodes(), [&](NodeID node) {
+                        G.setPartitionIndex(node, labels[node]);
+                });
+        } else if (config.parallel_lp_type == ParallelLPType::NO_QUEUE) {
                 res = parallel_label_propagation(G, config, cluster_sizes, hash_maps, permutation);
         } else if (config.parallel_lp_type == ParallelLPType::QUEUE) {
                 res = parallel_label_propagation_with_queue(G, config, cluster_sizes, hash_maps, permutation);
         } else {
                 res = 0;
         }
-        CLOCK_END("Uncoarsening: Main parallel (no queue) lp");
-
-        std::cout << "Uncoarsening: Improved\t" << res << std::endl;
+        INSTRUMENTATION_COUNT("label_propagation/changed_labels", res);
         return res;
 }
 
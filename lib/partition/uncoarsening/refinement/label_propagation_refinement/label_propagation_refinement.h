@@ -26,6 +26,7 @@
 
 #include "data_structure/parallel/algorithm.h"
 #include "data_structure/parallel/atomics.h"
+#include "data_structure/parallel/numa_graph_layout.h"
 
 #include "data_structure/parallel/pool_allocator.h"
 #include "data_structure/parallel/thread_pool.h"
@@ -53,7 +54,7 @@ public:
         EdgeWeight parallel_label_propagation_many_clusters(const PartitionConfig& config,
                                                             graph_access& G,
                                                             const NodeWeight block_upperbound,
-                                                            std::vector<NodeWeight>& cluster_id,
+                                                            std::vector<NodeID>& cluster_id,
                                                             NodeID& no_of_blocks);
 
 private:
@@ -103,10 +104,11 @@ private:
         EdgeWeight parallel_label_propagation_with_queue_with_many_clusters(graph_access& G,
                                                                             const PartitionConfig& config,
                                                                             const NodeWeight block_upperbound,
-                                                                            std::vector<NodeWeight>& cluster_id,
+                                                                            std::vector<NodeID>& cluster_id,
                                                                             std::vector<parallel::AtomicWrapper<NodeWeight>>& cluster_sizes,
                                                                             std::vector<std::vector<PartitionID>>& hash_maps,
-                                                                            const parallel::ParallelVector<Triple>& permutation);
+                                                                            const parallel::ParallelVector<Triple>& permutation,
+                                                                            parallel::local_first_scheduler* local_scheduler);
 
         EdgeWeight parallel_label_propagation(graph_access& G,
                                               PartitionConfig& config,
@@ -114,6 +116,23 @@ private:
                                               std::vector<std::vector<PartitionID>>& hash_maps,
                                               const parallel::ParallelVector<Pair>& permutation);
 
+        // Label propagation for config.deterministic_parallel. The nodes of order are visited in
+        // deterministic_rounds slices of at least deterministic_min_slice_size nodes. The nodes of a slice
+        // choose their labels in parallel based on the labels and label sizes before the slice, then the
+        // moves are applied in the order of the slice. Ties are broken by hashing the seed, the iteration
+        // and the node. Only the neighbors of moved nodes are visited again in the next iteration. The
+        // result does not depend on the number of threads.
+        EdgeWeight deterministic_label_propagation(graph_access& G,
+                                                   const PartitionConfig& config,
+                                                   const NodeWeight block_upperbound,
+                                                   const int iterations,
+                                                   const std::vector<NodeID>& order,
+                                                   std::vector<NodeID>& labels,
+                                                   std::vector<NodeWeight>& label_sizes);
+
+        static constexpr NodeID deterministic_rounds = 8;
+        static constexpr NodeID deterministic_min_slice_size = 4096;
+
         template<typename T>
         void seq_init_for_edge_unit(graph_access& G, const uint64_t block_size,
                                     const T& permutation,
@@ -140,11 +159,11 @@ private:
 //                                         std::vector<uint8_t>& bounday_nodes);
 
         void remap_cluster_ids_fast(const PartitionConfig& partition_config, graph_access& G,
-                                    std::vector<NodeWeight>& cluster_id, NodeID& no_of_coarse_vertices,
+                                    std::vector<NodeID>& cluster_id, NodeID& no_of_coarse_vertices,
                                     bool apply_to_graph = false);
 
         void parallel_remap_cluster_ids_fast(const PartitionConfig& partition_config, graph_access& G,
-                                             std::vector<NodeWeight>& cluster_id, NodeID& no_of_coarse_vertices);
+                                             std::vector<NodeID>& cluster_id, NodeID& no_of_coarse_vertices);
 };
 
 
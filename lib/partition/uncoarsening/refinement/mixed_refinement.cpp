@@ -27,7 +27,7 @@
 #include "mixed_refinement.h"
 #include "quotient_graph_refinement/quotient_graph_refinement.h"
 
-#include "data_structure/parallel/time.h"
+#include "tools/instrumentation.h"
 
 mixed_refinement::mixed_refinement() {
         multitry_kway_fm::reset_statistics();
@@ -62,7 +62,7 @@ EdgeWeight mixed_refinement::perform_refinement(PartitionConfig & config, graph_
 
         } else {
                 if(config.corner_refinement_enabled && !config.parallel_multitry_kway) {
-                        CLOCK_START;
+                        SCOPED_TIMER("kway_refinement");
                         quality_metrics qm;
                         EdgeWeight old_cut = 0;
                         if (config.check_cut) {
@@ -78,8 +78,6 @@ EdgeWeight mixed_refinement::perform_refinement(PartitionConfig & config, graph_
                                 std::cout << "improvement\t" << improvement << std::endl;
                                 ALWAYS_ASSERT(old_cut - new_cut == improvement);
                         }
-
-                        CLOCK_END("Kway refinement");
                 }
 
 //                if(config.fastmultitry) {
@@ -115,20 +113,18 @@ EdgeWeight mixed_refinement::perform_refinement(PartitionConfig & config, graph_
 //                }
 
                 if(!config.quotient_graph_refinement_disabled) {
-                        CLOCK_START;
+                        SCOPED_TIMER("quotient_graph_refinement");
 //                        if (!config.kway_all_boundary_nodes_refinement) {
 //                                overall_improvement += refine->perform_refinement(config, G, boundary);
 //                        } else {
 //                                overall_improvement += refine->perform_refinement_all(config, G, boundary);
 //                        }
                         overall_improvement += refine->perform_refinement(config, G, boundary);
-                        CLOCK_END("Quotient graph refinement");
                 }
 
                 if(config.kaffpa_perfectly_balanced_refinement) {
-                        CLOCK_START;
+                        SCOPED_TIMER("cycle_refinement");
                         overall_improvement += cycle_refine->perform_refinement(config, G, boundary);
-                        CLOCK_END("Cycle refinement");
                 }
         }
 
@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+#include "data_structure/parallel/thread_pool.h"
+#include "parallel_localized_fm_ns_local_search.h"
+#include "tools/random_functions.h"
+
+parallel_localized_fm_ns_local_search::parallel_localized_fm_ns_local_search() {
+
+}
+
+parallel_localized_fm_ns_local_search::~parallel_localized_fm_ns_local_search() {
+
+}
+
+EdgeWeight parallel_localized_fm_ns_local_search::perform_refinement(const PartitionConfig & config, graph_access & G,
+                                                                     bool balance, PartitionID to) {
+        std::vector< NodeWeight > block_weights(3, 0);
+        std::vector< NodeID > separator_nodes;
+        forall_nodes(G, node) {
+                block_weights[G.getPartitionIndex(node)] += G.getNodeWeight(node);
+                if (G.getPartitionIndex(node) == 2) {
+                        separator_nodes.push_back(node);
+                }
+        } endfor
+
+        return refine_regions(config, G, separator_nodes, block_weights, balance, to);
+}
+
+EdgeWeight parallel_localized_fm_ns_local_search::perform_refinement(const PartitionConfig & config, graph_access & G,
+                                                                     std::vector< NodeWeight > & block_weights,
+                                                                     PartialBoundary & separator, bool balance, PartitionID to) {
+        std::vector< NodeID > separator_nodes;
+        separator_nodes.reserve(separator.size());
+        forall_boundary_nodes(separator, node) {
+                separator_nodes.push_back(node);
+        } endfor
+
+        EdgeWeight improvement = refine_regions(config, G, separator_nodes, block_weights, balance, to);
+
+        // the searches only changed nodes of the regions
+        for (size_t i = 0; i < m_region_nodes.size(); ++i) {
+                NodeID node = m_region_nodes[i];
+                if (m_old_block[i] == 2 && G.getPartitionIndex(node) != 2) {
+                        separator.deleteNode(node);
+                } else if (m_old_block[i] != 2 && G.getPartitionIndex(node) == 2) {
+                        separator.insert(node);
+                }
+        }
+
+        return improvement;
+}
+
+EdgeWeight parallel_localized_fm_ns_local_search::refine_regions(const PartitionConfig & config, graph_access & G,
+                                                                 std::vector< NodeID > & separator_nodes,
+                                                                 std::vector< NodeWeight > & block_weights,
+                                                                 bool balance, PartitionID to) {
+        m_region_nodes.clear();
+        m_old_block.clear();
+        if (separator_nodes.empty()) {
+                return 0;
+        }
+
+        parallel::random rnd(random_functions::nextInt(0, std::numeric_limits<int>::max()));
+        rnd.shuffle(separator_nodes);
+        grow_regions(config, G, separator_nodes);
+
+        m_moved_out_of_separator.assign(G.number_of_nodes(), false);
+        m_block_weights = block_weights;
+        for (PartitionID block = 0; block < 2; ++block) {
+                m_capacity[block] = int64_t(config.upper_bound_partition) - 1 - int64_t(block_weights[block]);
+        }
+
+        uint32_t num_regions = m_region_begin.size() - 1;
+        uint32_t seed        = rnd.random_number<uint32_t>();
+        std::vector< std::array<int64_t, 3> > thread_delta(parallel::g_thread_pool.NumThreads() + 1, std::array<int64_t, 3>{});
+
+        // the searches of a region only touch nodes of the region
+        std::atomic<uint32_t> next_region(0);
+        parallel::submit_for_all([&](uint32_t thread_id) {
+                parallel::random thread_rnd(seed);
+                for (uint32_t r = next_region.fetch_add(1); r < num_regions; r = next_region.fetch_add(1)) {
+                        thread_rnd.set_seed(seed + r);
+                        region_search search(r, thread_rnd);
+                        refine_region(config, G, search, balance, to);
+
+                        for (PartitionID block = 0; block < 2; ++block) {
+                                m_capacity[block].fetch_add(search.reserved[block] - search.delta[block]);
+                        }
+                        for (PartitionID block = 0; block < 3; ++block) {
+                                thread_delta[thread_id][block] += search.delta[block];
+                        }
+                }
+        });
+
+        int64_t delta[3] = {0, 0, 0};
+        for (const std::array<int64_t, 3> & thread : thread_delta) {
+                for (PartitionID block = 0; block < 3; ++block) {
+                        delta[block] += thread[block];
+                }
+        }
+        for (PartitionID block = 0; block < 3; ++block) {
+                block_weights[block] = m_block_weights[block] + delta[block];
+        }
+
+        return -delta[2];
+}
+
+void parallel_localized_fm_ns_local_search::grow_regions(const PartitionConfig & config, graph_access & G,
+                                                         std::vector< NodeID > & separator_nodes) {
+        NodeID max_region_size = std::max<NodeID>(config.parallel_node_separator_region_size, 1);
+        m_region_of.assign(G.number_of_nodes(), NO_REGION);
+        m_region_begin.assign(1, 0);
+
+        for (NodeID seed : separator_nodes) {
+                if (m_region_of[seed] != NO_REGION) continue;
+
+                uint32_t region = m_region_begin.size() - 1;
+                size_t begin    = m_region_nodes.size();
+                m_region_of[seed] = region;
+                m_region_nodes.push_back(seed);
+                for (size_t i = begin; i < m_region_nodes.size() && m_region_nodes.size() - begin < max_region_size; ++i) {
+                        forall_out_edges(G, e, m_region_nodes[i]) {
+                                NodeID target = G.getEdgeTarget(e);
+                                if (m_region_of[target] == NO_REGION) {
+                                        m_region_of[target] = region;
+                                        m_region_nodes.push_back(target);
+                                        if (m_region_nodes.size() - begin == max_region_size) break;
+                                }
+                        } endfor
+                }
+                m_region_begin.push_back(m_region_nodes.size());
+        }
+
+        m_old_block.resize(m_region_nodes.size());
+        for (size_t i = 0; i < m_region_nodes.size(); ++i) {
+                m_old_block[i] = G.getPartitionIndex(m_region_nodes[i]);
+        }
+}
+
+void parallel_localized_fm_ns_local_search::refine_region(const PartitionConfig & config, graph_access & G,
+                                                          region_search & search, bool balance, PartitionID to) {
+        std::vector< NodeID > start_nodes;
+        for (NodeID i = m_region_begin[search.region]; i < m_region_begin[search.region + 1]; ++i) {
+                NodeID node = m_region_nodes[i];
+                if (G.getPartitionIndex(node) == 2 && is_movable(G, node, search.region)) {
+                        start_nodes.push_back(node);
+                }
+        }
+
+        while (start_nodes.size() > 0) {
+                std::vector< NodeID > real_start_nodes;
+                int no_rnd_nodes = std::min(config.sep_loc_fm_no_snodes, (int)start_nodes.size());
+                for (int i = 0; i < no_rnd_nodes; i++) {
+                        size_t idx      = search.rnd.random_number<size_t>(0, start_nodes.size() - 1);
+                        NodeID cur_node = start_nodes[idx];
+                        std::swap(start_nodes[idx], start_nodes[start_nodes.size() - 1]);
+                        start_nodes.pop_back();
+                        if (G.getPartitionIndex(cur_node) == 2 && !m_moved_out_of_separator[cur_node]) {
+                                real_start_nodes.push_back(cur_node);
+                        }
+                }
+
+                if (real_start_nodes.size() > 0) {
+                        perform_refinement_internal(config, G, search, real_start_nodes, balance, to);
+                }
+        }
+}
+
+void parallel_localized_fm_ns_local_search::perform_refinement_internal(const PartitionConfig & config, graph_access & G,
+                                                                        region_search & search,
+                                                                        std::vector< NodeID > & start_nodes,
+                                                                        bool balance, PartitionID to) {
+        std::vector< maxNodeHeap > queues; queues.resize(2);
+        std::vector< change_set > rollback_info;
+
+        for (NodeID node : start_nodes) {
+                Gain toLHS = 0;
+                Gain toRHS = 0;
+                compute_gain(G, node, toLHS, toRHS);
+
+                queues[0].insert(node, toLHS);
+                queues[1].insert(node, toRHS);
+        }
+
+        auto weight_diff = [&]() {
+                return std::abs((int64_t(m_block_weights[1]) + search.delta[1]) - (int64_t(m_block_weights[0]) + search.delta[0]));
+        };
+
+        int64_t best_delta[3] = {search.delta[0], search.delta[1], search.delta[2]};
+        int64_t best_diff     = weight_diff();
+        size_t undo_idx       = 0;
+
+        int steps_till_last_improvement = 0;
+        //roll forwards
+        while (steps_till_last_improvement < config.sep_loc_fm_unsucc_steps) {
+                Gain gainToA = queues[0].maxValue();
+                Gain gainToB = queues[1].maxValue();
+
+                Gain top_gain        = 0;
+                PartitionID to_block = 0;
+
+                if (balance) {
+                        top_gain = queues[to].maxValue();
+                        to_block = to;
+                } else {
+                        if (gainToA == gainToB) {
+                                top_gain = gainToA;
+                                to_block = search.rnd.bit();
+                        } else {
+                                top_gain = gainToA > gainToB ? gainToA : gainToB;
+                                to_block = top_gain == gainToA ? 0 : 1;
+                        }
+                }
+
+                Gain other_gain = gainToA > gainToB ? gainToB : gainToA;
+                PartitionID other_block = to_block == 0 ? 1 : 0;
+
+                NodeID nodeToBlock = queues[to_block].maxElement();
+                if (can_move_to(search, to_block, G.getNodeWeight(nodeToBlock))) {
+                        queues[to_block].deleteMax();
+                        queues[other_block].deleteNode(nodeToBlock);
+                        move_node(G, search, nodeToBlock, to_block, other_block, queues, rollback_info);
+                } else {
+                        NodeID nodeOtherBlock = queues[other_block].maxElement();
+                        if (other_gain >= 0 && can_move_to(search, other_block, G.getNodeWeight(nodeOtherBlock))) {
+                                queues[other_block].deleteMax();
+                                queues[to_block].deleteNode(nodeOtherBlock);
+                                move_node(G, search, nodeOtherBlock, other_block, to_block, queues, rollback_info);
+                        } else {
+                                // need to make progress (remove a random node from the queues)
+                                if (nodeOtherBlock == nodeToBlock) {
+                                        queues[0].deleteMax();
+                                        queues[1].deleteMax();
+                                } else {
+                                        queues[search.rnd.bit()].deleteMax();
+                                }
+                        }
+                }
+
+                int64_t cur_diff = weight_diff();
+                if (search.delta[2] < best_delta[2] || (search.delta[2] == best_delta[2] && cur_diff < best_diff)) {
+                        std::copy(search.delta, search.delta + 3, best_delta);
+                        best_diff                   = cur_diff;
+                        undo_idx                    = rollback_info.size();
+                        steps_till_last_improvement = 0;
+                } else {
+                        steps_till_last_improvement++;
+                }
+
+                if (queues[0].empty() || queues[1].empty()) {
+                        break;
+                }
+        }
+
+        // roll back
+        for (size_t i = rollback_info.size(); i > undo_idx; i--) {
+                G.setPartitionIndex(rollback_info[i - 1].node, rollback_info[i - 1].block);
+        }
+        std::copy(best_delta, best_delta + 3, search.delta);
+}
+
+bool parallel_localized_fm_ns_local_search::can_move_to(region_search & search, PartitionID block, NodeWeight weight) {
+        int64_t needed = search.delta[block] + int64_t(weight) - search.reserved[block];
+        if (needed <= 0) {
+                return true;
+        }
+
+        int64_t capacity = m_capacity[block].load(std::memory_order_relaxed);
+        while (capacity >= needed) {
+                if (m_capacity[block].compare_exchange_weak(capacity, capacity - needed)) {
+                        search.reserved[block] += needed;
+                        return true;
+                }
+        }
+        return false;
+}
+
+void parallel_localized_fm_ns_local_search::move_node(graph_access & G, region_search & search, NodeID node,
+                                                      PartitionID to_block, PartitionID other_block,
+                                                      std::vector< maxNodeHeap > & queues,
+                                                      std::vector< change_set > & rollback_info) {
+        rollback_info.push_back(change_set{node, G.getPartitionIndex(node)});
+
+        G.setPartitionIndex(node, to_block);
+        search.delta[to_block] += G.getNodeWeight(node);
+        search.delta[2]        -= G.getNodeWeight(node);
+        m_moved_out_of_separator[node] = true;
+
+        // node is movable, hence all its neighbors belong to the region. neighbors of pulled nodes may not,
+        // but only nodes in the queues are updated and those are movable as well
+        std::vector< NodeID > to_be_added;
+        std::vector< NodeID > to_be_updated;
+        forall_out_edges(G, e, node) {
+                NodeID target = G.getEdgeTarget(e);
+
+                if (G.getPartitionIndex(target) == other_block) {
+                        rollback_info.push_back(change_set{target, other_block});
+
+                        G.setPartitionIndex(target, 2);
+                        search.delta[other_block] -= G.getNodeWeight(target);
+                        search.delta[2]           += G.getNodeWeight(target);
+
+                        if (!m_moved_out_of_separator[target] && is_movable(G, target, search.region)) {
+                                to_be_added.push_back(target);
+                        }
+
+                        forall_out_edges(G, e_bar, target) {
+                                NodeID v = G.getEdgeTarget(e_bar);
+                                if (queues[0].contains(v)) {
+                                        to_be_updated.push_back(v);
+                                }
+                        } endfor
+                } else if (G.getPartitionIndex(target) == 2 && queues[0].contains(target)) {
+                        to_be_updated.push_back(target);
+                }
+        } endfor
+
+        Gain toLHS = 0;
+        Gain toRHS = 0;
+
+        for (NodeID v : to_be_added) {
+                compute_gain(G, v, toLHS, toRHS);
+                queues[0].insert(v, toLHS);
+                queues[1].insert(v, toRHS);
+        }
+
+        for (NodeID v : to_be_updated) {
+                compute_gain(G, v, toLHS, toRHS);
+                queues[0].changeKey(v, toLHS);
+                queues[1].changeKey(v, toRHS);
+        }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "data_structure/graph_access.h"
+#include "data_structure/parallel/random.h"
+#include "data_structure/priority_queues/maxNodeHeap.h"
+#include "definitions.h"
+#include "fm_ns_local_search.h"
+#include "partition_config.h"
+#include "uncoarsening/refinement/quotient_graph_refinement/partial_boundary.h"
+
+// localized fm node separator search that runs on disjoint regions around the separator concurrently.
+// the regions are grown by bfs from the separator nodes in random order. a search only moves separator nodes
+// whose whole neighborhood lies in its region, so every partition index it reads or writes belongs to the region.
+// the searches share the remaining capacity of the two blocks, a search reserves capacity before it makes a
+// block heavier than the search has made it so far and returns what it does not use when the region is done.
+class parallel_localized_fm_ns_local_search {
+public:
+        parallel_localized_fm_ns_local_search();
+        virtual ~parallel_localized_fm_ns_local_search();
+
+        EdgeWeight perform_refinement(const PartitionConfig & config, graph_access & G, bool balance = false, PartitionID to = 4);
+        EdgeWeight perform_refinement(const PartitionConfig & config, graph_access & G, std::vector< NodeWeight > & block_weights,
+                                      PartialBoundary & separator, bool balance = false, PartitionID to = 4);
+
+private:
+        static constexpr uint32_t NO_REGION = std::numeric_limits<uint32_t>::max();
+
+        // state of the searches of one region
+        struct region_search {
+                uint32_t region;
+                parallel::random & rnd;
+                // weight changes of the blocks and the separator made by the searches of the region
+                int64_t delta[3];
+                // capacity of the blocks taken from m_capacity
+                int64_t reserved[2];
+
+                region_search(uint32_t region, parallel::random & rnd) : region(region), rnd(rnd), delta{0, 0, 0}, reserved{0, 0} {}
+        };
+
+        // moves the separator nodes of the regions and updates block_weights, returns the separator weight removed
+        EdgeWeight refine_regions(const PartitionConfig & config, graph_access & G, std::vector< NodeID > & separator_nodes,
+                                  std::vector< NodeWeight > & block_weights, bool balance, PartitionID to);
+
+        void grow_regions(const PartitionConfig & config, graph_access & G, std::vector< NodeID > & separator_nodes);
+
+        void refine_region(const PartitionConfig & config, graph_access & G, region_search & search, bool balance, PartitionID to);
+
+        void perform_refinement_internal(const PartitionConfig & config, graph_access & G, region_search & search,
+                                         std::vector< NodeID > & start_nodes, bool balance, PartitionID to);
+
+        // whether the search may add weight to block, reserves capacity if necessary
+        bool can_move_to(region_search & search, PartitionID block, NodeWeight weight);
+
+        bool is_movable(graph_access & G, NodeID node, uint32_t region) const;
+
+        void compute_gain(graph_access & G, NodeID node, Gain & toLHS, Gain & toRHS);
+
+        void move_node(graph_access & G, region_search & search, NodeID node, PartitionID to_block, PartitionID other_block,
+                       std::vector< maxNodeHeap > & queues, std::vector< change_set > & rollback_info);
+
+        // region of every node, NO_REGION for nodes not in any region
+        std::vector< uint32_t > m_region_of;
+        // nodes of region r are m_region_nodes[m_region_begin[r]] to m_region_nodes[m_region_begin[r + 1] - 1]
+        std::vector< NodeID > m_region_nodes;
+        std::vector< NodeID > m_region_begin;
+        // partition index of m_region_nodes[i] before the searches
+        std::vector< PartitionID > m_old_block;
+        // nodes that were moved out of the separator, they are not moved again during a call
+        std::vector< uint8_t > m_moved_out_of_separator;
+        // block weights before the searches
+        std::vector< NodeWeight > m_block_weights;
+        // capacity of the blocks 0 and 1 that is not reserved by a search
+        std::atomic<int64_t> m_capacity[2];
+};
+
+inline
+bool parallel_localized_fm_ns_local_search::is_movable(graph_access & G, NodeID node, uint32_t region) const {
+        if (m_region_of[node] != region) {
+                return false;
+        }
+        forall_out_edges(G, e, node) {
+                if (m_region_of[G.getEdgeTarget(e)] != region) {
+                        return false;
+                }
+        } endfor
+        return true;
+}
+
+inline
+void parallel_localized_fm_ns_local_search::compute_gain(graph_access & G, NodeID node, Gain & toLHS, Gain & toRHS) {
+        toLHS = G.getNodeWeight(node);
+        toRHS = G.getNodeWeight(node);
+
+        forall_out_edges(G, e, node) {
+                NodeID target = G.getEdgeTarget(e);
+                if (G.getPartitionIndex(target) == 0) {
+                        toRHS -= G.getNodeWeight(target);
+                } else if (G.getPartitionIndex(target) == 1) {
+                        toLHS -= G.getNodeWeight(target);
+                }
+        } endfor
+}
@@ -2,9 +2,10 @@
 #include "data_structure/graph_access.h"
 #include "data_structure/parallel/graph_algorithm.h"
 #include "data_structure/parallel/hash_table.h"
+#include "data_structure/parallel/numa_graph_layout.h"
 #include "data_structure/parallel/task_queue.h"
-#include "data_structure/parallel/time.h"
 #include "definitions.h"
+#include "tools/instrumentation.h"
 
 #include <functional>
 #include <vector>
@@ -277,7 +278,7 @@ public:
                 }
 
                 // ------------------
-                CLOCK_START;
+                SCOPED_TIMER("copy_to_hash_tables");
                 m_boundaries_per_thread.resize(m_config.num_threads);
 
                 auto task_copy_to_hash_tables = [this, &containers] (uint32_t thread_id) {
@@ -287,7 +288,7 @@ public:
                                 total_size += sub_container.get().size();
                         }
 
-                        m_boundaries_per_thread[thread_id].get().reserve(std::max(total_size, 16u));
+                        m_boundaries_per_thread[thread_id].get().reserve(std::max<NodeID>(total_size, 16));
 
                         for (const auto& sub_container : container) {
                                 for (const auto& elem : sub_container.get()) {
@@ -303,13 +304,12 @@ public:
                 for (size_t i = 0; i < parallel::g_thread_pool.NumThreads(); ++i) {
                         futures_other.push_back(parallel::g_thread_pool.Submit(i, task_copy_to_hash_tables, i + 1));
                 }
-                std::cout << task_copy_to_hash_tables(0) << " ";
+                NodeID boundary_size = task_copy_to_hash_tables(0);
 
                 std::for_each(futures_other.begin(), futures_other.end(), [&](auto& future){
-                        std::cout << future.get() << " ";
+                        boundary_size += future.get();
                 });
-                std::cout << std::endl;
-                CLOCK_END("Copy to hash table");
+                INSTRUMENTATION_COUNT("boundary/vertices", boundary_size);
         }
 
         const hash_map_with_erase_type& operator[] (uint32_t thread_id) const {
@@ -420,17 +420,15 @@ private:
 
         template <typename TGraph, typename TFunctor>
         void distribute_boundary_vertices(TGraph& graph, container_collection_type& containers, TFunctor&& bnd_func) {
-                CLOCK_START;
+                SCOPED_TIMER("distribute_boundary_vertices");
 
-                NodeID block_size = std::max<NodeID>(sqrt(graph.number_of_nodes()), 1000);
+                node_block_scheduler scheduler(m_G, m_config);
 
-                std::atomic<NodeID> offset(0);
-                auto task_distribute = [this, &containers, &offset, block_size, &bnd_func, &graph] (uint32_t thread_id) {
+                auto task_distribute = [this, &containers, &scheduler, &bnd_func, &graph] (uint32_t thread_id) {
                         std::vector<block_data_type> blocks_info(m_G.get_partition_count());
-                        NodeID begin = offset.fetch_add(block_size, std::memory_order_relaxed);
-                        while (begin < graph.number_of_nodes()) {
-                                NodeID end = std::min(begin + block_size, graph.number_of_nodes());
-
+                        size_t begin;
+                        size_t end;
+                        while (scheduler.next_block(thread_id, begin, end)) {
                                 for (NodeID node = begin; node != end; ++node) {
                                         PartitionID cur_part = graph.getPartitionIndex(node);
                                         int32_t num_external_neighbors = bnd_func(node, thread_id);
@@ -442,7 +440,6 @@ private:
                                                 container.concurrent_emplace_back(node, num_external_neighbors);
                                         }
                                 }
-                                begin = offset.fetch_add(block_size, std::memory_order_relaxed);
                         }
                         return blocks_info;
                 };
@@ -458,10 +455,43 @@ private:
                                 }
                         }
                 }, m_blocks_info);
-                CLOCK_END("Distribute boundary vertices");
         }
 
 protected:
+        // hands out blocks of the nodes of a pass over all nodes. With the NUMA layout every thread
+        // scans its own node range first, then the ranges of its socket and then the other sockets.
+        class node_block_scheduler {
+        public:
+                node_block_scheduler(graph_access& G, const PartitionConfig& config)
+                        :       m_num_nodes(G.number_of_nodes())
+                        ,       m_block_size(std::max<NodeID>(sqrt(G.number_of_nodes()), 1000))
+                        ,       m_offset(0)
+                {
+                        if (config.numa_graph_layout) {
+                                parallel::numa_graph_layout layout(G, config.num_threads, config.threads_per_socket);
+                                m_local_scheduler = std::make_unique<parallel::local_first_scheduler>(layout.ranges(),
+                                                                                                      config.threads_per_socket,
+                                                                                                      m_block_size);
+                        }
+                }
+
+                // returns false if no nodes are left
+                bool next_block(uint32_t thread_id, size_t& begin, size_t& end) {
+                        if (m_local_scheduler) {
+                                return m_local_scheduler->next_chunk(thread_id, begin, end);
+                        }
+                        begin = m_offset.fetch_add(m_block_size, std::memory_order_relaxed);
+                        end = std::min<size_t>(begin + m_block_size, m_num_nodes);
+                        return begin < m_num_nodes;
+                }
+
+        private:
+                const size_t m_num_nodes;
+                const size_t m_block_size;
+                std::atomic<size_t> m_offset;
+                std::unique_ptr<parallel::local_first_scheduler> m_local_scheduler;
+        };
+
         std::vector<parallel::Cvector<parallel::thread_container<NodeID>>> m_containers;
         parallel::xxhash<NodeID> m_primary_hash;
         parallel::xxhash<NodeID> m_secondary_hash;
@@ -608,7 +638,71 @@ public:
                                 });
                         }
                 }
-                std::cout << "Boundary size\t" << m_ht_handles[0].get().element_count_approx() << std::endl;
+                INSTRUMENTATION_COUNT("boundary/vertices", m_ht_handles[0].get().element_count_approx());
+        }
+
+        // Projects the partition of coarser onto the graph of this boundary and constructs the boundary
+        // in the same pass. A fine vertex can only be a boundary vertex if its coarse vertex is one, so only
+        // the edges of the vertices with coarser_boundary[coarse_mapping[vertex]] set are scanned. The
+        // blocks of their neighbors are taken from coarser, the neighbors need not be projected yet.
+        void project_and_construct_boundary(graph_access& coarser, const CoarseMapping& coarse_mapping,
+                                            const std::vector<uint8_t>& coarser_boundary) {
+                node_block_scheduler scheduler(m_G, m_config);
+
+                auto task_project = [&, this] (uint32_t thread_id) {
+                        std::vector<block_data_type> blocks_info(m_G.get_partition_count());
+                        auto& ht_handle = m_ht_handles[thread_id].get();
+                        size_t begin;
+                        size_t end;
+                        while (scheduler.next_block(thread_id, begin, end)) {
+                                for (NodeID node = begin; node != end; ++node) {
+                                        NodeID coarser_node = coarse_mapping[node];
+                                        PartitionID cur_part = coarser.getPartitionIndex(coarser_node);
+                                        m_G.setPartitionIndex(node, cur_part);
+
+                                        ++blocks_info[cur_part].block_size;
+                                        blocks_info[cur_part].block_weight += m_G.getNodeWeight(node);
+
+                                        if (!coarser_boundary[coarser_node]) {
+                                                continue;
+                                        }
+
+                                        int32_t num_external_neighbors = 0;
+                                        forall_out_edges(m_G, e, node) {
+                                                NodeID target = m_G.getEdgeTarget(e);
+                                                if (coarser.getPartitionIndex(coarse_mapping[target]) != cur_part) {
+                                                        ++num_external_neighbors;
+                                                }
+                                        } endfor
+                                        if (num_external_neighbors > 0) {
+                                                ht_handle.insert(node, num_external_neighbors);
+                                        }
+                                }
+                        }
+                        return blocks_info;
+                };
+
+                m_blocks_info.clear();
+                submit_for_all(task_project, [](auto& result, auto&& new_value) {
+                        if (result.empty()) {
+                                result = std::move(new_value);
+                        } else {
+                                for (size_t i = 0; i < result.size(); ++i) {
+                                        result[i].block_size += new_value[i].block_size;
+                                        result[i].block_weight += new_value[i].block_weight;
+                                }
+                        }
+                }, m_blocks_info);
+                INSTRUMENTATION_COUNT("boundary/vertices", m_ht_handles[0].get().element_count_approx());
+        }
+
+        // sets is_boundary[vertex] for every boundary vertex and resets it for all other vertices
+        void get_boundary_vertices(std::vector<uint8_t>& is_boundary) {
+                is_boundary.assign(m_G.number_of_nodes(), false);
+                auto& ht_handle = m_ht_handles[0].get();
+                for (auto it = ht_handle.begin(); it != ht_handle.end(); ++it) {
+                        is_boundary[(*it).first] = true;
+                }
         }
 
         const concurrent_ht_handle_type& operator[] (uint32_t thread_id) const {
@@ -695,17 +789,15 @@ private:
 
         template <typename TGraph, typename TFunctor>
         void distribute_boundary_vertices(TGraph& graph, TFunctor&& bnd_func) {
-                CLOCK_START;
-                NodeID block_size = std::max<NodeID>(sqrt(graph.number_of_nodes()), 1000);
+                SCOPED_TIMER("distribute_boundary_vertices");
+                node_block_scheduler scheduler(m_G, m_config);
 
-                std::atomic<NodeID> offset(0);
-                auto task_distribute = [this, &offset, block_size, &bnd_func, &graph] (uint32_t thread_id) {
+                auto task_distribute = [this, &scheduler, &bnd_func, &graph] (uint32_t thread_id) {
                         std::vector<block_data_type> blocks_info(m_G.get_partition_count());
-                        NodeID begin = offset.fetch_add(block_size, std::memory_order_relaxed);
                         auto& ht_handle = m_ht_handles[thread_id].get();
-                        while (begin < graph.number_of_nodes()) {
-                                NodeID end = std::min(begin + block_size, graph.number_of_nodes());
-
+                        size_t begin;
+                        size_t end;
+                        while (scheduler.next_block(thread_id, begin, end)) {
                                 for (NodeID node = begin; node != end; ++node) {
                                         PartitionID cur_part = graph.getPartitionIndex(node);
                                         int32_t num_external_neighbors = bnd_func(node, thread_id);
@@ -716,7 +808,6 @@ private:
                                                 ht_handle.insert(node, num_external_neighbors);
                                         }
                                 }
-                                begin = offset.fetch_add(block_size, std::memory_order_relaxed);
                         }
                         return blocks_info;
                 };
@@ -732,7 +823,6 @@ private:
                                 }
                         }
                 }, m_blocks_info);
-                CLOCK_END("Distribute boundary vertices");
         }
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <limits>
 #include <map>
 #include "data_structure/graph_access.h"
 #include "data_structure/parallel/algorithm.h"
@@ -41,6 +42,9 @@ public:
         //std::vector<AtomicWrapper<bool>> moved_idx;
         std::vector<NodeWeight> parts_weights;
         std::vector<NodeWeight> parts_sizes;
+        // nodes the thread may move, all nodes unless the search is deterministic
+        NodeID owned_begin;
+        NodeID owned_end;
 
         boundary_starting_nodes start_nodes;
         std::unique_ptr<nodes_partitions_hash_table> nodes_partitions;
@@ -102,6 +106,8 @@ public:
 //                ,       parts_sizes(_parts_sizes)
                 ,       moved_count(_moved_count)
                 ,       num_threads_finished(_num_threads_finished)
+                ,       owned_begin(0)
+                ,       owned_end(std::numeric_limits<NodeID>::max())
                 ,       nodes_partitions(nullptr)
                 ,       queue(nullptr)
                 ,       total_thread_time(0.0)
@@ -152,6 +158,10 @@ public:
         thread_data_refinement_core& operator=(const thread_data_refinement_core&) = delete;
         thread_data_refinement_core& operator=(thread_data_refinement_core&&) = delete;
 
+        inline bool owns(NodeID node) const {
+                return owned_begin <= node && node < owned_end;
+        }
+
         inline PartitionID get_local_partition(NodeID node) {
                 // ht
                 PartitionID part;
@@ -26,6 +26,7 @@
 #include "data_structure/parallel/time.h"
 #include "data_structure/priority_queues/bucket_pq.h"
 #include "data_structure/priority_queues/maxNodeHeap.h"
+#include "tools/instrumentation.h"
 #include "tools/random_functions.h"
 #include "uncoarsening/refinement/kway_graph_refinement/kway_stop_rule.h"
 #include "uncoarsening/refinement/parallel_kway_graph_refinement/kway_graph_refinement_core.h"
@@ -242,6 +243,9 @@ std::vector<std::future<void>> kway_graph_refinement_core::prepare_boundary(uint
                         }
 
                         uint32_t end = (uint32_t) td.min_cut_indices[i].first;
+                        // the main thread applies moves meanwhile, so filtering the neighbors by their blocks
+                        // depends on timing. All of them are checked in deterministic mode.
+                        const bool all_neighbors = td.config.deterministic_parallel;
 
                         uint32_t begin = 0;
                         if (i > 0) {
@@ -257,7 +261,7 @@ std::vector<std::future<void>> kway_graph_refinement_core::prepare_boundary(uint
                                         forall_out_edges(td.G, e, node){
                                                 NodeID target = td.G.getEdgeTarget(e);
                                                 PartitionID part = td.G.getPartitionIndex(target);
-                                                if (part == td.to_partitions[index] || part == td.from_partitions[index]) {
+                                                if (all_neighbors || part == td.to_partitions[index] || part == td.from_partitions[index]) {
                                                         td.boundary.add_vertex_to_check(target);
                                                 }
                                         } endfor
@@ -278,13 +282,12 @@ std::vector<std::future<void>> kway_graph_refinement_core::prepare_boundary(uint
 }
 
 void kway_graph_refinement_core::update_boundary(thread_data_refinement_core& td) const {
-        CLOCK_START;
+        SCOPED_TIMER("update_boundary");
         if (parallel::g_thread_pool.NumThreads() > 0) {
                 CLOCK_START;
                 td.boundary.finish_movements();
                 td.time_move_nodes_change_boundary += CLOCK_END_TIME;
         }
-        CLOCK_END("update boundary movements");
 }
 
 EdgeWeight kway_graph_refinement_core::apply_moves(thread_data_refinement_core& td,
@@ -346,7 +349,7 @@ EdgeWeight kway_graph_refinement_core::apply_moves(thread_data_refinement_core&
                                                 forall_out_edges(td.G, e, cur_node) {
                                                         NodeID target = td.G.getEdgeTarget(e);
                                                         PartitionID part = td.G.getPartitionIndex(target);
-                                                        if (part == from || part == to) {
+                                                        if (td.config.deterministic_parallel || part == from || part == to) {
                                                                 td.boundary.add_vertex_to_check(target);
                                                         }
                                                 } endfor
@@ -417,7 +420,7 @@ void kway_graph_refinement_core::init_queue_with_boundary(thread_data_refinement
 
         for (NodeID node : td.start_nodes) {
                 bool expected = false;
-                if (td.moved_idx[node].compare_exchange_strong(expected, true, std::memory_order_relaxed)) {
+                if (td.owns(node) && td.moved_idx[node].compare_exchange_strong(expected, true, std::memory_order_relaxed)) {
                         PartitionID max_gainer;
                         EdgeWeight ext_degree;
                         //compute gain
@@ -601,8 +604,8 @@ inline bool kway_graph_refinement_core::local_move_node(thread_data_refinement_c
                                 queue->deleteNode(target);
                         }
                 } else {
-                        // target was removed from priority queue
-                        if (td.moved_idx[target].load(std::memory_order_relaxed)) {
+                        // target was removed from priority queue or belongs to another thread
+                        if (!td.owns(target) || td.moved_idx[target].load(std::memory_order_relaxed)) {
                                 continue;
                         }
 
@@ -1,5 +1,7 @@
+#include "data_structure/parallel/numa_graph_layout.h"
 #include "data_structure/parallel/thread_pool.h"
 #include "data_structure/parallel/time.h"
+#include "tools/instrumentation.h"
 
 #include "uncoarsening/refinement/parallel_kway_graph_refinement/kway_graph_refinement_core.h"
 #include "uncoarsening/refinement/parallel_kway_graph_refinement/multitry_kway_fm.h"
@@ -30,12 +32,11 @@ int multitry_kway_fm::perform_refinement(PartitionConfig& config, graph_access&
 
                 m_factory.time_setup_start_nodes += CLOCK_END_TIME;
 
-                std::cout << "Iter\t" << i << std::endl;
+                INSTRUMENTATION_COUNT("multitry_kway_fm/rounds", 1);
                 CLOCK_START_N;
                 EdgeWeight improvement = start_more_locallized_search(G, config, init_neighbors);
                 m_factory.time_local_search += CLOCK_END_TIME;
 
-                std::cout << "Gain improvement\t" << improvement << std::endl;
                 if (improvement == 0) {
                         break;
                 }
@@ -46,7 +47,6 @@ int multitry_kway_fm::perform_refinement(PartitionConfig& config, graph_access&
 
                 overall_improvement += improvement;
         }
-        std::cout << "Total gain improvement\t" << overall_improvement << std::endl;
         config.kway_adaptive_limits_alpha = tmp_alpha;
         config.kway_stop_rule = tmp_stop;
         ASSERT_TRUE(overall_improvement >= 0);
@@ -113,6 +113,20 @@ int multitry_kway_fm::start_more_locallized_search(graph_access& G, PartitionCon
 #endif
         Gain total_gain_improvement = 0;
 
+        // In deterministic mode every thread only moves the nodes of its range and only takes start nodes
+        // from its own queue. No thread waits for or stops because of another one, so the moves of a
+        // thread only depend on its queue and on the partition before the parallel phase.
+        const bool deterministic = config.deterministic_parallel;
+        std::unique_ptr<parallel::numa_graph_layout> layout;
+        if (deterministic) {
+                layout = std::make_unique<parallel::numa_graph_layout>(G, num_threads, config.threads_per_socket);
+                for (uint32_t id = 0; id < num_threads; ++id) {
+                        auto& td = m_factory.get_thread_data(id);
+                        td.owned_begin = layout->range_begin(id);
+                        td.owned_end = layout->range_end(id);
+                }
+        }
+
 #ifdef COMPARE_WITH_SEQUENTIAL_KAHIP
         while (!todolist.empty()) {
 #else
@@ -126,6 +140,10 @@ int multitry_kway_fm::start_more_locallized_search(graph_access& G, PartitionCon
 
                         auto& td = m_factory.get_thread_data(id);
                         td.reset_thread_data();
+                        if (deterministic) {
+                                // the state of the thread local generator depends on earlier tasks of the pool thread
+                                random_functions::setSeed(td.rnd.random_number(0u, (uint32_t) std::numeric_limits<int>::max()));
+                        }
 
                         td.step_limit = local_step_limit;
                         NodeID nodes_processed = 0;
@@ -135,7 +153,7 @@ int multitry_kway_fm::start_more_locallized_search(graph_access& G, PartitionCon
                                 int random_idx = random_functions::nextInt(0, todolist.size() - 1);
                                 NodeID node = todolist[random_idx];
 #else
-                        while (m_factory.queue.try_pop(node, id)) {
+                        while (deterministic ? m_factory.queue[id].try_pop(node) : m_factory.queue.try_pop(node, id)) {
 #endif
                                 // this change changes num part accesses since it changes random source
 #ifdef COMPARE_WITH_SEQUENTIAL_KAHIP
@@ -159,7 +177,7 @@ int multitry_kway_fm::start_more_locallized_search(graph_access& G, PartitionCon
                                                         forall_out_edges(G, e, node) {
                                                                 ++td.scaned_neighbours;
                                                                 NodeID target = G.getEdgeTarget(e);
-                                                                if (!td.moved_idx[target].load(std::memory_order_relaxed)) {
+                                                                if (td.owns(target) && !td.moved_idx[target].load(std::memory_order_relaxed)) {
                                                                         extdeg = 0;
                                                                         PartitionID from = td.get_local_partition(target);
                                                                         td.compute_gain(target, from, maxgainer, extdeg);
@@ -201,12 +219,18 @@ int multitry_kway_fm::start_more_locallized_search(graph_access& G, PartitionCon
 
                                 if (!td.config.kway_all_boundary_nodes_refinement) {
                                         int overall_movement = 0;
-                                        for (uint32_t id = 0; id < num_threads; ++id) {
-                                                int moved = td.moved_count[id].get().load(std::memory_order_relaxed);
-                                                overall_movement += moved;
+                                        double movement_limit = 0.05 * G.number_of_nodes();
+                                        if (deterministic) {
+                                                overall_movement = td.moved_count[id].get().load(std::memory_order_relaxed);
+                                                movement_limit /= num_threads;
+                                        } else {
+                                                for (uint32_t id = 0; id < num_threads; ++id) {
+                                                        int moved = td.moved_count[id].get().load(std::memory_order_relaxed);
+                                                        overall_movement += moved;
+                                                }
                                         }
 
-                                        if (overall_movement > 0.05 * G.number_of_nodes()) {
+                                        if (overall_movement > movement_limit) {
                                                 ++td.stop_faction_of_nodes_moved;
                                                 res = true;
                                                 break;
@@ -218,7 +242,9 @@ int multitry_kway_fm::start_more_locallized_search(graph_access& G, PartitionCon
 #endif
                         }
 
-                        td.num_threads_finished.fetch_add(1, std::memory_order_acq_rel);
+                        if (!deterministic) {
+                                td.num_threads_finished.fetch_add(1, std::memory_order_acq_rel);
+                        }
                         td.total_thread_time += CLOCK_END_TIME;
 //                        if (id > 0) {
 //                                finished_threads.push(id);
@@ -275,7 +301,11 @@ int multitry_kway_fm::start_more_locallized_search(graph_access& G, PartitionCon
                         m_factory.get_thread_data(0).rnd.shuffle(reactivated_vertices);
 
                         for (auto vertex : reactivated_vertices) {
-                                m_factory.queue.push(vertex);
+                                if (deterministic) {
+                                        m_factory.queue[layout->owner(vertex)].push_back(vertex);
+                                } else {
+                                        m_factory.queue.push(vertex);
+                                }
                         }
                         m_factory.time_reactivate_vertices += CLOCK_END_TIME;
                 }
@@ -303,6 +333,12 @@ void multitry_kway_fm::setup_start_nodes_all(graph_access& G, PartitionConfig& c
         for (const auto& boundary_pair : boundary) {
                 NodeID bnd_node = boundary_pair.first;
 
+                if (config.deterministic_parallel) {
+                        // move_start_nodes_to_owners distributes them
+                        m_factory.queue[0].push_back(bnd_node);
+                        continue;
+                }
+
                 uint32_t bucket_one = td.rnd.random_number(0u, config.num_threads - 1);
                 uint32_t bucket_two = td.rnd.random_number(0u, config.num_threads - 1);
                 if (m_factory.queue[bucket_one].size() <= m_factory.queue[bucket_two].size()) {
@@ -312,6 +348,11 @@ void multitry_kway_fm::setup_start_nodes_all(graph_access& G, PartitionConfig& c
                 }
         }
 
+        if (config.deterministic_parallel) {
+                move_start_nodes_to_owners(G, config);
+                return;
+        }
+
         parallel::submit_for_all([this](uint32_t thread_id) {
                 auto& td = m_factory.get_thread_data(thread_id);
                 auto& thread_container = m_factory.queue[thread_id];
@@ -324,71 +365,100 @@ void multitry_kway_fm::setup_start_nodes_all(graph_access& G, PartitionConfig& c
 void multitry_kway_fm::setup_start_nodes_all(graph_access& G, PartitionConfig& config, parallel::fast_parallel_boundary& boundary) {
         ALWAYS_ASSERT(config.num_threads > 0);
 
-        CLOCK_START;
-        parallel::submit_for_all([this, &boundary](uint32_t thread_id) {
-                CLOCK_START;
-                auto& thread_container = m_factory.queue[thread_id];
-                auto& ht = boundary[thread_id];
-                thread_container.reserve(ht.size());
-                for (const auto& elem : ht) {
-                        thread_container.push_back(elem.first);
-                }
-                if (thread_id == 0) {
-                        CLOCK_END("Time copy from ht");
-                }
+        // which thread collects which boundary node depends on the schedule
+        const bool deterministic = config.deterministic_parallel;
+        {
+                SCOPED_TIMER("copy_and_shuffle");
+                parallel::submit_for_all([this, &boundary, deterministic](uint32_t thread_id) {
+                        auto& thread_container = m_factory.queue[thread_id];
+                        auto& ht = boundary[thread_id];
+                        thread_container.reserve(ht.size());
+                        for (const auto& elem : ht) {
+                                thread_container.push_back(elem.first);
+                        }
 
-                CLOCK_START_N;
-                auto& td = m_factory.get_thread_data(thread_id);
-                td.rnd.shuffle(thread_container.begin(), thread_container.end());
-                if (thread_id == 0) {
-                        CLOCK_END("Time shuffle");
-                }
-        });
-        CLOCK_END("Copy and shuffle");
+                        auto& td = m_factory.get_thread_data(thread_id);
+                        if (!deterministic) {
+                                td.rnd.shuffle(thread_container.begin(), thread_container.end());
+                        }
+                });
+        }
 
-        CLOCK_START_N;
-        shuffle_task_queue();
-        CLOCK_END("Additional shuffle");
+        SCOPED_TIMER("distribute_start_nodes");
+        if (config.numa_graph_layout || config.deterministic_parallel) {
+                move_start_nodes_to_owners(G, config);
+        } else {
+                shuffle_task_queue();
+        }
 }
 
 void multitry_kway_fm::setup_start_nodes_all(graph_access& G, PartitionConfig& config, parallel::fast_parallel_boundary_exp& boundary) {
         ALWAYS_ASSERT(config.num_threads > 0);
-        CLOCK_START;
         std::atomic<size_t> offset(0);
-        parallel::submit_for_all([this, &boundary, &offset](uint32_t thread_id) {
-                CLOCK_START;
-                auto& thread_container = m_factory.queue[thread_id];
-                auto& ht_hadle = boundary[thread_id];
-                size_t size = ht_hadle.capacity();
-                const size_t block_size = std::min<size_t>(sqrt(size), 1000);
-                size_t begin = offset.fetch_add(block_size);
+        // which thread collects which boundary node depends on the schedule
+        const bool deterministic = config.deterministic_parallel;
+        {
+                SCOPED_TIMER("copy_and_shuffle");
+                parallel::submit_for_all([this, &boundary, &offset, deterministic](uint32_t thread_id) {
+                        auto& thread_container = m_factory.queue[thread_id];
+                        auto& ht_hadle = boundary[thread_id];
+                        size_t size = ht_hadle.capacity();
+                        const size_t block_size = std::min<size_t>(sqrt(size), 1000);
+                        size_t begin = offset.fetch_add(block_size);
+
+                        while (begin < size)
+                        {
+                                auto it = ht_hadle.range(begin, begin + block_size);
+
+                                for (; it != ht_hadle.range_end(); ++it) {
+                                        thread_container.push_back((*it).first);
+                                }
+                                begin = offset.fetch_add(block_size);
+                        }
 
-                while (begin < size)
-                {
-                        auto it = ht_hadle.range(begin, begin + block_size);
+                        auto& td = m_factory.get_thread_data(thread_id);
+                        if (!deterministic) {
+                                td.rnd.shuffle(thread_container.begin(), thread_container.end());
+                        }
+                });
+        }
+
+        SCOPED_TIMER("distribute_start_nodes");
+        if (config.numa_graph_layout || config.deterministic_parallel) {
+                move_start_nodes_to_owners(G, config);
+        } else {
+                shuffle_task_queue();
+        }
+}
 
-                        for (; it != ht_hadle.range_end(); ++it) {
-                                thread_container.push_back((*it).first);
+void multitry_kway_fm::move_start_nodes_to_owners(graph_access& G, PartitionConfig& config) {
+        parallel::numa_graph_layout layout(G, config.num_threads, config.threads_per_socket);
+        std::vector<std::vector<std::vector<NodeID>>> start_nodes(config.num_threads);
+
+        parallel::submit_for_all([this, &layout, &start_nodes](uint32_t thread_id) {
+                auto& thread_start_nodes = start_nodes[thread_id];
+                thread_start_nodes.resize(layout.num_threads());
+                auto& thread_container = m_factory.queue[thread_id];
+                for (NodeID node : thread_container) {
+                        thread_start_nodes[layout.owner(node)].push_back(node);
+                }
+        });
+
+        const bool deterministic = config.deterministic_parallel;
+        parallel::submit_for_all([this, &start_nodes, deterministic](uint32_t thread_id) {
+                auto& thread_container = m_factory.queue[thread_id];
+                thread_container.clear();
+                for (const auto& other_start_nodes : start_nodes) {
+                        for (NodeID node : other_start_nodes[thread_id]) {
+                                thread_container.push_back(node);
                         }
-                        begin = offset.fetch_add(block_size);
                 }
-                if (thread_id == 0) {
-                        CLOCK_END("Time copy from ht");
+                if (deterministic) {
+                        std::sort(thread_container.begin(), thread_container.end());
                 }
-
-                CLOCK_START_N;
-
                 auto& td = m_factory.get_thread_data(thread_id);
                 td.rnd.shuffle(thread_container.begin(), thread_container.end());
-                if (thread_id == 0) {
-                        CLOCK_END("Time shuffle");
-                }
         });
-        CLOCK_END("Copy and shuffle");
-
-        CLOCK_START_N;
-        shuffle_task_queue();
-        CLOCK_END("Additional shuffle");
 }
 
 void  multitry_kway_fm::shuffle_task_queue() {
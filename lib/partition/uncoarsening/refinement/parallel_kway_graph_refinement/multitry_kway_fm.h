@@ -3,6 +3,7 @@
 
 #include "data_structure/parallel/task_queue.h"
 #include "partition/uncoarsening/refinement/parallel_kway_graph_refinement/kway_graph_refinement_commons.h"
+#include "tools/instrumentation.h"
 
 #include <tbb/concurrent_queue.h>
 
@@ -98,18 +99,18 @@ public:
                 return m_thread_data;
         }
 
-        void print_iteration_statistics() {
+        // adds the statistics of this round, including the average times per thread, to m_statistics and
+        // to the instrumentation of the running phase
+        void record_iteration_statistics() {
                 statistics_type stat;
 
-                std::cout << "Time full search\t" << time_setup_start_nodes + time_local_search << " s" << std::endl;
-                std::cout << "Time setup start nodes\t" << time_setup_start_nodes << " s" << std::endl;
-                std::cout << "Time local search\t" << time_local_search << " s" << std::endl;
-
-                std::cout << "Time init\t" << time_init << " s" << std::endl;
-                std::cout << "Time generate moves\t" << time_generate_moves << " s" << std::endl;
-                std::cout << "Time wait\t" << time_wait << " s" << std::endl;
-                std::cout << "Time move nodes\t" << time_move_nodes << " s" << std::endl;
-                std::cout << "Time reactivate vertices\t" << time_reactivate_vertices << " s" << std::endl;
+                INSTRUMENTATION_TIME("setup_start_nodes", time_setup_start_nodes);
+                INSTRUMENTATION_TIME("local_search", time_local_search);
+                INSTRUMENTATION_TIME("init", time_init);
+                INSTRUMENTATION_TIME("generate_moves", time_generate_moves);
+                INSTRUMENTATION_TIME("wait", time_wait);
+                INSTRUMENTATION_TIME("move_nodes", time_move_nodes);
+                INSTRUMENTATION_TIME("reactivate_vertices", time_reactivate_vertices);
 
                 stat.time_setup_start_nodes = time_setup_start_nodes;
                 stat.time_local_search = time_local_search;
@@ -221,25 +222,19 @@ public:
                 stat.total_stop_max_number_of_swaps = total_stop_max_number_of_swaps;
                 stat.total_stop_faction_of_nodes_moved = total_stop_faction_of_nodes_moved;
 
-                std::cout << "Time move nodes (change boundary)\t" << total_time_move_nodes_change_boundary<< " s" << std::endl;
-                std::cout << "Total num part accesses\t" << total_num_part_accesses << std::endl;
-                std::cout << "Total tried moves\t" << total_tried_movements << std::endl;
-                std::cout << "Total accepted moves\t" << total_accepted_movements << std::endl;
-                std::cout << "Total affected moves\t" << total_affected_movements << std::endl;
-                std::cout << "Total scanned neighbours\t" << total_scaned_neighbours << std::endl;
-                std::cout << "Total upperbound gain\t" << total_upper_bound_gain << std::endl;
-                std::cout << "Total performed gain\t" << total_performed_gain << std::endl;
-                std::cout << "Total unperformed gain\t" << total_unperformed_gain << std::endl;
-                std::cout << "Total stop empty queue\t" << total_stop_empty_queue << std::endl;
-                std::cout << "Total stop stopping rule\t" << total_stop_stopping_rule << std::endl;
-                std::cout << "Total stop max number of swaps\t" << total_stop_max_number_of_swaps << std::endl;
-                std::cout << "Total stop faction of nodes moved\t" << total_stop_faction_of_nodes_moved << std::endl;
-
-                std::cout << "Average TIME per thread\t" << total / m_config.num_threads << " s" << std::endl;
-                std::cout << "Average TIME tried moves per thread\t" << total_tried / m_config.num_threads << " s" << std::endl;
-                std::cout << "Average TIME accepted moves per thread\t" << total_accepted / m_config.num_threads << " s" << std::endl;
-                std::cout << "Average TIME unroll per thread\t" << total_unroll / m_config.num_threads << " s" << std::endl;
-                std::cout << "Average TIME compute gain\t" << total_time_compute_gain / m_config.num_threads << " s" << std::endl;
+                INSTRUMENTATION_TIME("move_nodes_change_boundary", total_time_move_nodes_change_boundary);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/part_accesses", total_num_part_accesses);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/tried_moves", total_tried_movements);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/accepted_moves", total_accepted_movements);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/affected_moves", total_affected_movements);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/scanned_neighbours", total_scaned_neighbours);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/upper_bound_gain", total_upper_bound_gain);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/performed_gain", total_performed_gain);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/unperformed_gain", total_unperformed_gain);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/stop_empty_queue", total_stop_empty_queue);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/stop_stopping_rule", total_stop_stopping_rule);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/stop_max_number_of_swaps", total_stop_max_number_of_swaps);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/stop_faction_of_nodes_moved", total_stop_faction_of_nodes_moved);
 
                 stat.avg_thread_time = total / m_config.num_threads;
                 stat.avg_tried = total_tried / m_config.num_threads;
@@ -247,6 +242,12 @@ public:
                 stat.avg_unroll = total_unroll / m_config.num_threads;
                 stat.avg_compute_gain_time = total_time_compute_gain / m_config.num_threads;
 
+                INSTRUMENTATION_TIME("avg_thread_time", stat.avg_thread_time);
+                INSTRUMENTATION_TIME("avg_tried_moves", stat.avg_tried);
+                INSTRUMENTATION_TIME("avg_accepted_moves", stat.avg_accepted);
+                INSTRUMENTATION_TIME("avg_unroll", stat.avg_unroll);
+                INSTRUMENTATION_TIME("avg_compute_gain", stat.avg_compute_gain_time);
+
                 m_statistics.push_back(stat);
         }
 
@@ -329,7 +330,7 @@ public:
         }
 
         virtual ~thread_data_factory() {
-                print_iteration_statistics();
+                record_iteration_statistics();
         }
 
         AtomicWrapper<uint32_t> num_threads_finished;
@@ -534,6 +535,9 @@ private:
         void setup_start_nodes_all(graph_access& G, PartitionConfig& config, parallel::fast_parallel_boundary& boundary);
 
         void setup_start_nodes_all(graph_access& G, PartitionConfig& config, parallel::fast_parallel_boundary_exp& boundary);
+
+        // gives every thread the start nodes of its range of the numa_graph_layout instead of shuffling the queues
+        void move_start_nodes_to_owners(graph_access& G, PartitionConfig& config);
 };
 
 }
\ No newline at end of file
@@ -94,3 +94,29 @@ bool boundary_bfs::boundary_bfs_search(graph_access & G,
 
 }
 
+bool boundary_bfs::shrink_region(graph_access & G, 
+                                 std::vector<NodeID> & reached_nodes,
+                                 NodeID no_start_nodes,
+                                 NodeWeight upper_bound_no_nodes, 
+                                 NodeID & region_size,
+                                 NodeWeight & region_weight) {
+
+        NodeWeight accumulated_weight = 0;
+        for(unsigned int i = 0; i < no_start_nodes; i++) {
+                accumulated_weight += G.getNodeWeight(reached_nodes[i]);
+        }
+
+        region_size = no_start_nodes;
+        if(accumulated_weight >= upper_bound_no_nodes) {
+                region_weight = accumulated_weight;
+                return false;
+        }
+
+        while(region_size < reached_nodes.size() 
+        && accumulated_weight + G.getNodeWeight(reached_nodes[region_size]) <= upper_bound_no_nodes) {
+                accumulated_weight += G.getNodeWeight(reached_nodes[region_size]);
+                region_size++;
+        }
+        region_weight = accumulated_weight;
+        return true;
+}
@@ -38,6 +38,16 @@ class boundary_bfs {
                                          std::vector<NodeID> & reached_nodes,
                                          NodeWeight & stripe_weight, 
                                          bool flow_tiebreaking);
+
+                // shrinks a region found by boundary_bfs_search to the longest prefix of its bfs order that contains
+                // the no_start_nodes start nodes and whose weight does not exceed upper_bound_no_nodes. returns false
+                // if the start nodes are already too heavy.
+                bool shrink_region(graph_access & G, 
+                                   std::vector<NodeID> & reached_nodes,
+                                   NodeID no_start_nodes,
+                                   NodeWeight upper_bound_no_nodes, 
+                                   NodeID & region_size,
+                                   NodeWeight & region_weight);
 };
 
 
@@ -27,7 +27,7 @@
 #include <sstream>
 #include <unordered_map>
 
-#include "algorithms/push_relabel.h"
+#include "algorithms/max_flow_solver.h"
 #include "cut_flow_problem_solver.h"
 #include "most_balanced_minimum_cuts/most_balanced_minimum_cuts.h"
 #include "data_structure/flow_graph.h"
@@ -85,12 +85,14 @@ EdgeWeight cut_flow_problem_solver::convert_ds( const PartitionConfig & config,
                                              std::vector<NodeID> & lhs_boundary_stripe,
                                              std::vector<NodeID> & rhs_boundary_stripe,
                                              std::vector<NodeID> & new_to_old_ids,              
-                                             flow_graph & fG) {
+                                             flow_graph & fG,
+                                             bool add_terminal_edges) {
 
         //building up the graph as in parse.h of hi_pr code
         NodeID idx = 0;
         new_to_old_ids.resize(lhs_boundary_stripe.size() + rhs_boundary_stripe.size());
         std::unordered_map<NodeID, NodeID> old_to_new;
+        old_to_new.reserve(new_to_old_ids.size());
         for( unsigned i = 0; i < lhs_boundary_stripe.size(); i++) {
                 G.setPartitionIndex(lhs_boundary_stripe[i], BOUNDARY_STRIPE_NODE);
                 new_to_old_ids[idx]                = lhs_boundary_stripe[i];
@@ -105,12 +107,13 @@ EdgeWeight cut_flow_problem_solver::convert_ds( const PartitionConfig & config,
         std::vector<NodeID>  outer_lhs_boundary;
         std::vector<NodeID>  outer_rhs_boundary;
 
-        regions_no_edges(G, lhs_boundary_stripe, rhs_boundary_stripe, 
-                         lhs, rhs, outer_lhs_boundary, outer_rhs_boundary);
+        EdgeID no_edges = regions_no_edges(G, lhs_boundary_stripe, rhs_boundary_stripe, 
+                                           lhs, rhs, outer_lhs_boundary, outer_rhs_boundary);
         
         if(outer_lhs_boundary.size() == 0 || outer_rhs_boundary.size() == 0) return false;
         NodeID n = lhs_boundary_stripe.size() + rhs_boundary_stripe.size() + 2; //+source and target
-        fG.start_construction(n);
+        EdgeID no_terminal_edges = add_terminal_edges ? n - 2 : outer_lhs_boundary.size() + outer_rhs_boundary.size();
+        fG.start_construction(n, no_edges + no_terminal_edges);
 
         NodeID source = n-2;
         NodeID sink   = n-1;
@@ -152,6 +155,27 @@ EdgeWeight cut_flow_problem_solver::convert_ds( const PartitionConfig & config,
                 fG.new_edge(sourceID, sink, max_capacity);
         }
 
+        if(add_terminal_edges) {
+                // zero capacity terminal edges for the inner nodes, the incremental variant raises their capacity
+                std::vector<bool> is_outer_boundary(n-2, false);
+                for(unsigned i = 0; i < outer_lhs_boundary.size(); i++) {
+                        is_outer_boundary[outer_lhs_boundary[i]] = true;
+                }
+                for(unsigned i = 0; i < outer_rhs_boundary.size(); i++) {
+                        is_outer_boundary[outer_rhs_boundary[i]] = true;
+                }
+
+                for( NodeID node = 0; node < n-2; node++) {
+                        if(is_outer_boundary[node]) continue;
+                        if(node < lhs_boundary_stripe.size()) {
+                                fG.new_edge(source, node, 0);
+                        } else {
+                                fG.new_edge(node, sink, 0);
+                        }
+                }
+        }
+        fG.finish_construction();
+
         return true;
 }
 
@@ -172,12 +196,95 @@ EdgeWeight cut_flow_problem_solver::get_min_flow_max_cut(const PartitionConfig &
 
         if(!do_sth) return initial_cut;
 
-        push_relabel pr;
+        max_flow_solver solver;
+        NodeID source = fG.number_of_nodes()-2;
+        NodeID sink   = fG.number_of_nodes()-1;
+        std::vector< NodeID > source_set;
+        FlowType flowvalue = solver.solve_max_flow_min_cut(config, fG, source, sink, true, source_set);
+
+        compute_new_rhs_nodes(config, G, fG, new_to_old_ids, source_set, rhs_part_weight, rhs_stripe_weight, new_rhs_nodes);
+        
+        return flowvalue;
+}
+
+EdgeWeight cut_flow_problem_solver::get_min_flow_max_cut_incremental(const PartitionConfig & config, 
+                                                                  graph_access & G, 
+                                                                  PartitionID & lhs, 
+                                                                  PartitionID & rhs, 
+                                                                  std::vector<NodeID> & lhs_boundary_stripe,
+                                                                  std::vector<NodeID> & rhs_boundary_stripe,
+                                                                  NodeID lhs_region_size,
+                                                                  NodeID rhs_region_size,
+                                                                  std::vector<NodeID> & new_to_old_ids,
+                                                                  EdgeWeight & initial_cut,
+                                                                  NodeWeight & rhs_part_weight,
+                                                                  NodeWeight & rhs_stripe_weight,
+                                                                  std::vector<NodeID> & new_rhs_nodes) {
+
+        flow_graph & fG = m_flow_graph;
+        if(!m_has_flow_problem) {
+                m_has_flow_problem      = true;
+                m_flow_problem_solvable = convert_ds(config, G, lhs, rhs, lhs_boundary_stripe, rhs_boundary_stripe, 
+                                                     new_to_old_ids, fG, true);
+                if(m_flow_problem_solvable) {
+                        NodeID source = fG.number_of_nodes()-2;
+                        NodeID sink   = fG.number_of_nodes()-1;
+                        m_terminal_edge.resize(fG.number_of_nodes()-2);
+                        forall_out_edges(fG, e, source) {
+                                m_terminal_edge[fG.getEdgeTarget(source, e)] = e;
+                        } endfor
+                        forall_out_edges(fG, e, sink) {
+                                m_terminal_edge[fG.getEdgeTarget(sink, e)] = fG.getReverseEdge(sink, e);
+                        } endfor
+                }
+        } else {
+                // the stripes were marked by convert_ds in the first call and unmarked by the caller afterwards
+                for( unsigned i = 0; i < lhs_boundary_stripe.size(); i++) {
+                        G.setPartitionIndex(lhs_boundary_stripe[i], BOUNDARY_STRIPE_NODE);
+                }
+                for( unsigned i = 0; i < rhs_boundary_stripe.size(); i++) {
+                        G.setPartitionIndex(rhs_boundary_stripe[i], BOUNDARY_STRIPE_NODE);
+                }
+        }
+
+        if(!m_flow_problem_solvable) return initial_cut;
+
         NodeID source = fG.number_of_nodes()-2;
         NodeID sink   = fG.number_of_nodes()-1;
+
+        // the flow of the previous call stays feasible since capacities only grow
+        FlowType max_capacity = std::numeric_limits<FlowType>::max();
+        for( NodeID node = lhs_region_size; node < lhs_boundary_stripe.size(); node++) {
+                fG.setEdgeCapacity(source, m_terminal_edge[node], max_capacity);
+        }
+        for( NodeID node = lhs_boundary_stripe.size() + rhs_region_size; node < source; node++) {
+                fG.setEdgeCapacity(node, m_terminal_edge[node], max_capacity);
+        }
+
         std::vector< NodeID > source_set;
-        FlowType flowvalue = pr.solve_max_flow_min_cut( fG, source, sink, true, source_set);
+        FlowType flowvalue = m_solver.solve_max_flow_min_cut(fG, source, sink, true, source_set);
+
+        compute_new_rhs_nodes(config, G, fG, new_to_old_ids, source_set, rhs_part_weight, rhs_stripe_weight, new_rhs_nodes);
 
+        return flowvalue;
+}
+
+void cut_flow_problem_solver::reset_incremental_flow_problem() {
+        m_has_flow_problem      = false;
+        m_flow_problem_solvable = false;
+}
+
+void cut_flow_problem_solver::compute_new_rhs_nodes(const PartitionConfig & config, 
+                                                    graph_access & G, 
+                                                    flow_graph & fG,
+                                                    std::vector<NodeID> & new_to_old_ids,
+                                                    std::vector<NodeID> & source_set,
+                                                    NodeWeight & rhs_part_weight,
+                                                    NodeWeight & rhs_stripe_weight,
+                                                    std::vector<NodeID> & new_rhs_nodes) {
+
+        NodeID source = fG.number_of_nodes()-2;
+        NodeID sink   = fG.number_of_nodes()-1;
         std::vector< bool > new_rhs_flag(fG.number_of_nodes(), true);
         for( unsigned int i = 0; i < source_set.size(); i++) {
                 new_rhs_flag[source_set[i]] = false;
@@ -190,43 +297,21 @@ EdgeWeight cut_flow_problem_solver::get_min_flow_max_cut(const PartitionConfig &
                         }
                 } endfor
         } else {
+                most_balanced_minimum_cuts mbmc;
                 graph_access residualGraph;
-                residualGraph.start_construction(fG.number_of_nodes(),fG.number_of_edges());
-
-                forall_nodes(fG, node) {
-                        NodeID node = residualGraph.new_node(); // for each node here create a new node 
+                mbmc.build_residual_graph(fG, residualGraph);
 
+                forall_nodes(residualGraph, node) {
                         if( node < fG.number_of_nodes() -2 ) {
                                 residualGraph.setNodeWeight( node, G.getNodeWeight(new_to_old_ids[node]));
                         }
-
-                        forall_out_edges(fG, e, node) {
-                                NodeID target = fG.getEdgeTarget(node, e);
-                                if( fG.getEdgeCapacity(node, e) > 0 ) {
-                                        if( fG.getEdgeFlow(node, e) < (FlowType) fG.getEdgeCapacity(node, e)) {
-                                                residualGraph.new_edge(node, target);
-                                        } else {
-                                                forall_out_edges(fG, e_bar, target) {
-                                                        NodeID target_prime = fG.getEdgeTarget(target, e_bar);
-                                                        if( target_prime == node && fG.getEdgeFlow(target, e_bar) > 0) {
-                                                                residualGraph.new_edge(node, target);
-                                                        }
-                                                } endfor
-                                        }
-                                }
-                        } endfor
                 } endfor
-                
+
                 residualGraph.setNodeWeight(source, 0);
                 residualGraph.setNodeWeight(sink, 0);
-                residualGraph.finish_construction();
                 NodeWeight average_partition_weight = ceil(config.work_load / config.k);
                 NodeWeight perfect_rhs_stripe_weight = abs((int)average_partition_weight - (int)rhs_part_weight+(int) rhs_stripe_weight);
                 
-                most_balanced_minimum_cuts mbmc;
                 mbmc.compute_good_balanced_min_cut(residualGraph, config, perfect_rhs_stripe_weight, new_rhs_nodes);
         }
-        
-        return flowvalue;
 }
-
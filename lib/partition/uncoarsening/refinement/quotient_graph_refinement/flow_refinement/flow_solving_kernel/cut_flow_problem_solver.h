@@ -23,6 +23,7 @@
 #ifndef CUT_FLOW_PROBLEM_SOLVER_4P49OMM
 #define CUT_FLOW_PROBLEM_SOLVER_4P49OMM
 
+#include "algorithms/boykov_kolmogorov.h"
 #include "partition_config.h"
 #include "data_structure/flow_graph.h"
 
@@ -43,6 +44,28 @@ class cut_flow_problem_solver  {
                                                 NodeWeight & rhs_stripe_weight,
                                                 std::vector<NodeID> & new_rhs_nodes);               
 
+                // incremental variant for a sequence of shrinking regions of the same bipartition. the first call builds
+                // the flow problem of the stripes, every later call has to get the same stripes and new_to_old_ids. only
+                // the first lhs_region_size and rhs_region_size nodes of the stripes stay movable, the remaining ones are
+                // merged into the source or the sink by raising the capacity of their terminal edge. the previous flow
+                // stays feasible and boykov-kolmogorov augments it to a maximum flow instead of starting from scratch.
+                EdgeWeight get_min_flow_max_cut_incremental(const PartitionConfig & config, 
+                                                            graph_access & G, 
+                                                            PartitionID & lhs, 
+                                                            PartitionID & rhs, 
+                                                            std::vector<NodeID> & lhs_boundary_stripe,
+                                                            std::vector<NodeID> & rhs_boundary_stripe,
+                                                            NodeID lhs_region_size,
+                                                            NodeID rhs_region_size,
+                                                            std::vector<NodeID> & new_to_old_ids,
+                                                            EdgeWeight & initial_cut,
+                                                            NodeWeight & rhs_part_weight,
+                                                            NodeWeight & rhs_stripe_weight,
+                                                            std::vector<NodeID> & new_rhs_nodes);               
+
+                // drops the flow problem of the incremental variant, has to be called when the bipartition changed
+                void reset_incremental_flow_problem();
+
                 EdgeID regions_no_edges(graph_access & G,
                                         std::vector<NodeID> & lhs_boundary_stripe,
                                         std::vector<NodeID> & rhs_boundary_stripe,
@@ -60,8 +83,26 @@ class cut_flow_problem_solver  {
                                       std::vector<NodeID> & lhs_boundary_stripe,
                                       std::vector<NodeID> & rhs_boundary_stripe,
                                       std::vector<NodeID> & new_to_old_ids,              
-                                      flow_graph & rG); 
+                                      flow_graph & rG,
+                                      bool add_terminal_edges = false); 
+
+        private:
+                void compute_new_rhs_nodes(const PartitionConfig & config, 
+                                           graph_access & G, 
+                                           flow_graph & fG,
+                                           std::vector<NodeID> & new_to_old_ids,
+                                           std::vector<NodeID> & source_set,
+                                           NodeWeight & rhs_part_weight,
+                                           NodeWeight & rhs_stripe_weight,
+                                           std::vector<NodeID> & new_rhs_nodes);
 
+                // state of the incremental variant
+                flow_graph         m_flow_graph;
+                boykov_kolmogorov  m_solver;
+                bool               m_has_flow_problem = false;
+                bool               m_flow_problem_solvable = false;
+                // edge from the source to a lhs stripe node and from a rhs stripe node to the sink
+                std::vector<EdgeID> m_terminal_edge;
 };
 
 
@@ -86,6 +86,34 @@ void most_balanced_minimum_cuts::compute_good_balanced_min_cut( graph_access & r
         }
 } 
 
+void most_balanced_minimum_cuts::build_residual_graph( flow_graph & fG, graph_access & residualGraph ) {
+        // the reverse edge of an edge from target to node carries the flow that target sends to node
+        std::vector<NodeID> sends_flow_to(fG.number_of_nodes(), UNDEFINED_NODE);
+
+        residualGraph.start_construction(fG.number_of_nodes(), fG.number_of_edges());
+        forall_nodes(fG, node) {
+                residualGraph.new_node();
+
+                forall_out_edges(fG, e, node) {
+                        if( fG.getEdgeCapacity(node, e) == 0 && fG.getEdgeFlow(node, e) < 0 ) {
+                                sends_flow_to[fG.getEdgeTarget(node, e)] = node;
+                        }
+                } endfor
+
+                forall_out_edges(fG, e, node) {
+                        FlowType capacity = fG.getEdgeCapacity(node, e);
+                        if( capacity == 0 ) continue;
+
+                        NodeID target = fG.getEdgeTarget(node, e);
+                        if( fG.getEdgeFlow(node, e) < capacity || sends_flow_to[target] == node ) {
+                                residualGraph.new_edge(node, target);
+                        }
+                } endfor
+        } endfor
+
+        residualGraph.finish_construction();
+}
+
 void most_balanced_minimum_cuts::compute_new_rhs( graph_access & scc_graph, 
                                                   const PartitionConfig & config,
                                                   std::vector< NodeWeight > & comp_weights,
@@ -23,6 +23,7 @@
 #ifndef MOST_BALANCED_MINIMUM_CUTS_SBD5CS
 #define MOST_BALANCED_MINIMUM_CUTS_SBD5CS
 
+#include "data_structure/flow_graph.h"
 #include "data_structure/graph_access.h"
 #include "partition_config.h"
 
@@ -36,6 +37,11 @@ class most_balanced_minimum_cuts {
                                                     NodeWeight & perfect_rhs_weight, 
                                                     std::vector< NodeID > & new_rhs_node ); 
 
+                // residual graph of the flow in fG for compute_good_balanced_min_cut, the node weights are left to the caller.
+                // a node has a residual edge to a neighbor it has an edge with capacity to, if that edge is not saturated or
+                // if the neighbor sends flow back to the node.
+                void build_residual_graph( flow_graph & fG, graph_access & residualGraph );
+
         private:
                 void build_internal_scc_graph( graph_access & residualGraph,  
                                                std::vector<int> & components, 
@@ -86,6 +86,16 @@ EdgeWeight two_way_flow_refinement::iterativ_flow_iteration(PartitionConfig & co
         std::vector<NodeID> lhs_nodes;
         std::vector<NodeID> rhs_nodes;
 
+        // with reuse_flow_on_shrink a rejected region is shrunk to a prefix of its bfs order and the
+        // flow problem of the previous iteration is reused with the cut off nodes merged into the terminals
+        cut_flow_problem_solver fsolve;
+        bool shrink_region = false;
+        std::vector<NodeID> lhs_boundary_stripe;
+        std::vector<NodeID> rhs_boundary_stripe;
+        NodeWeight lhs_stripe_weight = 0;
+        NodeWeight rhs_stripe_weight = 0;
+        std::vector<NodeID> new_to_old_ids;
+
         EdgeWeight cur_improvement = 1;
         EdgeWeight best_cut = cut; 
         bool sumoverweight = lhs_part_weight + rhs_part_weight > 2*config.upper_bound_partition;
@@ -101,40 +111,71 @@ EdgeWeight two_way_flow_refinement::iterativ_flow_iteration(PartitionConfig & co
                 upper_bound_no_lhs = std::min( lhs_part_weight-1, upper_bound_no_lhs);
                 upper_bound_no_rhs = std::min( rhs_part_weight-1, upper_bound_no_rhs);
 
-                std::vector<NodeID> lhs_boundary_stripe;
-                NodeWeight lhs_stripe_weight = 0;
-                if(!bfs_region_searcher.boundary_bfs_search(G, lhs_pq_start_nodes, lhs, 
-                                        upper_bound_no_lhs, lhs_boundary_stripe, 
-                                        lhs_stripe_weight, true)) {
+                NodeID lhs_region_size = 0;
+                NodeID rhs_region_size = 0;
+                if(!shrink_region) {
+                        lhs_boundary_stripe.clear();
+                        lhs_stripe_weight = 0;
+                        if(!bfs_region_searcher.boundary_bfs_search(G, lhs_pq_start_nodes, lhs, 
+                                                upper_bound_no_lhs, lhs_boundary_stripe, 
+                                                lhs_stripe_weight, true)) {
+
+                                EdgeWeight improvement = cut-best_cut;
+                                cut = best_cut;
+                                return improvement;
+                        }
 
-                        EdgeWeight improvement = cut-best_cut;
-                        cut = best_cut;
-                        return improvement;
-                }
 
+                        rhs_boundary_stripe.clear();
+                        rhs_stripe_weight = 0;
+                        if(!bfs_region_searcher.boundary_bfs_search(G, rhs_pq_start_nodes, rhs, 
+                                                upper_bound_no_rhs, rhs_boundary_stripe, 
+                                                rhs_stripe_weight, true)) { 
 
-                std::vector<NodeID> rhs_boundary_stripe;
-                NodeWeight rhs_stripe_weight = 0;
-                if(!bfs_region_searcher.boundary_bfs_search(G, rhs_pq_start_nodes, rhs, 
-                                        upper_bound_no_rhs, rhs_boundary_stripe, 
-                                        rhs_stripe_weight, true)) { 
+                                EdgeWeight improvement = cut-best_cut;
+                                cut = best_cut;
+                                return improvement;
+                        }
 
-                        EdgeWeight improvement = cut-best_cut;
-                        cut = best_cut;
-                        return improvement;
+                        lhs_region_size = lhs_boundary_stripe.size();
+                        rhs_region_size = rhs_boundary_stripe.size();
+                        fsolve.reset_incremental_flow_problem();
+                } else {
+                        // the stripes and their weights stay those of the flow problem, only the region shrinks
+                        NodeWeight lhs_region_weight = 0;
+                        NodeWeight rhs_region_weight = 0;
+                        if(!bfs_region_searcher.shrink_region(G, lhs_boundary_stripe, lhs_pq_start_nodes.size(), 
+                                                upper_bound_no_lhs, lhs_region_size, lhs_region_weight)
+                        || !bfs_region_searcher.shrink_region(G, rhs_boundary_stripe, rhs_pq_start_nodes.size(), 
+                                                upper_bound_no_rhs, rhs_region_size, rhs_region_weight)) {
+
+                                EdgeWeight improvement = cut-best_cut;
+                                cut = best_cut;
+                                return improvement;
+                        }
                 }
 
                 std::vector<NodeID> new_rhs_nodes;
-                std::vector<NodeID> new_to_old_ids;
 
-                cut_flow_problem_solver fsolve;
-                EdgeWeight new_cut = fsolve.get_min_flow_max_cut(config, G, 
-                                                                lhs, rhs, 
-                                                                lhs_boundary_stripe, rhs_boundary_stripe, 
-                                                                new_to_old_ids, best_cut, 
-                                                                rhs_part_weight,
-                                                                rhs_stripe_weight,
-                                                                new_rhs_nodes);
+                EdgeWeight new_cut = 0;
+                if(config.reuse_flow_on_shrink) {
+                        new_cut = fsolve.get_min_flow_max_cut_incremental(config, G, 
+                                                                         lhs, rhs, 
+                                                                         lhs_boundary_stripe, rhs_boundary_stripe, 
+                                                                         lhs_region_size, rhs_region_size,
+                                                                         new_to_old_ids, best_cut, 
+                                                                         rhs_part_weight,
+                                                                         rhs_stripe_weight,
+                                                                         new_rhs_nodes);
+                } else {
+                        new_cut = fsolve.get_min_flow_max_cut(config, G, 
+                                                              lhs, rhs, 
+                                                              lhs_boundary_stripe, rhs_boundary_stripe, 
+                                                              new_to_old_ids, best_cut, 
+                                                              rhs_part_weight,
+                                                              rhs_stripe_weight,
+                                                              new_rhs_nodes);
+                }
 
                 NodeWeight new_lhs_part_weight   = 0;
                 NodeWeight new_rhs_part_weight   = 0;
@@ -194,6 +235,7 @@ EdgeWeight two_way_flow_refinement::iterativ_flow_iteration(PartitionConfig & co
                        
                         cur_improvement = best_cut - new_cut;
                         best_cut        = new_cut;
+                        shrink_region   = false;
 
                         if(2*region_factor < config.flow_region_factor) {
                                 region_factor *= 2; 
@@ -225,6 +267,7 @@ EdgeWeight two_way_flow_refinement::iterativ_flow_iteration(PartitionConfig & co
 
                         //smaller the region_factor
                         region_factor = std::max(region_factor/2,1.0);
+                        shrink_region = config.reuse_flow_on_shrink;
                         if(new_cut == best_cut) {
                                 break; 
                         }
@@ -20,16 +20,23 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
 
+#include <atomic>
+#include <limits>
 #include <unordered_map>
 
 #include "2way_fm_refinement/two_way_fm.h"
+#include "algorithms/max_flow_solver.h"
 #include "complete_boundary.h"
+#include "data_structure/parallel/thread_pool.h"
 #include "data_structure/parallel/time.h"
 #include "flow_refinement/two_way_flow_refinement.h"
 #include "quality_metrics.h"
 #include "quotient_graph_refinement.h"
+#include "random_functions.h"
 #include "quotient_graph_scheduling/active_block_quotient_graph_scheduler.h"
+#include "quotient_graph_scheduling/matching_quotient_graph_scheduler.h"
 #include "quotient_graph_scheduling/simple_quotient_graph_scheduler.h"
+#include "tools/instrumentation.h"
 #include "uncoarsening/refinement/kway_graph_refinement/kway_graph_refinement.h"
 #include "uncoarsening/refinement/kway_graph_refinement/multitry_kway_fm.h"
 #include "uncoarsening/refinement/parallel_kway_graph_refinement/multitry_kway_fm.h"
@@ -66,21 +73,23 @@ void quotient_graph_refinement::setup_start_nodes(graph_access & G,
 }
 
 EdgeWeight quotient_graph_refinement::perform_refinement_all(PartitionConfig& config, graph_access& G, complete_boundary& boundary) {
-        CLOCK_START;
         EdgeWeight overall_improvement = 0;
         if (config.refinement_scheduling_algorithm == REFINEMENT_SCHEDULING_ACTIVE_BLOCKS_REF_KWAY) {
-                std::cout << "START KWAY" << std::endl;
+                SCOPED_TIMER("multitry_kway_fm");
                 auto kway_ref = get_multitry_kway_fm_instance(config, G, boundary);
                 overall_improvement = kway_ref->perform_refinement(config, G, boundary, config.global_multitry_rounds,
                                                                    true, config.kway_adaptive_limits_alpha);
-
-                std::cout << "Cut improvement time\t" << CLOCK_END_TIME << std::endl;
-                std::cout << "Cut improvement\t" << overall_improvement << std::endl;
+                INSTRUMENTATION_COUNT("multitry_kway_fm/improvement", overall_improvement);
         }
         return overall_improvement;
 }
 
 EdgeWeight quotient_graph_refinement::perform_refinement(PartitionConfig & config, graph_access & G, complete_boundary & boundary) {
+        if (config.parallel_pairwise_refinement && config.quotient_graph_two_way_refinement
+            && config.refinement_scheduling_algorithm != REFINEMENT_SCHEDULING_ACTIVE_BLOCKS_REF_KWAY) {
+                return perform_parallel_pairwise_refinement(config, G, boundary);
+        }
+
         EdgeWeight overall_improvement = 0;
         {
                 ASSERT_TRUE(boundary.assert_bnodes_in_boundaries());
@@ -194,10 +203,9 @@ EdgeWeight quotient_graph_refinement::perform_refinement(PartitionConfig & confi
                         ASSERT_TRUE(boundary.getBlockNoNodes(rhs) > 0);
                         //*************************** end ****************************************
                 } while (!scheduler->hasFinished());
-                //std::cout << "Cut improvement time\t" << time << std::endl;
-                //std::cout << "Two way time\t" << time_two_way << std::endl;
-                //total_time_two_way += time_two_way;
-                //std::cout << "Cut improvement\t" << cut_improvement << std::endl;
+                INSTRUMENTATION_TIME("multitry_kway_fm", time);
+                INSTRUMENTATION_TIME("two_way_refinement", time_two_way);
+                INSTRUMENTATION_COUNT("multitry_kway_fm/improvement", cut_improvement);
 
                 delete scheduler;
         }
@@ -205,6 +213,212 @@ EdgeWeight quotient_graph_refinement::perform_refinement(PartitionConfig & confi
         return overall_improvement;
 }
 
+EdgeWeight quotient_graph_refinement::perform_parallel_pairwise_refinement(PartitionConfig & config,
+                                                                           graph_access & G,
+                                                                           complete_boundary & boundary) {
+        ASSERT_TRUE(boundary.assert_bnodes_in_boundaries());
+        ASSERT_TRUE(boundary.assert_boundaries_are_bnodes());
+
+        QuotientGraphEdges qgraph_edges;
+        boundary.getQuotientGraphEdges(qgraph_edges);
+        matching_quotient_graph_scheduler scheduler(config, qgraph_edges);
+
+        // the blocks of a color are pairwise distinct, so every node belongs to the region of at most one pair
+        std::vector<NodeID> local_id(G.number_of_nodes(), UNDEFINED_NODE);
+        EdgeWeight overall_improvement = 0;
+
+        while (!scheduler.hasFinished()) {
+                QuotientGraphEdges & pairs = scheduler.getNextMatching();
+                std::vector<pair_refinement> work(pairs.size());
+                for (unsigned i = 0; i < pairs.size(); i++) {
+                        work[i].seed = random_functions::nextInt(0, std::numeric_limits<int>::max());
+                }
+
+                // G is only read until all pairs are refined
+                std::atomic<size_t> next_pair(0);
+                parallel::submit_for_all([&](uint32_t) {
+                        for (size_t i = next_pair.fetch_add(1); i < pairs.size(); i = next_pair.fetch_add(1)) {
+                                refine_pair(config, G, boundary, pairs[i], work[i], local_id);
+                        }
+                });
+
+                // apply the moves of every pair to G and to the boundaries of all blocks
+                for (unsigned i = 0; i < pairs.size(); i++) {
+                        boundary_pair & pair = pairs[i];
+                        for (NodeID node : work[i].moved_nodes) {
+                                PartitionID to = G.getPartitionIndex(node) == pair.lhs ? pair.rhs : pair.lhs;
+                                G.setPartitionIndex(node, to);
+                                boundary.postMovedBoundaryNodeUpdates(node, &pair, true, true);
+                        }
+                        if (!work[i].moved_nodes.empty()) {
+                                boundary.setBlockWeight(pair.lhs, work[i].block_weight[0]);
+                                boundary.setBlockWeight(pair.rhs, work[i].block_weight[1]);
+                                boundary.setBlockNoNodes(pair.lhs, work[i].block_no_nodes[0]);
+                                boundary.setBlockNoNodes(pair.rhs, work[i].block_no_nodes[1]);
+                        }
+
+                        overall_improvement += work[i].improvement;
+                        qgraph_edge_statistics stat(work[i].improvement, &pair, work[i].something_changed);
+                        scheduler.pushStatistics(stat);
+                }
+
+                ASSERT_TRUE(boundary.assert_bnodes_in_boundaries());
+                ASSERT_TRUE(boundary.assert_boundaries_are_bnodes());
+        }
+
+        return overall_improvement;
+}
+
+void quotient_graph_refinement::refine_pair(PartitionConfig & config,
+                                            graph_access & G,
+                                            complete_boundary & boundary,
+                                            const boundary_pair & pair,
+                                            pair_refinement & work,
+                                            std::vector<NodeID> & local_id) {
+        random_functions::setSeed(work.seed);
+
+        // the region of a block is a bfs from its boundary to the other block, bounded by the weight the
+        // flow region of the block can reach. fm and flows do not touch nodes behind it.
+        const PartitionID block[2] = {pair.lhs, pair.rhs};
+        const NodeWeight block_weight[2] = {boundary.getBlockWeight(pair.lhs), boundary.getBlockWeight(pair.rhs)};
+        NodeWeight average_partition_weight = ceil(config.work_load / config.k);
+        NodeWeight region_weight[2] = {0, 0};
+        NodeID no_nodes = 0;
+        EdgeID no_edges = 0;
+        for (unsigned side = 0; side < 2; side++) {
+                double upper_bound = (100.0 + config.flow_region_factor * config.imbalance) / 100.0 * average_partition_weight
+                                     - block_weight[1 - side];
+                upper_bound = std::max(std::min(upper_bound, block_weight[side] - 1.0), 0.0);
+
+                std::vector<NodeID> & region = work.nodes[side];
+                const PartialBoundary & bnd = boundary.getDirectedBoundaryThreadSafe(block[side], pair.lhs, pair.rhs);
+                for (const auto & bnd_node : bnd.internal_boundary) {
+                        local_id[bnd_node.first] = no_nodes++;
+                        region.push_back(bnd_node.first);
+                        region_weight[side] += G.getNodeWeight(bnd_node.first);
+                }
+
+                for (size_t i = 0; i < region.size() && region_weight[side] < upper_bound; i++) {
+                        forall_out_edges(G, e, region[i]) {
+                                NodeID target = G.getEdgeTarget(e);
+                                // the block is checked first, local ids of other blocks belong to other pairs
+                                if (G.getPartitionIndex(target) == block[side] && local_id[target] == UNDEFINED_NODE
+                                    && region_weight[side] + G.getNodeWeight(target) <= upper_bound) {
+                                        local_id[target] = no_nodes++;
+                                        region.push_back(target);
+                                        region_weight[side] += G.getNodeWeight(target);
+                                }
+                        } endfor
+                }
+
+                for (NodeID node : region) {
+                        no_edges += G.getNodeDegree(node) + 1;
+                }
+        }
+
+        // the rest of a block is one node which carries its weight and the edges into the region, so block
+        // weights and gains are those of G. the boundary of the pair is in the region, hence both rest nodes
+        // are not adjacent to the other block.
+        const NodeID rest[2] = {no_nodes, no_nodes + 1};
+        std::vector<std::pair<NodeID, EdgeWeight>> rest_edges[2];
+
+        graph_access P;
+        P.start_construction(no_nodes + 2, no_edges);
+        for (unsigned side = 0; side < 2; side++) {
+                for (NodeID node : work.nodes[side]) {
+                        NodeID new_node = P.new_node();
+                        P.setNodeWeight(new_node, G.getNodeWeight(node));
+                        P.setPartitionIndex(new_node, side);
+
+                        EdgeWeight rest_weight = 0;
+                        forall_out_edges(G, e, node) {
+                                NodeID target = G.getEdgeTarget(e);
+                                PartitionID target_block = G.getPartitionIndex(target);
+                                if (target_block != pair.lhs && target_block != pair.rhs) {
+                                        continue;
+                                }
+                                if (local_id[target] != UNDEFINED_NODE) {
+                                        EdgeID new_edge = P.new_edge(new_node, local_id[target]);
+                                        P.setEdgeWeight(new_edge, G.getEdgeWeight(e));
+                                } else {
+                                        ASSERT_EQ(target_block, block[side]);
+                                        rest_weight += G.getEdgeWeight(e);
+                                }
+                        } endfor
+
+                        if (rest_weight > 0) {
+                                EdgeID new_edge = P.new_edge(new_node, rest[side]);
+                                P.setEdgeWeight(new_edge, rest_weight);
+                                rest_edges[side].emplace_back(new_node, rest_weight);
+                        }
+                }
+        }
+        for (unsigned side = 0; side < 2; side++) {
+                NodeID new_node = P.new_node();
+                P.setNodeWeight(new_node, block_weight[side] - region_weight[side]);
+                P.setPartitionIndex(new_node, side);
+                for (auto & edge : rest_edges[side]) {
+                        EdgeID new_edge = P.new_edge(new_node, edge.first);
+                        P.setEdgeWeight(new_edge, edge.second);
+                }
+        }
+        P.finish_construction();
+        P.set_partition_count(2);
+
+        for (unsigned side = 0; side < 2; side++) {
+                for (NodeID node : work.nodes[side]) {
+                        local_id[node] = UNDEFINED_NODE;
+                }
+        }
+
+        complete_boundary pair_boundary(&P);
+        pair_boundary.build();
+        // the fm search limits depend on the number of nodes of the blocks
+        for (unsigned side = 0; side < 2; side++) {
+                pair_boundary.setBlockNoNodes(side, boundary.getBlockNoNodes(block[side]));
+        }
+
+        QuotientGraphEdges pair_edges;
+        pair_boundary.getQuotientGraphEdges(pair_edges);
+        if (pair_edges.empty()) {
+                return;
+        }
+
+        boundary_pair & bp = pair_edges[0];
+        PartitionID lhs = bp.lhs;
+        PartitionID rhs = bp.rhs;
+        NodeWeight lhs_part_weight = pair_boundary.getBlockWeight(lhs);
+        NodeWeight rhs_part_weight = pair_boundary.getBlockWeight(rhs);
+        EdgeWeight initial_cut_value = pair_boundary.getEdgeCut(&bp);
+
+        // the pairs of a color already run in the thread pool
+        PartitionConfig cfg = config;
+        cfg.flow_solver = max_flow_solver::sequential_flow_solver(config.flow_solver);
+        work.improvement = perform_a_two_way_refinement(cfg, P, pair_boundary, bp, lhs, rhs,
+                                                        lhs_part_weight, rhs_part_weight,
+                                                        initial_cut_value, work.something_changed);
+
+        // moving a rest node would move the nodes behind the region, the result of the pair is dropped then
+        if (P.getPartitionIndex(rest[0]) != 0 || P.getPartitionIndex(rest[1]) != 1) {
+                work.improvement       = 0;
+                work.something_changed = false;
+                return;
+        }
+
+        const NodeID no_lhs_nodes = work.nodes[0].size();
+        for (NodeID node = 0; node < no_nodes; node++) {
+                PartitionID side = node < no_lhs_nodes ? 0 : 1;
+                if (P.getPartitionIndex(node) != side) {
+                        work.moved_nodes.push_back(side == 0 ? work.nodes[0][node] : work.nodes[1][node - no_lhs_nodes]);
+                }
+        }
+
+        for (PartitionID side = 0; side < 2; side++) {
+                work.block_weight[side]   = pair_boundary.getBlockWeight(side);
+                work.block_no_nodes[side] = pair_boundary.getBlockNoNodes(side);
+        }
+}
+
 EdgeWeight quotient_graph_refinement::perform_a_two_way_refinement(PartitionConfig & config,
                                                                    graph_access & G,
                                                                    complete_boundary & boundary,
@@ -49,6 +49,29 @@ class quotient_graph_refinement : public refinement {
         private:
                 //static double total_time_two_way;
 
+                // a pair of one color of the parallel scheduling. the pair is refined on the region around its
+                // boundary, with a complete_boundary of its own. nodes holds the region of either block.
+                struct pair_refinement {
+                        std::vector<NodeID> nodes[2];
+                        int seed;
+                        EdgeWeight improvement = 0;
+                        bool something_changed = false;
+                        std::vector<NodeID> moved_nodes;
+                        NodeWeight block_weight[2];
+                        NodeID block_no_nodes[2];
+                };
+
+                // refines the pairs of every color of matching_quotient_graph_scheduler concurrently
+                EdgeWeight perform_parallel_pairwise_refinement(PartitionConfig & config, graph_access & G,
+                                                                complete_boundary & boundary);
+
+                void refine_pair(PartitionConfig & config,
+                                 graph_access & G,
+                                 complete_boundary & boundary,
+                                 const boundary_pair & pair,
+                                 pair_refinement & work,
+                                 std::vector<NodeID> & local_id);
+
                 EdgeWeight perform_a_two_way_refinement(PartitionConfig & config, 
                                                         graph_access & G,
                                                         complete_boundary & boundary, 
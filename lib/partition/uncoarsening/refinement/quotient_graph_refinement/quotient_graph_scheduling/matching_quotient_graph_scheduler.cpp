@@ -0,0 +1,14 @@
+#include "matching_quotient_graph_scheduler.h"
+
+matching_quotient_graph_scheduler::matching_quotient_graph_scheduler( const PartitionConfig & config,
+                                                                      QuotientGraphEdges & qgraph_edges) :
+                                                                      m_quotient_graph_edges(qgraph_edges) {
+
+        m_is_block_active.assign(config.k, true);
+        m_no_of_active_blocks = config.k;
+        init();
+}
+
+matching_quotient_graph_scheduler::~matching_quotient_graph_scheduler() {
+
+}
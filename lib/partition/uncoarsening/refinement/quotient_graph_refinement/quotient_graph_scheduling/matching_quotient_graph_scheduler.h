@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vector>
+
+#include "partition_config.h"
+#include "quotient_graph_scheduling.h"
+#include "random_functions.h"
+
+// Schedules the quotient graph edges like active_block_quotient_graph_scheduler, but hands them out as
+// matchings of block pairs. Every round colors the active quotient graph edges greedily such that no two
+// edges of a color share a block. The pairs of a color are independent and can be refined concurrently.
+class matching_quotient_graph_scheduler : public quotient_graph_scheduling {
+        public:
+                matching_quotient_graph_scheduler( const PartitionConfig & config,
+                                                   QuotientGraphEdges & qgraph_edges);
+
+                virtual ~matching_quotient_graph_scheduler();
+
+                virtual bool hasFinished();
+                virtual boundary_pair & getNext();
+                virtual void pushStatistics(qgraph_edge_statistics & statistic);
+
+                // the pairs of the next color, valid until the next call of getNextMatching
+                QuotientGraphEdges & getNextMatching();
+
+        private:
+                void init();
+
+                QuotientGraphEdges &            m_quotient_graph_edges;
+                std::vector<QuotientGraphEdges> m_colors;
+                QuotientGraphEdges              m_current_color;
+                boundary_pair                   m_next_pair;
+                PartitionID                     m_no_of_active_blocks;
+                std::vector<bool>               m_is_block_active;
+};
+
+inline void matching_quotient_graph_scheduler::init() {
+        m_no_of_active_blocks = 0;
+        m_colors.clear();
+
+        QuotientGraphEdges active_edges;
+        for( unsigned int i = 0; i < m_quotient_graph_edges.size(); i++) {
+                PartitionID lhs = m_quotient_graph_edges[i].lhs;
+                PartitionID rhs = m_quotient_graph_edges[i].rhs;
+
+                if(m_is_block_active[lhs]) m_no_of_active_blocks++;
+                if(m_is_block_active[rhs]) m_no_of_active_blocks++;
+
+                if(m_is_block_active[lhs] || m_is_block_active[rhs]) {
+                        active_edges.push_back(m_quotient_graph_edges[i]);
+                }
+        }
+
+        random_functions::permutate_vector_good_small(active_edges);
+
+        // greedy edge coloring, uses at most 2 * max degree - 1 colors
+        std::vector<std::vector<bool>> block_has_color;
+        for( unsigned int i = 0; i < active_edges.size(); i++) {
+                PartitionID lhs = active_edges[i].lhs;
+                PartitionID rhs = active_edges[i].rhs;
+
+                unsigned int color = 0;
+                while(color < m_colors.size() && (block_has_color[color][lhs] || block_has_color[color][rhs])) {
+                        color++;
+                }
+                if(color == m_colors.size()) {
+                        m_colors.emplace_back();
+                        block_has_color.emplace_back(m_is_block_active.size(), false);
+                }
+
+                m_colors[color].push_back(active_edges[i]);
+                block_has_color[color][lhs] = true;
+                block_has_color[color][rhs] = true;
+        }
+
+        for( unsigned int i = 0; i < m_is_block_active.size(); i++) {
+                m_is_block_active[i] = false;
+        }
+}
+
+inline bool matching_quotient_graph_scheduler::hasFinished( ) {
+        if(m_colors.empty()) {
+                init();
+        }
+
+        return m_no_of_active_blocks == 0;
+}
+
+inline QuotientGraphEdges & matching_quotient_graph_scheduler::getNextMatching( ) {
+        m_current_color.swap(m_colors.back());
+        m_colors.pop_back();
+
+        return m_current_color;
+}
+
+inline boundary_pair & matching_quotient_graph_scheduler::getNext( ) {
+        m_next_pair = m_colors.back().back();
+        m_colors.back().pop_back();
+        if(m_colors.back().empty()) {
+                m_colors.pop_back();
+        }
+
+        return m_next_pair;
+}
+
+inline void matching_quotient_graph_scheduler::pushStatistics(qgraph_edge_statistics & statistic) {
+        if(statistic.something_changed) {
+                m_is_block_active[statistic.pair->lhs] = true;
+                m_is_block_active[statistic.pair->rhs] = true;
+        }
+}
@@ -55,7 +55,7 @@ class area_bfs {
 			} else {
 				upper_bound_no_nodes = std::max((int)(config.region_factor_node_separators*config.upper_bound_partition - size_lhs - size_sep), 0);
 			}
-			upper_bound_no_nodes = std::min(upper_bound_no_nodes, block_weights[block]-1);
+			upper_bound_no_nodes = std::min<NodeID>(upper_bound_no_nodes, block_weights[block]-1);
 
 			/***************************
 			 * Do the BFS
@@ -23,7 +23,7 @@
 #include <sstream>
 
 #include "area_bfs.h"
-#include "algorithms/push_relabel.h"
+#include "algorithms/max_flow_solver.h"
 #include "graph_io.h"
 #include "most_balanced_minimum_cuts/most_balanced_minimum_cuts.h"
 #include "tools/random_functions.h"
@@ -123,6 +123,7 @@ void vertex_separator_algorithm::build_flow_problem(const PartitionConfig & conf
 
         // find forward and backward mapping
         std::unordered_map< NodeID, NodeID > backward_mapping;
+        backward_mapping.reserve(n/2);
         forward_mapping.clear();
         forward_mapping.resize(n-2);
 
@@ -146,10 +147,16 @@ void vertex_separator_algorithm::build_flow_problem(const PartitionConfig & conf
         }
 
 
+        // every node of the flow problem has an edge to its copy and at most one edge per neighbor
+        EdgeID no_edges = outer_lhs_boundary_nodes.size() + outer_rhs_boundary_nodes.size();
+        for( NodeID v : lhs_nodes ) no_edges += 1 + G.getNodeDegree(v);
+        for( NodeID v : rhs_nodes ) no_edges += 1 + G.getNodeDegree(v);
+        for( NodeID v : separator_nodes ) no_edges += 1 + G.getNodeDegree(v);
+
         source = n-2;
         sink   = n-1;
         FlowType infinite = std::numeric_limits<FlowType>::max()/2;
-        rG.start_construction(n, 0);
+        rG.start_construction(n, no_edges);
 
         for( NodeID v : outer_lhs_boundary_nodes) {
                 rG.new_edge(source, backward_mapping[v], infinite);
@@ -284,9 +291,9 @@ NodeWeight vertex_separator_algorithm::improve_vertex_separator_internal(const P
         std::vector< NodeID > forward_mapping; // maps a node from rG to original G
         build_flow_problem(config, G, lhs_nodes, rhs_nodes, start_nodes, rG, forward_mapping, source, sink);
 
-	push_relabel mfmc_solver; std::vector<NodeID> source_set;
+	max_flow_solver mfmc_solver; std::vector<NodeID> source_set;
         bool compute_source_set = !config.most_balanced_minimum_cuts_node_sep;
-	FlowType value =  mfmc_solver.solve_max_flow_min_cut(rG, source, sink, compute_source_set, source_set);
+	FlowType value =  mfmc_solver.solve_max_flow_min_cut(config, rG, source, sink, compute_source_set, source_set);
 
         std::vector< bool > is_in_source_set( rG.number_of_nodes());
         bool start_value = config.most_balanced_minimum_cuts_node_sep;
@@ -441,9 +448,9 @@ NodeWeight vertex_separator_algorithm::improve_vertex_separator_internal(const P
         std::vector< NodeID > forward_mapping; // maps a node from rG to original G
         build_flow_problem(config, G, lhs_nodes, rhs_nodes, input_separator, rG, forward_mapping, source, sink);
 
-	push_relabel mfmc_solver; std::vector<NodeID> source_set;
+	max_flow_solver mfmc_solver; std::vector<NodeID> source_set;
         bool compute_source_set = !config.most_balanced_minimum_cuts_node_sep;
-	FlowType value =  mfmc_solver.solve_max_flow_min_cut(rG, source, sink, compute_source_set, source_set);
+	FlowType value =  mfmc_solver.solve_max_flow_min_cut(config, rG, source, sink, compute_source_set, source_set);
 
         std::vector< bool > is_in_source_set( rG.number_of_nodes());
         bool start_value = config.most_balanced_minimum_cuts_node_sep;
@@ -25,7 +25,7 @@
 #include <math.h>
 #include <unordered_map>
 
-#include "algorithms/push_relabel.h"
+#include "algorithms/max_flow_solver.h"
 #include "data_structure/flow_graph.h"
 #include "vertex_separator_flow_solver.h"
 
@@ -49,12 +49,12 @@ void vertex_separator_flow_solver::find_separator(const PartitionConfig & config
         std::vector<NodeID> new_to_old_ids; flow_graph fG;
         build_flow_pb(config, G, lhs, rhs, lhs_nodes, rhs_nodes, new_to_old_ids, fG);
 
-        push_relabel pr;
+        max_flow_solver solver;
         NodeID source = fG.number_of_nodes() - 2;
         NodeID sink   = fG.number_of_nodes() - 1;
 
         std::vector<NodeID> S;
-        pr.solve_max_flow_min_cut( fG, source, sink, true, S);
+        solver.solve_max_flow_min_cut(config, fG, source, sink, true, S);
 
         std::sort(lhs_nodes.begin(), lhs_nodes.end());
         std::sort(rhs_nodes.begin(), rhs_nodes.end());
@@ -105,6 +105,7 @@ bool vertex_separator_flow_solver::build_flow_pb( const PartitionConfig & config
         NodeID idx = 0;
         new_to_old_ids.resize(lhs_nodes.size() + rhs_nodes.size());
         std::unordered_map<NodeID, NodeID> old_to_new;
+        old_to_new.reserve(new_to_old_ids.size());
         for( unsigned i = 0; i < lhs_nodes.size(); i++) {
                 new_to_old_ids[idx] = lhs_nodes[i];
                 old_to_new[lhs_nodes[i]] = idx++ ;
@@ -123,7 +124,7 @@ bool vertex_separator_flow_solver::build_flow_pb( const PartitionConfig & config
         idx = 0;
         FlowType max_capacity = std::numeric_limits<FlowType>::max();
 
-        fG.start_construction(n);
+        fG.start_construction(n, no_edges + lhs_nodes.size() + rhs_nodes.size());
         //insert directed edges from L to R
         for( unsigned i = 0; i < lhs_nodes.size(); i++, idx++) {
                 NodeID node = lhs_nodes[i];
@@ -138,14 +139,15 @@ bool vertex_separator_flow_solver::build_flow_pb( const PartitionConfig & config
 
         //connect source and target with outer boundary nodes 
         for(unsigned i = 0; i < lhs_nodes.size(); i++) {
-                NodeID targetID = old_to_new[lhs_nodes[i]];
+                NodeID targetID = i;
                 fG.new_edge(source, targetID, G.getNodeWeight(lhs_nodes[i]));
         }
 
         for(unsigned i = 0; i < rhs_nodes.size(); i++) {
-                NodeID sourceID = old_to_new[rhs_nodes[i]];
+                NodeID sourceID = lhs_nodes.size() + i;
                 fG.new_edge(sourceID, sink, G.getNodeWeight(rhs_nodes[i]));
         }
+        fG.finish_construction();
 
         return true;
 }
@@ -20,7 +20,6 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
 
-#include "data_structure/parallel/time.h"
 #include "graph_partition_assertions.h"
 #include "misc.h"
 #include "quality_metrics.h"
@@ -28,9 +27,11 @@
 #include "refinement/node_separators/greedy_ns_local_search.h"
 #include "refinement/node_separators/fm_ns_local_search.h"
 #include "refinement/node_separators/localized_fm_ns_local_search.h"
+#include "refinement/node_separators/parallel_localized_fm_ns_local_search.h"
 #include "refinement/label_propagation_refinement/label_propagation_refinement.h"
 #include "refinement/refinement.h"
 #include "separator/vertex_separator_algorithm.h"
+#include "tools/instrumentation.h"
 #include "tools/random_functions.h"
 #include "uncoarsening.h"
 #include "parallel_uncoarsening.h"
@@ -99,30 +100,33 @@ int uncoarsening::perform_uncoarsening_cut(const PartitionConfig & config, graph
 //                }
 //        }
 
-        CLOCK_START;
         complete_boundary* finer_boundary   = NULL;
         complete_boundary* coarser_boundary = NULL;
         if(!config.label_propagation_refinement) {
+                SCOPED_TIMER("build_boundary");
                 coarser_boundary = new complete_boundary(coarsest);
                 coarser_boundary->build();
         }
-        CLOCK_END(">> Build boundary");
 
         double factor = config.balance_factor;
         cfg.upper_bound_partition = ((!hierarchy.isEmpty()) * factor +1.0)*config.upper_bound_partition;
-        CLOCK_START_N;
-        improvement += (int)refine->perform_refinement(cfg, *coarsest, *coarser_boundary);
-        CLOCK_END(">> Refinement");
+        {
+                SCOPED_TIMER("refinement");
+                improvement += (int)refine->perform_refinement(cfg, *coarsest, *coarser_boundary);
+        }
 
         NodeID coarser_no_nodes = coarsest->number_of_nodes();
         graph_access* finest    = NULL;
-        graph_access* to_delete = NULL;
+        // the coarsest graph goes first once its partition is projected, the hierarchy frees the levels in stack order
+        graph_access* to_delete = coarsest;
         unsigned int hierarchy_deepth = hierarchy.size();
 
         while(!hierarchy.isEmpty()) {
-                CLOCK_START;
-                graph_access* G = hierarchy.pop_finer_and_project();
-                CLOCK_END("Projection");
+                graph_access* G = NULL;
+                {
+                        SCOPED_TIMER("projection");
+                        G = hierarchy.pop_finer_and_project();
+                }
 
                 PRINT(std::cout << "log>" << "unrolling graph with " << G->number_of_nodes()<<  std::endl;)
 
@@ -150,10 +154,12 @@ int uncoarsening::perform_uncoarsening_cut(const PartitionConfig & config, graph
 //                        }
 //                }
 
-                CLOCK_START_N;
-                finer_boundary = new complete_boundary(G);
-                finer_boundary->build_from_coarser(coarser_boundary, coarser_no_nodes,
-                                                   hierarchy.get_mapping_of_current_finer());
+                {
+                        SCOPED_TIMER("build_boundary");
+                        finer_boundary = new complete_boundary(G);
+                        finer_boundary->build_from_coarser(coarser_boundary, coarser_no_nodes,
+                                                           hierarchy.get_mapping_of_current_finer());
+                }
 //                if(!config.label_propagation_refinement) {
 //                        if (!config.lp_before_local_search) {
 //                                finer_boundary = new complete_boundary(G);
@@ -164,15 +170,15 @@ int uncoarsening::perform_uncoarsening_cut(const PartitionConfig & config, graph
 //                                finer_boundary->build_from_coarser(coarser_boundary, boundary);
 //                        }
 //                }
-                CLOCK_END(">> Build boundary");
 
                 //call refinement
                 double cur_factor = factor/(hierarchy_deepth-hierarchy.size());
                 cfg.upper_bound_partition = ((!hierarchy.isEmpty()) * cur_factor+1.0)*config.upper_bound_partition;
                 PRINT(std::cout <<  "cfg upperbound " <<  cfg.upper_bound_partition  << std::endl;)
-                CLOCK_START_N;
-                improvement += (int)refine->perform_refinement(cfg, *G, *finer_boundary);
-                CLOCK_END(">> Refinement");
+                {
+                        SCOPED_TIMER("refinement");
+                        improvement += (int)refine->perform_refinement(cfg, *G, *finer_boundary);
+                }
                 ASSERT_TRUE(graph_partition_assertions::assert_graph_has_kway_partition(config, *G));
 
                 if(config.use_balance_singletons && !config.label_propagation_refinement) {
@@ -203,7 +209,6 @@ int uncoarsening::perform_uncoarsening_cut(const PartitionConfig & config, graph
 
         delete refine;
         if(finer_boundary != NULL) delete finer_boundary;
-	delete coarsest;
 
         return improvement;
 }
@@ -245,12 +250,27 @@ int uncoarsening::perform_uncoarsening_nodeseparator(const PartitionConfig & con
                 }
         }
 
-        graph_access* to_delete = NULL;
+        // the coarsest graph goes first once its partition is projected, the hierarchy frees the levels in stack order
+        graph_access* to_delete = coarsest;
         while(!hierarchy.isEmpty()) {
                 graph_access* G = hierarchy.pop_finer_and_project();
                 std::cout << "log>" << "unrolling graph with " << G->number_of_nodes() << std::endl;
 
-                if( !config.sep_fm_disabled) {
+                if( config.parallel_node_separator ) {
+                        // localized searches on disjoint regions replace the global and the localized fm searches
+                        parallel_localized_fm_ns_local_search pfmnsls;
+                        for( int i = 0; i < config.sep_num_loc_fm_reps; i++) {
+                                NodeWeight improvement = 0;
+                                improvement += pfmnsls.perform_refinement(config, (*G));
+
+                                int rnd_block = random_functions::nextInt(0,1);
+                                improvement += pfmnsls.perform_refinement(config, (*G), true, rnd_block);
+                                improvement += pfmnsls.perform_refinement(config, (*G), true, rnd_block == 0 ? 1 : 0);
+                                if( improvement == 0 ) break;
+                        }
+                }
+
+                if( !config.sep_fm_disabled && !config.parallel_node_separator) {
                         for( int i = 0; i < config.sep_num_fm_reps; i++) {
                                 fm_ns_local_search fmnsls;
                                 fmnsls.perform_refinement(config, (*G));
@@ -261,7 +281,7 @@ int uncoarsening::perform_uncoarsening_nodeseparator(const PartitionConfig & con
                         }
                 }
 
-                if( !config.sep_loc_fm_disabled) {
+                if( !config.sep_loc_fm_disabled && !config.parallel_node_separator) {
                         for( int i = 0; i < config.sep_num_loc_fm_reps; i++) {
                                 localized_fm_ns_local_search fmnsls;
                                 fmnsls.perform_refinement(config, (*G));
@@ -296,7 +316,6 @@ int uncoarsening::perform_uncoarsening_nodeseparator(const PartitionConfig & con
 			to_delete = G;
 		}
         }
-	delete coarsest;
 
         return 0;
 }
@@ -340,13 +359,28 @@ int uncoarsening::perform_uncoarsening_nodeseparator_fast(const PartitionConfig
                 }
         }
 
-        graph_access* to_delete = NULL;
+        // the coarsest graph goes first once its partition is projected, the hierarchy frees the levels in stack order
+        graph_access* to_delete = coarsest;
         while(!hierarchy.isEmpty()) {
                 graph_access* G = hierarchy.pop_finer_and_project_ns(current_separator);
                 std::cout << "log>" << "unrolling graph with " << G->number_of_nodes() << std::endl;
 
+                if( config.parallel_node_separator ) {
+                        // localized searches on disjoint regions replace the global and the localized fm searches
+                        parallel_localized_fm_ns_local_search pfmnsls;
+                        for( int i = 0; i < config.sep_num_loc_fm_reps; i++) {
+                                NodeWeight improvement = 0;
+                                improvement += pfmnsls.perform_refinement(config, (*G), block_weights, current_separator);
+
+                                int rnd_block = random_functions::nextInt(0,1);
+                                improvement += pfmnsls.perform_refinement(config, (*G), block_weights, current_separator, true, rnd_block);
+                                improvement += pfmnsls.perform_refinement(config, (*G), block_weights, current_separator, true, rnd_block == 0 ? 1 : 0);
+                                if( improvement == 0 ) break;
+                        }
+                }
+
                 std::vector< bool > moved_out_of_S(G->number_of_nodes(), false);
-                if( !config.sep_fm_disabled) {
+                if( !config.sep_fm_disabled && !config.parallel_node_separator) {
                         for( int i = 0; i < config.sep_num_fm_reps; i++) {
                                 
                                 fm_ns_local_search fmnsls;
@@ -360,7 +394,7 @@ int uncoarsening::perform_uncoarsening_nodeseparator_fast(const PartitionConfig
                         }
                 }
 
-                if( !config.sep_loc_fm_disabled) {
+                if( !config.sep_loc_fm_disabled && !config.parallel_node_separator) {
                         for( int i = 0; i < config.sep_num_loc_fm_reps; i++) {
                                 localized_fm_ns_local_search fmnsls;
                                 NodeWeight improvement = 0;
@@ -387,7 +421,6 @@ int uncoarsening::perform_uncoarsening_nodeseparator_fast(const PartitionConfig
 			to_delete = G;
 		}
         }
-	delete coarsest;
 
         return 0;
 }
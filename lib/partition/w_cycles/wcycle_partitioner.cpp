@@ -32,11 +32,11 @@
 #include "initial_partitioning/initial_partitioning.h"
 #include "misc.h"
 #include "random_functions.h"
+#include "tools/instrumentation.h"
 #include "uncoarsening/refinement/mixed_refinement.h"
 #include "uncoarsening/refinement/label_propagation_refinement/label_propagation_refinement.h"
 #include "uncoarsening/refinement/refinement.h"
 #include "wcycle_partitioner.h"
-#include "data_structure/parallel/time.h"
 
 int wcycle_partitioner::perform_partitioning(const PartitionConfig & config, graph_access & G) {
         PartitionConfig  cfg = config; 
@@ -81,33 +81,34 @@ int wcycle_partitioner::perform_partitioning_recursive( PartitionConfig & partit
         Matching edge_matching;
         NodePermutationMap permutation;
 
-        CLOCK_START;
         coarsening_configurator coarsening_config;
         coarsening_config.configure_coarsening(partition_config, &edge_matcher, m_level);
 
-        auto b = CLOCK;
-        rating.rate(*finer, m_level);
-        std::cout << "Contraction: edge rating\t" << std::chrono::duration<double>(CLOCK - b).count() << std::endl;
+        {
+                SCOPED_TIMER("rate");
+                rating.rate(*finer, m_level);
+        }
 
-        b = CLOCK;
-        edge_matcher->match(partition_config, *finer, edge_matching, *coarse_mapping, no_of_coarser_vertices, permutation);
-        std::cout << "Contraction: matching\t" << std::chrono::duration<double>(CLOCK - b).count() << std::endl;
+        {
+                SCOPED_TIMER("match");
+                edge_matcher->match(partition_config, *finer, edge_matching, *coarse_mapping, no_of_coarser_vertices, permutation);
+        }
         delete edge_matcher; 
 
-        b = CLOCK;
-        if(partition_config.graph_allready_partitioned) {
-                contracter->contract_partitioned(partition_config, *finer, 
-                                                 *coarser, edge_matching, 
-                                                 *coarse_mapping, no_of_coarser_vertices, 
-                                                 permutation);
-        } else {
-                contracter->contract(partition_config, *finer, 
-                                     *coarser, edge_matching, 
-                                     *coarse_mapping, no_of_coarser_vertices, 
-                                     permutation);
+        {
+                SCOPED_TIMER("contract");
+                if(partition_config.graph_allready_partitioned) {
+                        contracter->contract_partitioned(partition_config, *finer, 
+                                                         *coarser, edge_matching, 
+                                                         *coarse_mapping, no_of_coarser_vertices, 
+                                                         permutation);
+                } else {
+                        contracter->contract(partition_config, *finer, 
+                                             *coarser, edge_matching, 
+                                             *coarse_mapping, no_of_coarser_vertices, 
+                                             permutation);
+                }
         }
-        std::cout << "Contraction: contraction\t" << std::chrono::duration<double>(CLOCK - b).count() << std::endl;
-        CLOCK_END("Contraction");
 
         coarser->set_partition_count(partition_config.k);
         complete_boundary* coarser_boundary =  NULL;
@@ -129,10 +130,11 @@ int wcycle_partitioner::perform_partitioning_recursive( PartitionConfig & partit
                 double factor = partition_config.balance_factor;
                 cfg.upper_bound_partition = (factor +1.0)*partition_config.upper_bound_partition;
 
-                CLOCK_START;
-	        initial_partitioning init_part;
-		init_part.perform_initial_partitioning(cfg, *coarser);
-                CLOCK_END("Initial partitioning");
+                {
+                        SCOPED_TIMER("initial_partitioning");
+                        initial_partitioning init_part;
+                        init_part.perform_initial_partitioning(cfg, *coarser);
+                }
 
                 if(!partition_config.label_propagation_refinement) coarser_boundary->build();
 
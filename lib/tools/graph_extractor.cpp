@@ -20,8 +20,13 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include "graph_extractor.h"
+#include "data_structure/parallel/algorithm.h"
+#include "data_structure/parallel/graph_builder.h"
 
 
 graph_extractor::graph_extractor() {
@@ -139,6 +144,108 @@ void graph_extractor::extract_two_blocks(graph_access & G,
         extracted_block_rhs.finish_construction();
 }
 
+void graph_extractor::extract_all_blocks_parallel(graph_access & G,
+                                                  std::vector<graph_access*> & extracted_blocks,
+                                                  std::vector<std::vector<NodeID>> & mappings,
+                                                  std::vector<NodeWeight> & block_weights) {
+        const PartitionID k          = extracted_blocks.size();
+        const NodeID num_nodes       = G.number_of_nodes();
+        const size_t num_threads     = parallel::g_thread_pool.NumThreads() + 1;
+        const size_t num_ranges      = std::max<size_t>(1, std::min<size_t>(8 * num_threads, num_nodes / 1000));
+        const NodeID range_size      = num_nodes / num_ranges + (num_nodes % num_ranges != 0);
+
+        // counts of range r and block b are stored at r * k + b and become offsets after the prefix sum
+        std::vector<NodeID> node_offsets(num_ranges * k, 0);
+        std::vector<NodeWeight> range_weights(num_ranges * k, 0);
+
+        auto for_all_ranges = [&](auto&& range_task) {
+                std::atomic<size_t> next_range(0);
+                parallel::submit_for_all([&](uint32_t) {
+                        size_t r = next_range.fetch_add(1, std::memory_order_relaxed);
+                        while (r < num_ranges) {
+                                NodeID begin = std::min<NodeID>(r * range_size, num_nodes);
+                                NodeID end   = std::min<NodeID>(begin + range_size, num_nodes);
+                                range_task(r, begin, end);
+                                r = next_range.fetch_add(1, std::memory_order_relaxed);
+                        }
+                });
+        };
+
+        // first pass: count nodes and weight of every block per range
+        for_all_ranges([&](size_t r, NodeID begin, NodeID end) {
+                for (NodeID node = begin; node != end; ++node) {
+                        PartitionID block = G.getPartitionIndex(node);
+                        node_offsets[r * k + block]++;
+                        range_weights[r * k + block] += G.getNodeWeight(node);
+                }
+        });
+
+        // the table is small, so the prefix sums over the ranges are computed sequentially
+        std::vector<NodeID> block_sizes(k, 0);
+        block_weights.assign(k, 0);
+        for (size_t r = 0; r < num_ranges; ++r) {
+                for (PartitionID block = 0; block < k; ++block) {
+                        size_t idx = r * k + block;
+                        NodeID cur_nodes = node_offsets[idx];
+                        node_offsets[idx]      = block_sizes[block];
+                        block_sizes[block]    += cur_nodes;
+                        block_weights[block]  += range_weights[idx];
+                }
+        }
+
+        std::vector<std::unique_ptr<parallel::graph_builder>> builders(k);
+        mappings.resize(k);
+        for (PartitionID block = 0; block < k; ++block) {
+                builders[block] = std::make_unique<parallel::graph_builder>(*extracted_blocks[block], block_sizes[block], num_threads);
+                mappings[block].resize(block_sizes[block]);
+        }
+
+        // second pass: assign the new node ids and count the internal edges
+        std::vector<NodeID> new_id(num_nodes);
+        for_all_ranges([&](size_t r, NodeID begin, NodeID end) {
+                NodeID* next_id = &node_offsets[r * k];
+                for (NodeID node = begin; node != end; ++node) {
+                        PartitionID block = G.getPartitionIndex(node);
+                        NodeID id = next_id[block]++;
+                        new_id[node] = id;
+                        mappings[block][id] = node;
+
+                        EdgeID degree = 0;
+                        forall_out_edges(G, e, node) {
+                                degree += G.getPartitionIndex(G.getEdgeTarget(e)) == block;
+                        } endfor
+                        builders[block]->set_degree(id, degree);
+                        builders[block]->set_node_weight(id, G.getNodeWeight(node));
+                }
+        });
+
+        std::vector<parallel::graph_builder*> all_builders(k);
+        for (PartitionID block = 0; block < k; ++block) {
+                all_builders[block] = builders[block].get();
+        }
+        parallel::graph_builder::compute_offsets(all_builders, num_threads);
+
+        // third pass: write the internal edges of every node
+        for_all_ranges([&](size_t r, NodeID begin, NodeID end) {
+                for (NodeID node = begin; node != end; ++node) {
+                        PartitionID block = G.getPartitionIndex(node);
+                        parallel::graph_builder& builder = *builders[block];
+                        EdgeID new_edge = builder.first_edge(new_id[node]);
+
+                        forall_out_edges(G, e, node) {
+                                NodeID target = G.getEdgeTarget(e);
+                                if (G.getPartitionIndex(target) == block) {
+                                        builder.set_edge(new_edge++, new_id[target], G.getEdgeWeight(e));
+                                }
+                        } endfor
+                }
+        });
+
+        for (PartitionID block = 0; block < k; ++block) {
+                builders[block]->finish();
+        }
+}
+
 // Method takes a number of nodes and extracts the underlying subgraph from G
 // it also assignes block informations
 void graph_extractor::extract_two_blocks_connected(graph_access & G, 
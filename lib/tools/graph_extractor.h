@@ -44,6 +44,13 @@ class graph_extractor {
                                         NodeWeight & partition_weight_lhs,
                                         NodeWeight & partition_weight_rhs); 
 
+                // extracts the subgraphs of all blocks 0, ..., extracted_blocks.size()-1 of G in parallel,
+                // the nodes of each subgraph keep their relative order in G
+                void extract_all_blocks_parallel(graph_access & G,
+                                                 std::vector<graph_access*> & extracted_blocks,
+                                                 std::vector<std::vector<NodeID>> & mappings,
+                                                 std::vector<NodeWeight> & block_weights);
+
                void extract_two_blocks_connected(graph_access & G, 
                                                  std::vector<NodeID> lhs_nodes,
                                                  std::vector<NodeID> rhs_nodes,
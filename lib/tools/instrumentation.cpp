@@ -0,0 +1,326 @@
+#include "tools/instrumentation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace instrumentation {
+
+namespace {
+
+struct timer_entry {
+        std::string path;
+        int level;
+        uint64_t calls;
+        uint32_t threads;
+        double time;
+        double max_thread_time;
+};
+
+struct counter_entry {
+        std::string name;
+        int level;
+        uint32_t threads;
+        int64_t value;
+};
+
+#ifndef NO_INSTRUMENTATION
+
+// node of the timer tree of one thread, the same name on another level is another node
+struct timer_node {
+        timer_node(uint32_t _name, int _level, uint32_t _parent)
+                :       name(_name)
+                ,       level(_level)
+                ,       parent(_parent)
+        {}
+
+        uint32_t name;
+        int level;
+        uint32_t parent;
+        uint64_t calls = 0;
+        double time = 0.0;
+        std::vector<uint32_t> children;
+        // context of tasks submitted while this timer runs, see current_context
+        context_handle context;
+};
+
+struct thread_log {
+        thread_log() {
+                nodes.emplace_back(0, no_level, 0);
+        }
+
+        // nodes[0] is the root and is never timed
+        std::vector<timer_node> nodes;
+        uint32_t current = 0;
+        int level = no_level;
+        // name in the upper, level in the lower 32 bits
+        std::unordered_map<uint64_t, int64_t> counters;
+};
+
+struct registry {
+        std::mutex mutex;
+        std::vector<std::string> names;
+        std::unordered_map<std::string, uint32_t> name_ids;
+        // logs stay alive after their threads finished
+        std::vector<std::unique_ptr<thread_log>> logs;
+        // logs of finished threads, a new thread records into one of them instead of a new log
+        std::vector<thread_log*> free_logs;
+};
+
+registry& get_registry() {
+        static registry reg;
+        return reg;
+}
+
+// the log of the calling thread, it is handed back to the registry when the thread finishes
+struct log_owner {
+        thread_log* log = nullptr;
+
+        ~log_owner() {
+                if (log != nullptr) {
+                        registry& reg = get_registry();
+                        std::lock_guard<std::mutex> guard(reg.mutex);
+                        log->current = 0;
+                        log->level = no_level;
+                        reg.free_logs.push_back(log);
+                }
+        }
+};
+
+thread_local log_owner local_log;
+
+thread_log& local() {
+        if (local_log.log == nullptr) {
+                registry& reg = get_registry();
+                std::lock_guard<std::mutex> guard(reg.mutex);
+                if (reg.free_logs.empty()) {
+                        reg.logs.emplace_back(new thread_log());
+                        local_log.log = reg.logs.back().get();
+                } else {
+                        local_log.log = reg.free_logs.back();
+                        reg.free_logs.pop_back();
+                }
+        }
+        return *local_log.log;
+}
+
+inline int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+void collect(std::vector<timer_entry>& timers, std::vector<counter_entry>& counters) {
+        registry& reg = get_registry();
+        std::lock_guard<std::mutex> guard(reg.mutex);
+
+        // timers are listed in the order in which they appear first
+        std::unordered_map<std::string, size_t> timer_index;
+        for (const auto& log : reg.logs) {
+                std::vector<std::pair<uint32_t, std::string>> stack;
+                for (auto it = log->nodes[0].children.rbegin(); it != log->nodes[0].children.rend(); ++it) {
+                        stack.emplace_back(*it, "");
+                }
+                while (!stack.empty()) {
+                        uint32_t id = stack.back().first;
+                        const timer_node& node = log->nodes[id];
+                        std::string path = stack.back().second + reg.names[node.name];
+                        stack.pop_back();
+
+                        // nodes which only lead to the timers of a task were not timed by this thread
+                        if (node.calls > 0) {
+                                std::string key = path + '\0' + std::to_string(node.level);
+                                auto found = timer_index.find(key);
+                                if (found == timer_index.end()) {
+                                        timer_index.emplace(key, timers.size());
+                                        timers.push_back({path, node.level, node.calls, 1, node.time, node.time});
+                                } else {
+                                        timer_entry& entry = timers[found->second];
+                                        entry.calls += node.calls;
+                                        entry.threads++;
+                                        entry.time += node.time;
+                                        entry.max_thread_time = std::max(entry.max_thread_time, node.time);
+                                }
+                        }
+
+                        for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+                                stack.emplace_back(*it, path + "/");
+                        }
+                }
+        }
+
+        std::unordered_map<uint64_t, size_t> counter_index;
+        for (const auto& log : reg.logs) {
+                for (const auto& counter : log->counters) {
+                        auto found = counter_index.find(counter.first);
+                        if (found == counter_index.end()) {
+                                counter_index.emplace(counter.first, counters.size());
+                                counters.push_back({reg.names[counter.first >> 32], (int) (uint32_t) counter.first,
+                                                    1, counter.second});
+                        } else {
+                                counters[found->second].threads++;
+                                counters[found->second].value += counter.second;
+                        }
+                }
+        }
+        std::sort(counters.begin(), counters.end(), [](const counter_entry& lhs, const counter_entry& rhs) {
+                return std::tie(lhs.name, lhs.level) < std::tie(rhs.name, rhs.level);
+        });
+}
+
+#else
+
+void collect(std::vector<timer_entry>&, std::vector<counter_entry>&) {}
+
+#endif
+
+}
+
+#ifndef NO_INSTRUMENTATION
+
+uint32_t intern(const char* name) {
+        registry& reg = get_registry();
+        std::lock_guard<std::mutex> guard(reg.mutex);
+        auto found = reg.name_ids.find(name);
+        if (found != reg.name_ids.end()) {
+                return found->second;
+        }
+        uint32_t id = reg.names.size();
+        reg.names.emplace_back(name);
+        reg.name_ids.emplace(name, id);
+        return id;
+}
+
+void start_timer(uint32_t name) {
+        thread_log& log = local();
+        for (uint32_t child : log.nodes[log.current].children) {
+                if (log.nodes[child].name == name && log.nodes[child].level == log.level) {
+                        log.current = child;
+                        return;
+                }
+        }
+        uint32_t child = log.nodes.size();
+        log.nodes.emplace_back(name, log.level, log.current);
+        log.nodes[log.current].children.push_back(child);
+        log.current = child;
+}
+
+void stop_timer(double seconds) {
+        thread_log& log = local();
+        timer_node& node = log.nodes[log.current];
+        node.calls++;
+        node.time += seconds;
+        log.current = node.parent;
+}
+
+void count(uint32_t name, int64_t value) {
+        thread_log& log = local();
+        log.counters[((uint64_t) name << 32) | (uint32_t) log.level] += value;
+}
+
+context_handle current_context() {
+        thread_log& log = local();
+        // the timers above a node never change, only the level has to be checked
+        context_handle& cached = log.nodes[log.current].context;
+        if (cached == nullptr || cached->level != log.level) {
+                auto context = std::make_shared<task_context>();
+                context->level = log.level;
+                for (uint32_t id = log.current; id != 0; id = log.nodes[id].parent) {
+                        context->timers.emplace_back(log.nodes[id].name, log.nodes[id].level);
+                }
+                std::reverse(context->timers.begin(), context->timers.end());
+                cached = std::move(context);
+        }
+        return cached;
+}
+
+scoped_context::scoped_context(const context_handle& context) {
+        thread_log& log = local();
+        m_previous = log.current;
+        m_previous_level = log.level;
+
+        log.current = 0;
+        for (const auto& timer : context->timers) {
+                log.level = timer.second;
+                start_timer(timer.first);
+        }
+        log.level = context->level;
+}
+
+scoped_context::~scoped_context() {
+        thread_log& log = local();
+        log.current = m_previous;
+        log.level = m_previous_level;
+}
+
+void add_time(uint32_t name, double seconds) {
+        start_timer(name);
+        stop_timer(seconds);
+}
+
+int set_level(int level) {
+        thread_log& log = local();
+        int previous = log.level;
+        log.level = level;
+        return previous;
+}
+
+scoped_timer::scoped_timer(uint32_t name) {
+        start_timer(name);
+        m_begin = now();
+}
+
+scoped_timer::~scoped_timer() {
+        stop_timer((now() - m_begin) / 1e9);
+}
+
+#endif
+
+void write_json(std::ostream& out) {
+        std::vector<timer_entry> timers;
+        std::vector<counter_entry> counters;
+        collect(timers, counters);
+
+        out << "{\n";
+        out << "  \"timers\": [";
+        for (size_t i = 0; i < timers.size(); ++i) {
+                const timer_entry& t = timers[i];
+                out << (i == 0 ? "\n" : ",\n");
+                out << "    {\"path\": \"" << t.path << "\", \"level\": " << t.level
+                    << ", \"calls\": " << t.calls << ", \"threads\": " << t.threads
+                    << ", \"time\": " << t.time << ", \"max_thread_time\": " << t.max_thread_time << "}";
+        }
+        out << (timers.empty() ? "],\n" : "\n  ],\n");
+
+        out << "  \"counters\": [";
+        for (size_t i = 0; i < counters.size(); ++i) {
+                const counter_entry& c = counters[i];
+                out << (i == 0 ? "\n" : ",\n");
+                out << "    {\"name\": \"" << c.name << "\", \"level\": " << c.level
+                    << ", \"threads\": " << c.threads << ", \"value\": " << c.value << "}";
+        }
+        out << (counters.empty() ? "]\n" : "\n  ]\n");
+        out << "}" << std::endl;
+}
+
+void write_csv(std::ostream& out) {
+        std::vector<timer_entry> timers;
+        std::vector<counter_entry> counters;
+        collect(timers, counters);
+
+        out << "kind,name,level,calls,threads,time,max_thread_time,value\n";
+        for (const timer_entry& t : timers) {
+                out << "timer," << t.path << "," << t.level << "," << t.calls << "," << t.threads << ","
+                    << t.time << "," << t.max_thread_time << ",\n";
+        }
+        for (const counter_entry& c : counters) {
+                out << "counter," << c.name << "," << c.level << ",," << c.threads << ",,," << c.value << "\n";
+        }
+        out.flush();
+}
+
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+// Hierarchical timers and per thread counters for the phases of the partitioner.
+//
+//   SCOPED_TIMER("coarsening");               times the enclosing scope, nested timers form a path
+//                                             like "partitioning/coarsening/contract"
+//   SCOPED_LEVEL(level);                      timers and counters of the enclosing scope belong to
+//                                             this level of the hierarchy
+//   INSTRUMENTATION_COUNT("lp/moves", moves); adds moves to a counter of the calling thread
+//   INSTRUMENTATION_TIME("wait", seconds);    adds a time measured elsewhere as a child of the
+//                                             running timer
+//
+// Names have to be string literals, they are looked up once per call site. Every thread records into
+// its own log without synchronization. A finished thread hands its log to the next new thread, so
+// resizing the thread pool does not add logs and "threads" in the reports counts logs.
+// The thread pools capture the context of the submitting thread, a task records its timers below the
+// timers which ran on that thread when the task was submitted. write_json and write_csv merge the
+// logs of all threads and must not run concurrently with recording. Building with -DNO_INSTRUMENTATION
+// removes the recording, the macros then only evaluate their level, value and time arguments, the thread
+// pools do not capture contexts and the writers print empty reports.
+namespace instrumentation {
+
+// level of timers and counters outside of any SCOPED_LEVEL
+constexpr int no_level = -1;
+
+#ifndef NO_INSTRUMENTATION
+
+// running timers and level of a thread, from the outermost to the innermost timer
+struct task_context {
+        std::vector<std::pair<uint32_t, int>> timers;
+        int level = no_level;
+};
+
+// the context of a scope is built once and shared by all tasks submitted from that scope
+using context_handle = std::shared_ptr<const task_context>;
+
+context_handle current_context();
+
+// continues the timers of context on the calling thread until the end of the scope
+class scoped_context {
+public:
+        explicit scoped_context(const context_handle& context);
+        ~scoped_context();
+
+        scoped_context(const scoped_context&) = delete;
+        scoped_context& operator=(const scoped_context&) = delete;
+
+private:
+        uint32_t m_previous;
+        int m_previous_level;
+};
+
+uint32_t intern(const char* name);
+
+void start_timer(uint32_t name);
+
+void stop_timer(double seconds);
+
+void count(uint32_t name, int64_t value);
+
+void add_time(uint32_t name, double seconds);
+
+int set_level(int level);
+
+class scoped_timer {
+public:
+        explicit scoped_timer(uint32_t name);
+        ~scoped_timer();
+
+        scoped_timer(const scoped_timer&) = delete;
+        scoped_timer& operator=(const scoped_timer&) = delete;
+
+private:
+        int64_t m_begin;
+};
+
+class scoped_level {
+public:
+        explicit scoped_level(int level)
+                :       m_previous(set_level(level))
+        {}
+
+        ~scoped_level() {
+                set_level(m_previous);
+        }
+
+        scoped_level(const scoped_level&) = delete;
+        scoped_level& operator=(const scoped_level&) = delete;
+
+private:
+        const int m_previous;
+};
+
+#define INSTRUMENTATION_CONCAT_IMPL(a, b) a##b
+#define INSTRUMENTATION_CONCAT(a, b) INSTRUMENTATION_CONCAT_IMPL(a, b)
+
+#define SCOPED_TIMER(name) \
+static const uint32_t INSTRUMENTATION_CONCAT(__timer_name_, __LINE__) = instrumentation::intern(name); \
+instrumentation::scoped_timer INSTRUMENTATION_CONCAT(__timer_, __LINE__)(INSTRUMENTATION_CONCAT(__timer_name_, __LINE__))
+
+#define SCOPED_LEVEL(level) \
+instrumentation::scoped_level INSTRUMENTATION_CONCAT(__level_, __LINE__)(level)
+
+#define INSTRUMENTATION_COUNT(name, value) \
+do { \
+        static const uint32_t __counter_name = instrumentation::intern(name); \
+        instrumentation::count(__counter_name, value); \
+} while (false)
+
+#define INSTRUMENTATION_TIME(name, seconds) \
+do { \
+        static const uint32_t __time_name = instrumentation::intern(name); \
+        instrumentation::add_time(__time_name, seconds); \
+} while (false)
+
+#else
+
+#define SCOPED_TIMER(name)
+#define SCOPED_LEVEL(level) (void) (level)
+#define INSTRUMENTATION_COUNT(name, value) do { (void) (value); } while (false)
+#define INSTRUMENTATION_TIME(name, seconds) do { (void) (seconds); } while (false)
+
+#endif
+
+// one object with the arrays "timers" and "counters", times are in seconds
+void write_json(std::ostream& out);
+
+// one line per timer or counter: kind,name,level,calls,threads,time,max_thread_time,value
+void write_csv(std::ostream& out);
+
+}
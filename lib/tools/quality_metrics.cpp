@@ -24,8 +24,11 @@
 #include <cmath>
 
 #include "quality_metrics.h"
+#include "data_structure/parallel/thread_pool.h"
 #include "data_structure/union_find.h"
 
+#include <atomic>
+#include <limits>
 #include <unordered_map>
 #include <numeric>
 
@@ -336,3 +339,111 @@ EdgeWeight quality_metrics::objective(const PartitionConfig & config, graph_acce
                 return edge_cut(G, partition_map);
         }
 }
+
+quality_report quality_metrics::report(graph_access & G) {
+        struct thread_metrics {
+                EdgeWeight cut            = 0;
+                NodeID     boundary_nodes = 0;
+                std::vector<NodeWeight> block_weight;
+                std::vector<EdgeWeight> block_degree;
+                std::vector<EdgeWeight> block_volume;
+        };
+
+        const PartitionID k         = G.get_partition_count();
+        const NodeID num_nodes      = G.number_of_nodes();
+        const NodeID chunk_size     = 4096;
+        std::vector<thread_metrics> metrics(parallel::g_thread_pool.NumThreads() + 1);
+        std::atomic<NodeID> next_chunk(0);
+
+        parallel::submit_for_all([&](uint32_t thread_id) {
+                EdgeWeight cut            = 0;
+                NodeID     boundary_nodes = 0;
+                std::vector<NodeWeight> block_weight(k, 0);
+                std::vector<EdgeWeight> block_degree(k, 0);
+                std::vector<EdgeWeight> block_volume(k, 0);
+                // last node that counted a block as incident, saves clearing a k-sized array per node
+                std::vector<NodeID> last_incident(k, std::numeric_limits<NodeID>::max());
+
+                NodeID begin;
+                while ((begin = next_chunk.fetch_add(chunk_size, std::memory_order_relaxed)) < num_nodes) {
+                        NodeID end = std::min(begin + chunk_size, num_nodes);
+                        for (NodeID node = begin; node < end; ++node) {
+                                PartitionID block = G.getPartitionIndex(node);
+                                block_weight[block] += G.getNodeWeight(node);
+                                block_degree[block] += G.getNodeDegree(node);
+
+                                EdgeWeight incident_blocks = 0;
+                                forall_out_edges(G, e, node) {
+                                        PartitionID target_block = G.getPartitionIndex(G.getEdgeTarget(e));
+                                        if (target_block != block) {
+                                                cut += G.getEdgeWeight(e);
+                                                if (last_incident[target_block] != node) {
+                                                        last_incident[target_block] = node;
+                                                        ++incident_blocks;
+                                                }
+                                        }
+                                } endfor
+
+                                if (incident_blocks > 0) {
+                                        ++boundary_nodes;
+                                        block_volume[block] += incident_blocks;
+                                }
+                        }
+                }
+
+                thread_metrics& local = metrics[thread_id];
+                local.cut            = cut;
+                local.boundary_nodes = boundary_nodes;
+                local.block_weight   = std::move(block_weight);
+                local.block_degree   = std::move(block_degree);
+                local.block_volume   = std::move(block_volume);
+        });
+
+        quality_report result;
+        result.k               = k;
+        result.number_of_nodes = num_nodes;
+        result.number_of_edges = G.number_of_edges();
+
+        std::vector<NodeWeight> block_weight(k, 0);
+        std::vector<EdgeWeight> block_degree(k, 0);
+        std::vector<EdgeWeight> block_volume(k, 0);
+        for (const thread_metrics& local : metrics) {
+                result.edge_cut       += local.cut;
+                result.boundary_nodes += local.boundary_nodes;
+                for (PartitionID block = 0; block < k; ++block) {
+                        block_weight[block] += local.block_weight[block];
+                        block_degree[block] += local.block_degree[block];
+                        block_volume[block] += local.block_volume[block];
+                }
+        }
+        result.edge_cut /= 2;
+
+        if (k > 0) {
+                double total_weight = std::accumulate(block_weight.begin(), block_weight.end(), 0.0);
+                double total_degree = std::accumulate(block_degree.begin(), block_degree.end(), 0.0);
+                result.max_block_weight  = *std::max_element(block_weight.begin(), block_weight.end());
+                result.balance           = result.max_block_weight / ceil(total_weight / k);
+                result.balance_edges     = *std::max_element(block_degree.begin(), block_degree.end())
+                                           / ceil(total_degree / k);
+                result.max_comm_volume   = *std::max_element(block_volume.begin(), block_volume.end());
+                result.min_comm_volume   = *std::min_element(block_volume.begin(), block_volume.end());
+                result.total_comm_volume = std::accumulate(block_volume.begin(), block_volume.end(), EdgeWeight(0));
+        }
+        return result;
+}
+
+void quality_report::write_json(std::ostream & out) const {
+        out << "{\n";
+        out << "  \"k\": "                 << k                 << ",\n";
+        out << "  \"number_of_nodes\": "   << number_of_nodes   << ",\n";
+        out << "  \"number_of_edges\": "   << number_of_edges   << ",\n";
+        out << "  \"edge_cut\": "          << edge_cut          << ",\n";
+        out << "  \"boundary_nodes\": "    << boundary_nodes    << ",\n";
+        out << "  \"max_block_weight\": "  << max_block_weight  << ",\n";
+        out << "  \"balance\": "           << balance           << ",\n";
+        out << "  \"balance_edges\": "     << balance_edges     << ",\n";
+        out << "  \"max_comm_volume\": "   << max_comm_volume   << ",\n";
+        out << "  \"min_comm_volume\": "   << min_comm_volume   << ",\n";
+        out << "  \"total_comm_volume\": " << total_comm_volume << "\n";
+        out << "}" << std::endl;
+}
@@ -24,9 +24,28 @@
 #ifndef QUALITY_METRICS_10HC2I5M
 #define QUALITY_METRICS_10HC2I5M
 
+#include <ostream>
+
 #include "data_structure/graph_access.h"
 #include "partition_config.h"
 
+// all metrics of a partition, computed by quality_metrics::report in a single pass
+struct quality_report {
+        PartitionID k                = 0;
+        NodeID     number_of_nodes   = 0;
+        EdgeID     number_of_edges   = 0;
+        EdgeWeight edge_cut          = 0;
+        NodeID     boundary_nodes    = 0;
+        NodeWeight max_block_weight  = 0;
+        double     balance           = 0;
+        double     balance_edges     = 0;
+        EdgeWeight max_comm_volume   = 0;
+        EdgeWeight min_comm_volume   = 0;
+        EdgeWeight total_comm_volume = 0;
+
+        void write_json(std::ostream & out) const;
+};
+
 class quality_metrics {
 public:
         quality_metrics();
@@ -46,6 +65,10 @@ public:
         double balance(graph_access & G);
         double balance_edges(graph_access & G);
         double balance_separator(graph_access & G);
+
+        // computes edge cut, boundary nodes, balance and communication volumes with one traversal
+        // of the graph using the threads of parallel::g_thread_pool
+        quality_report report(graph_access & G);
 };
 
 #endif /* end of include guard: QUALITY_METRICS_10HC2I5M */
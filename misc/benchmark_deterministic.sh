@@ -0,0 +1,62 @@
+#!/bin/bash
+# compares running time and cut of kaffpa with and without --deterministic_parallel and checks
+# whether repeated runs give the same partition. needs GNU time (/usr/bin/time) and md5sum.
+#
+# usage: misc/benchmark_deterministic.sh kaffpa_binary preconfiguration k num_threads repetitions graph [graph ...]
+# run from the root of the repository, e.g.
+#   misc/benchmark_deterministic.sh ./optimized/kaffpa fastsocial_parallel 16 8 5 examples/rgg_n_2_15_s0.graph
+
+if [ "$#" -lt 6 ]; then
+        echo "usage: $0 kaffpa_binary preconfiguration k num_threads repetitions graph [graph ...]"
+        exit 1
+fi
+
+kaffpa=$1
+preconfiguration=$2
+k=$3
+num_threads=$4
+repetitions=$5
+shift 5
+
+tmp_dir=$(mktemp -d)
+
+printf "%-30s %-14s %10s %10s %10s %10s %10s\n" graph mode avg_time_s min_cut max_cut distinct identical
+for graph in "$@"; do
+        for mode in default deterministic; do
+                flags=""
+                if [ "$mode" = "deterministic" ]; then
+                        flags="--deterministic_parallel"
+                fi
+
+                total_time=0
+                cuts=""
+                rm -f $tmp_dir/hashes
+                for rep in $(seq 1 $repetitions); do
+                        log=$tmp_dir/log
+                        partition=$tmp_dir/partition
+                        /usr/bin/time -f "%e" -o $tmp_dir/time \
+                                $kaffpa $graph --k=$k --num_threads=$num_threads --preconfiguration=$preconfiguration \
+                                --output_filename=$partition $flags > $log
+                        if [ "$?" -ne "0" ]; then
+                                echo "kaffpa failed on $graph in mode $mode. exiting."
+                                rm -rf $tmp_dir
+                                exit 1
+                        fi
+                        total_time=$(awk -v a=$total_time -v b=$(cat $tmp_dir/time) 'BEGIN { print a + b }')
+                        cuts="$cuts $(grep -m 1 "^cut" $log | awk '{print $2}')"
+                        md5sum < $partition >> $tmp_dir/hashes
+                done
+
+                avg_time=$(awk -v t=$total_time -v r=$repetitions 'BEGIN { printf "%.3f", t / r }')
+                min_cut=$(echo $cuts | tr ' ' '\n' | sort -n | head -n 1)
+                max_cut=$(echo $cuts | tr ' ' '\n' | sort -n | tail -n 1)
+                distinct=$(sort -u $tmp_dir/hashes | wc -l)
+                identical=no
+                if [ "$distinct" -eq "1" ]; then
+                        identical=yes
+                fi
+                printf "%-30s %-14s %10s %10s %10s %10s %10s\n" $(basename $graph) $mode $avg_time $min_cut $max_cut $distinct $identical
+        done
+done
+
+rm -rf $tmp_dir
@@ -0,0 +1,42 @@
+#!/bin/bash
+# compares running time and peak memory of kaffpa built with 32 and 64 bit node ids.
+# needs scons and GNU time (/usr/bin/time).
+#
+# usage: misc/benchmark_node_id_width.sh k num_threads graph [graph ...]
+# run from the root of the repository, e.g.
+#   misc/benchmark_node_id_width.sh 16 8 examples/rgg_n_2_15_s0.graph examples/delaunay_n15.graph
+
+if [ "$#" -lt 3 ]; then
+        echo "usage: $0 k num_threads graph [graph ...]"
+        exit 1
+fi
+
+k=$1
+num_threads=$2
+shift 2
+
+bin_dir=$(mktemp -d)
+for width in 32 64; do
+        rm -rf ./optimized
+        scons program=kaffpa variant=optimized node_id_width=$width -j 4
+        if [ "$?" -ne "0" ]; then
+                echo "compile error with node_id_width=$width. exiting."
+                exit 1
+        fi
+        cp ./optimized/kaffpa $bin_dir/kaffpa_$width
+done
+rm -rf ./optimized
+
+printf "%-40s %6s %12s %14s %10s\n" graph width time_s max_rss_kb cut
+for graph in "$@"; do
+        for width in 32 64; do
+                log=$bin_dir/log_$width
+                /usr/bin/time -f "%e %M" -o $bin_dir/time_$width \
+                        $bin_dir/kaffpa_$width $graph --k=$k --num_threads=$num_threads --preconfiguration=fast > $log
+                read elapsed max_rss < $bin_dir/time_$width
+                cut=$(grep -m 1 "^cut" $log | awk '{print $2}')
+                printf "%-40s %6s %12s %14s %10s\n" $(basename $graph) $width $elapsed $max_rss $cut
+        done
+done
+
+rm -rf $bin_dir
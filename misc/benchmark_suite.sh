@@ -0,0 +1,108 @@
+#!/bin/bash
+# runs kaffpa on every combination of graph, preconfiguration, k and number of threads and writes
+# one csv line per run with the wall time, the time of every phase (from --instrumentation), the cut
+# and the balance (from --metrics_json). a summary with the mean values and the speedup over one
+# thread is printed at the end, the speedup is empty if 1 is not among the thread counts.
+#
+# usage: misc/benchmark_suite.sh [-b kaffpa_binary] [-c "preconfigurations"] [-k "ks"] [-t "threads"]
+#                                [-r repetitions] [-o results.csv] graph [graph ...]
+# run from the root of the repository, e.g.
+#   misc/generate_benchmark_graphs.sh benchmark_graphs 18
+#   misc/benchmark_suite.sh -k "2 16" -t "1 2 4 8" -o results.csv benchmark_graphs/*.graph
+
+kaffpa=./optimized/kaffpa
+preconfigurations="fastsocial_parallel fastmultitry_parallel"
+ks="2 16 64"
+thread_counts="1 2 4 8"
+repetitions=3
+output=benchmark_results.csv
+
+while getopts "b:c:k:t:r:o:" opt; do
+        case $opt in
+                b) kaffpa=$OPTARG ;;
+                c) preconfigurations=$OPTARG ;;
+                k) ks=$OPTARG ;;
+                t) thread_counts=$OPTARG ;;
+                r) repetitions=$OPTARG ;;
+                o) output=$OPTARG ;;
+                *) exit 1 ;;
+        esac
+done
+shift $((OPTIND - 1))
+
+if [ "$#" -lt 1 ]; then
+        echo "usage: $0 [-b kaffpa_binary] [-c \"preconfigurations\"] [-k \"ks\"] [-t \"threads\"] [-r repetitions] [-o results.csv] graph [graph ...]"
+        exit 1
+fi
+
+if [ ! -x $kaffpa ]; then
+        scons program=kaffpa variant=optimized -j 4
+        if [ "$?" -ne "0" ]; then
+                echo "compile error. exiting."
+                exit 1
+        fi
+fi
+
+tmp_dir=$(mktemp -d)
+
+# time of a top level phase of the main thread in the instrumentation csv, 0 if the phase did not run.
+# Partitioning runs inside of pool tasks are recorded below longer paths, max_thread_time is the time
+# of the main thread.
+phase_time() {
+        awk -F, -v path="partitioning/$1" '$1 == "timer" && $2 == path && $3 == -1 { time = $7 } END { print time + 0 }' $tmp_dir/instrumentation.csv
+}
+
+# value of a number in the metrics json
+metric() {
+        grep "\"$1\"" $tmp_dir/metrics.json | sed 's/.*: *\([^,]*\),*/\1/'
+}
+
+echo "graph,preconfiguration,k,threads,repetition,time,coarsening,initial_partitioning,uncoarsening,cut,balance" > $output
+for graph in "$@"; do
+        for preconfiguration in $preconfigurations; do
+                for k in $ks; do
+                        for threads in $thread_counts; do
+                                for repetition in $(seq 1 $repetitions); do
+                                        begin=$(date +%s%N)
+                                        $kaffpa $graph --k=$k --num_threads=$threads --preconfiguration=$preconfiguration \
+                                                --seed=$repetition --instrumentation=$tmp_dir/instrumentation.csv \
+                                                --metrics_json=$tmp_dir/metrics.json > $tmp_dir/log
+                                        if [ "$?" -ne "0" ]; then
+                                                echo "kaffpa failed on $graph with $preconfiguration, k=$k, $threads threads. exiting."
+                                                rm -rf $tmp_dir
+                                                exit 1
+                                        fi
+                                        end=$(date +%s%N)
+                                        time=$(awk -v b=$begin -v e=$end 'BEGIN { printf "%.3f", (e - b) / 1e9 }')
+                                        echo "$(basename $graph),$preconfiguration,$k,$threads,$repetition,$time,$(phase_time coarsening),$(phase_time initial_partitioning),$(phase_time uncoarsening),$(metric edge_cut),$(metric balance)" >> $output
+                                done
+                        done
+                done
+        done
+done
+
+rm -rf $tmp_dir
+
+# mean per graph, preconfiguration, k and threads in the order of the runs
+awk -F, 'NR > 1 {
+        key = $1 "," $2 "," $3
+        run = key "," $4
+        if (!(run in runs)) { order[++num_runs] = run; run_key[run] = key; run_threads[run] = $4 }
+        runs[run]++
+        time[run] += $6; coarsening[run] += $7; ip[run] += $8; uncoarsening[run] += $9
+        cut[run] += $10; balance[run] += $11
+        if ($4 == 1) { sequential[key] += $6; sequential_runs[key]++ }
+}
+END {
+        printf "%-30s %-24s %6s %8s %10s %10s %10s %10s %10s %8s %8s\n", "graph", "preconfiguration", "k", "threads", "time", "coarsen", "ip", "uncoarsen", "cut", "balance", "speedup"
+        for (i = 1; i <= num_runs; ++i) {
+                run = order[i]
+                n = runs[run]
+                split(run, fields, ",")
+                speedup = ""
+                if (run_key[run] in sequential) {
+                        speedup = sprintf("%.2f", (sequential[run_key[run]] / sequential_runs[run_key[run]]) / (time[run] / n))
+                }
+                printf "%-30s %-24s %6s %8s %10.3f %10.3f %10.3f %10.3f %10.1f %8.4f %8s\n", fields[1], fields[2], fields[3], fields[4], time[run] / n, coarsening[run] / n, ip[run] / n, uncoarsening[run] / n, cut[run] / n, balance[run] / n, speedup
+        }
+}' $output
@@ -0,0 +1,30 @@
+#!/bin/bash
+# generates the synthetic graphs of the benchmark suite (rgg, delaunay and rmat with 2^log_n nodes)
+# with app/graph_generator. needs scons.
+#
+# usage: misc/generate_benchmark_graphs.sh output_dir log_n [log_n ...]
+# run from the root of the repository, e.g.
+#   misc/generate_benchmark_graphs.sh benchmark_graphs 16 18 20
+
+if [ "$#" -lt 2 ]; then
+        echo "usage: $0 output_dir log_n [log_n ...]"
+        exit 1
+fi
+
+output_dir=$1
+shift 1
+
+if [ ! -x ./optimized/graph_generator ]; then
+        scons program=graph_generator variant=optimized -j 4
+        if [ "$?" -ne "0" ]; then
+                echo "compile error. exiting."
+                exit 1
+        fi
+fi
+
+mkdir -p $output_dir
+for log_n in "$@"; do
+        ./optimized/graph_generator rgg $log_n $output_dir/rgg_n_2_${log_n}_s0.graph 0 || exit 1
+        ./optimized/graph_generator delaunay $log_n $output_dir/delaunay_n${log_n}.graph 0 || exit 1
+        ./optimized/graph_generator rmat $log_n $output_dir/rmat_n${log_n}.graph 0 8 || exit 1
+done